@@ -27,4 +27,18 @@ namespace ExternalToolsConfigKeys
     const char* const ffprobePath = "tool_path::ffprobe";
 }
 
+
+namespace PhotosAnalyzerConfigKeys
+{
+    const char* const maxHashingTasks = "photos_analyzer::max_hashing_tasks";   // limit of files being hashed at the same time
+}
+
+
+namespace FaceRecognitionConfigKeys
+{
+    const char* const maxDetectionTasks = "face_recognition::max_detection_tasks";  // limit of photos searched for faces at the same time
+    const char* const detectionMegapixels = "face_recognition::detection_megapixels"; // size of scaled down photo used for finding face candidates.
+                                                                                     // 0 - disable multi-scale detection
+}
+
 #endif
@@ -10,7 +10,8 @@ find_package(Qt6Test REQUIRED)
 addTestTarget(core
                 SOURCES
                     implementation/base_tags.cpp
-                    #implementation/oriented_image.cpp
+                    implementation/jpeg_exif_parser.cpp
+                    implementation/oriented_image.cpp
                     implementation/model_compositor.cpp
                     implementation/qmodelindex_selector.cpp
                     implementation/qmodelindex_comparator.cpp
@@ -22,12 +23,16 @@ addTestTarget(core
 
                     unit_tests/containers_utils_tests.cpp
                     unit_tests/function_wrappers_tests.cpp
+                    unit_tests/jpeg_exif_parser_tests.cpp
                     unit_tests/lazy_ptr_tests.cpp
+                    unit_tests/lock_free_queue_tests.cpp
                     unit_tests/model_compositor_tests.cpp
-                    #unit_tests/oriented_image_tests.cpp
+                    unit_tests/objects_pool_tests.cpp
+                    unit_tests/oriented_image_tests.cpp
                     unit_tests/qmodelindex_comparator_tests.cpp
                     unit_tests/qmodelindex_selector_tests.cpp
                     unit_tests/status_tests.cpp
+                    unit_tests/task_executor_utils_tests.cpp
                     unit_tests/tag_name_info_tests.cpp
                     unit_tests/tag_value_tests.cpp
                     unit_tests/thumbnails_manager_tests.cpp
@@ -3,8 +3,6 @@
 #define TAG_FEEDER_FACTORY
 
 #include <memory>
-#include <map>
-#include <thread>
 
 #include "iexif_reader.hpp"
 
@@ -19,11 +17,12 @@ class CORE_EXPORT ExifReaderFactory: public IExifReaderFactory
 
         ExifReaderFactory& operator=(const ExifReaderFactory &) = delete;
 
-        // ITagFeederFactory:
+        // IExifReaderFactory:
         IExifReader& get() override;
+        ReaderLease checkout() override;
 
     private:
-        std::map<std::thread::id, std::unique_ptr<IExifReader>> m_feeders;
+        std::shared_ptr<ObjectsPool<IExifReader>> m_readers;
 };
 
 #endif
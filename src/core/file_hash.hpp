@@ -0,0 +1,39 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILE_HASH_HPP
+#define FILE_HASH_HPP
+
+#include <optional>
+
+#include <QByteArray>
+#include <QString>
+
+#include "core_export.h"
+
+
+namespace FileHash
+{
+    // Calculate sha256 of file's content.
+    // File is read sequentially with large buffers and dropped from page cache afterwards
+    // (so hashing huge collections does not evict everything else).
+    // Returns raw (binary) digest or std::nullopt when file could not be read.
+    std::optional<QByteArray> CORE_EXPORT sha256(const QString& path);
+}
+
+#endif
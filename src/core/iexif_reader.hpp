@@ -7,6 +7,9 @@
 #include <optional>
 #include <string>
 
+#include <QSize>
+
+#include "objects_pool.hpp"
 #include "tag.hpp"
 
 #include "core_export.h"
@@ -34,14 +37,18 @@ struct CORE_EXPORT IExifReader
 
     virtual Tag::TagsList getTagsFor(const QString& path) = 0;                       // returns default set of tags
     virtual std::optional<std::any> get(const QString& path, const TagType &) = 0;   // access to optional data
+    virtual std::optional<QSize> imageSize(const QString& path) = 0;                 // dimensions of image (orientation not applied)
 };
 
 
 struct CORE_EXPORT IExifReaderFactory
 {
+    typedef ObjectsPool<IExifReader>::Lease ReaderLease;
+
     virtual ~IExifReaderFactory() = default;
 
-    virtual IExifReader& get() = 0;
+    virtual IExifReader& get() = 0;                 // reader bound to calling thread (valid until thread finishes)
+    virtual ReaderLease checkout() = 0;             // reader for exclusive use, returned to pool when lease is destroyed
 };
 
 #endif
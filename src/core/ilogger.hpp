@@ -22,6 +22,7 @@ struct ILogger
         Trace,
     };
 
+    virtual bool isEnabled(Severity) const = 0;               // cheap check, use it to avoid building messages which would be dropped
     virtual void log(Severity, const QString& message) = 0;
 
     virtual void info(const QString &) = 0;
@@ -2,6 +2,7 @@
 #ifndef IMAGE_TOOLS_HPP
 #define IMAGE_TOOLS_HPP
 
+#include <cstdint>
 #include <QImage>
 
 #include "core_export.h"
@@ -17,6 +18,10 @@ namespace Image
     bool CORE_EXPORT normalize(const QString& src,
                                const QString& dst,
                                IExifReader &);                // save 'src' file as 'dst' with rotation data applied
+
+    std::uint64_t CORE_EXPORT dHash(const QImage &);          // 64bit difference hash (perceptual hash) of image
+
+    QImage CORE_EXPORT loadForHashing(const QString &);       // load image in reduced size (enough for dHash calculation). Orientation is applied.
 }
 
 #endif
@@ -43,7 +43,7 @@ std::optional<std::any> exiv_result(const std::optional<T>& value)
 
 
 
-AExifReader::AExifReader(): m_id(std::this_thread::get_id())
+AExifReader::AExifReader()
 {
 
 }
@@ -57,8 +57,6 @@ AExifReader::~AExifReader()
 
 Tag::TagsList AExifReader::getTagsFor(const QString& path)
 {
-    assert(m_id == std::this_thread::get_id());
-
     const QFileInfo fileInfo(path);
     const QString full_path = fileInfo.absoluteFilePath();
 
@@ -72,8 +70,6 @@ Tag::TagsList AExifReader::getTagsFor(const QString& path)
 
 std::optional<std::any> AExifReader::get(const QString& path, const IExifReader::TagType& type)
 {
-    assert(m_id == std::this_thread::get_id());
-
     const QFileInfo fileInfo(path);
     const QString full_path = fileInfo.absoluteFilePath();
 
@@ -112,6 +108,17 @@ std::optional<std::any> AExifReader::get(const QString& path, const IExifReader:
 }
 
 
+std::optional<QSize> AExifReader::imageSize(const QString& path)
+{
+    const QFileInfo fileInfo(path);
+    const QString full_path = fileInfo.absoluteFilePath();
+
+    collect(full_path);
+
+    return readImageSize();
+}
+
+
 Tag::TagsList AExifReader::feedDateAndTime() const
 {
     Tag::TagsList tagData;
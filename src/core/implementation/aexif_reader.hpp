@@ -20,8 +20,6 @@
 #ifndef A_EXIF_READER_HPP
 #define A_EXIF_READER_HPP
 
-#include <thread>
-
 #include "iexif_reader.hpp"
 
 
@@ -40,13 +38,13 @@ class AExifReader: public IExifReader
     protected:
         virtual void collect(const QString &) = 0;
         virtual std::optional<std::string> read(TagType) const = 0;
+        virtual std::optional<QSize> readImageSize() const = 0;
 
     private:
-        std::thread::id m_id;
-
         // ITagFeeder:
         Tag::TagsList getTagsFor(const QString& path) override;
         std::optional<std::any> get(const QString& path, const TagType &) override;
+        std::optional<QSize> imageSize(const QString& path) override;
         //
 
         Tag::TagsList feedDateAndTime() const;
@@ -1,6 +1,7 @@
 
 #include "exif_reader_factory.hpp"
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
 
@@ -10,7 +11,22 @@
 #include "iexif_reader.hpp"
 
 
-ExifReaderFactory::ExifReaderFactory(): m_feeders()
+namespace
+{
+    // Readers are cheap to keep but each one may hold parsed metadata of last file.
+    // Keep one per hardware thread and drop the ones not used for a while
+    // (TaskExecutor's threads come and go, so readers are reused by new threads).
+    constexpr std::chrono::seconds MaxReaderIdleTime(30);
+
+    std::size_t maxIdleReaders()
+    {
+        return std::max(std::thread::hardware_concurrency(), 2u);
+    }
+}
+
+
+ExifReaderFactory::ExifReaderFactory()
+    : m_readers(ObjectsPool<IExifReader>::create([]{ return std::make_unique<Exiv2ExifReader>(); }, maxIdleReaders(), MaxReaderIdleTime))
 {
     static bool initialized = false;
     static std::recursive_mutex xmpMutex;
@@ -38,17 +54,12 @@ ExifReaderFactory::ExifReaderFactory(): m_feeders()
 
 IExifReader& ExifReaderFactory::get()
 {
-    //ExifTool may not be thread safe. Prepare separate object for each thread
-    const auto id = std::this_thread::get_id();
-    auto it = m_feeders.find(id);
-
-    if (it == m_feeders.end())
-    {
-        auto feeder = std::make_unique<Exiv2ExifReader>();
-        auto in = m_feeders.emplace(id, std::move(feeder));
+    // Exiv2 readers are not thread safe. Each thread gets its own reader which goes back to pool when thread finishes
+    return m_readers->threadBound();
+}
 
-        it = in.first;
-    }
 
-    return *it->second.get();
+IExifReaderFactory::ReaderLease ExifReaderFactory::checkout()
+{
+    return m_readers->checkout();
 }
@@ -3,6 +3,8 @@
 
 #include <assert.h>
 
+#include <QFile>
+
 #include "base_tags.hpp"
 
 namespace
@@ -16,12 +18,36 @@ namespace
         { AExifReader::TagType::PixelYDimension,  "Exif.Photo.PixelYDimension" },
         { AExifReader::TagType::Exposure,         "Exif.Photo.ExposureBiasValue" },
     };
+
+    // Map file to memory and parse its headers without copying.
+    // Returns std::nullopt for non JPEG files (or broken ones), Exiv2 will handle them.
+    std::optional<JpegExifParser::Data> parseJpeg(const QString& path)
+    {
+        std::optional<JpegExifParser::Data> result;
+        QFile file(path);
+
+        if (file.open(QFile::ReadOnly) && file.size() > 0)
+        {
+            uchar* data = file.map(0, file.size());
+
+            if (data != nullptr)
+            {
+                result = JpegExifParser::parse(data, static_cast<std::size_t>(file.size()));
+                file.unmap(data);
+            }
+        }
+
+        return result;
+    }
 }
 
 
-Exiv2ExifReader::Exiv2ExifReader():
+Exiv2ExifReader::Exiv2ExifReader(Parsers parsers):
     m_exif_data(),
-    m_path()
+    m_fastData(),
+    m_path(),
+    m_exiv2Loaded(false),
+    m_parsers(parsers)
 {
 
 }
@@ -31,6 +57,9 @@ bool Exiv2ExifReader::hasExif(const QString& path)
 {
     collect(path);
 
+    if (m_fastData.has_value())
+        return m_fastData->hasExif;
+
     return m_exif_data.get() && m_exif_data.get()->exifData().empty() == false;
 }
 
@@ -39,27 +68,63 @@ void Exiv2ExifReader::collect(const QString& path)
 {
     if (m_path != path)
     {
-        try
+        // save path of file we are working on.
+        // Do it before parsing so broken files are not reopened on each query
+        m_path = path;
+        m_exif_data.reset();
+        m_exiv2Loaded = false;
+        m_fastData.reset();
+
+        if (m_parsers == Parsers::FastPathAndExiv2)
+            m_fastData = parseJpeg(path);
+
+        if (m_fastData.has_value() == false)
+            loadExiv2();
+    }
+}
+
+
+std::optional<std::string> Exiv2ExifReader::read(AExifReader::TagType type) const
+{
+    if (m_fastData.has_value())
+        switch (type)
         {
-            m_exif_data.reset();
+            case TagType::DateTimeOriginal: return m_fastData->dateTimeOriginal;
+            case TagType::Orientation:      return m_fastData->orientation;
+            case TagType::PixelXDimension:  return m_fastData->pixelXDimension;
+            case TagType::PixelYDimension:  return m_fastData->pixelYDimension;
+            case TagType::Exposure:         return m_fastData->exposureBias;
+            case TagType::SequenceNumber:   return m_fastData->sequenceNumber;
+        }
+
+    loadExiv2();
+
+    return readExiv2(type);
+}
+
+
+void Exiv2ExifReader::loadExiv2() const
+{
+    if (m_exiv2Loaded == false)
+    {
+        m_exiv2Loaded = true;
 
-            m_exif_data = Exiv2::ImageFactory::open(path.toStdString());
+        try
+        {
+            m_exif_data = Exiv2::ImageFactory::open(m_path.toStdString());
 
             assert(m_exif_data.get() != 0);
             m_exif_data->readMetadata();
         }
         catch (Exiv2::AnyError &)
         {
-            return;
+            m_exif_data.reset();
         }
     }
-
-    // save path of file we are working on
-    m_path = path;
 }
 
 
-std::optional<std::string> Exiv2ExifReader::read(AExifReader::TagType type) const
+std::optional<std::string> Exiv2ExifReader::readExiv2(AExifReader::TagType type) const
 {
     std::optional<std::string> result;
 
@@ -87,3 +152,25 @@ std::optional<std::string> Exiv2ExifReader::read(AExifReader::TagType type) cons
 
     return result;
 }
+
+
+std::optional<QSize> Exiv2ExifReader::readImageSize() const
+{
+    std::optional<QSize> result;
+
+    if (m_fastData.has_value() && m_fastData->width > 0 && m_fastData->height > 0)
+        return QSize(m_fastData->width, m_fastData->height);
+
+    loadExiv2();
+
+    // Exiv2 reads image dimensions while parsing metadata (for formats it knows), no need to decode image
+    if (m_exif_data.get() != nullptr)
+    {
+        const QSize size(static_cast<int>(m_exif_data->pixelWidth()), static_cast<int>(m_exif_data->pixelHeight()));
+
+        if (size.width() > 0 && size.height() > 0)
+            result = size;
+    }
+
+    return result;
+}
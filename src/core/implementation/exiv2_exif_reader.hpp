@@ -8,6 +8,7 @@
 #include <exiv2/exiv2.hpp>
 
 #include "aexif_reader.hpp"
+#include "jpeg_exif_parser.hpp"
 
 
 template<typename, typename = void>
@@ -44,7 +45,13 @@ struct Exiv2Helper
 class Exiv2ExifReader: public AExifReader
 {
     public:
-        Exiv2ExifReader();
+        enum class Parsers
+        {
+            FastPathAndExiv2,       // use own parser for JPEG files, Exiv2 for anything else
+            Exiv2Only,
+        };
+
+        explicit Exiv2ExifReader(Parsers = Parsers::FastPathAndExiv2);
         Exiv2ExifReader(const Exiv2ExifReader &) = delete;
         Exiv2ExifReader(Exiv2ExifReader &&) = delete;
 
@@ -55,9 +62,16 @@ class Exiv2ExifReader: public AExifReader
         bool hasExif(const QString & path) override;
         virtual void collect(const QString &) override;
         virtual std::optional<std::string> read(TagType) const override;
+        virtual std::optional<QSize> readImageSize() const override;
 
-        Exiv2Helper<Exiv2::Image>::Ptr m_exif_data;
+        mutable Exiv2Helper<Exiv2::Image>::Ptr m_exif_data;      // loaded lazily when fast path cannot answer
+        std::optional<JpegExifParser::Data> m_fastData;
         QString m_path;
+        mutable bool m_exiv2Loaded;
+        const Parsers m_parsers;
+
+        void loadExiv2() const;
+        std::optional<std::string> readExiv2(TagType) const;
 };
 
 #endif
@@ -34,7 +34,8 @@ Eviv2MediaInformation::Eviv2MediaInformation(IExifReaderFactory& exif): m_exif(e
 
 std::optional<QSize> Eviv2MediaInformation::size(const QString& path) const
 {
-    IExifReader& exif_reader = m_exif.get();
+    const auto exif_lease = m_exif.checkout();
+    IExifReader& exif_reader = *exif_lease;
 
     std::optional<QSize> result;
 
@@ -0,0 +1,148 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file_hash.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <QFile>
+
+#ifdef HAVE_OPENSSL
+#include <openssl/evp.h>
+#else
+#include <QCryptographicHash>
+#endif
+
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+#endif
+
+
+namespace
+{
+    constexpr qint64 ReadBufferSize = 4 * 1024 * 1024;
+
+#ifdef HAVE_OPENSSL
+    // OpenSSL picks the fastest implementation available for current CPU (SHA-NI, AVX2 etc)
+    class Sha256
+    {
+        public:
+            Sha256()
+                : m_ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free)
+            {
+                m_valid = m_ctx && EVP_DigestInit_ex(m_ctx.get(), EVP_sha256(), nullptr) == 1;
+            }
+
+            bool addData(const char* data, qint64 size)
+            {
+                m_valid = m_valid && EVP_DigestUpdate(m_ctx.get(), data, static_cast<std::size_t>(size)) == 1;
+
+                return m_valid;
+            }
+
+            std::optional<QByteArray> result()
+            {
+                unsigned char digest[EVP_MAX_MD_SIZE];
+                unsigned int size = 0;
+
+                m_valid = m_valid && EVP_DigestFinal_ex(m_ctx.get(), digest, &size) == 1;
+
+                return m_valid? std::optional<QByteArray>(QByteArray(reinterpret_cast<const char *>(digest), static_cast<int>(size))): std::nullopt;
+            }
+
+        private:
+            std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> m_ctx;
+            bool m_valid;
+    };
+#else
+    class Sha256
+    {
+        public:
+            Sha256()
+                : m_hasher(QCryptographicHash::Sha256)
+            {
+            }
+
+            bool addData(const char* data, qint64 size)
+            {
+                m_hasher.addData(QByteArrayView(data, size));
+
+                return true;
+            }
+
+            std::optional<QByteArray> result()
+            {
+                return m_hasher.result();
+            }
+
+        private:
+            QCryptographicHash m_hasher;
+    };
+#endif
+
+
+    void adviseSequentialRead([[maybe_unused]] QFile& file)
+    {
+#ifdef HAVE_POSIX_FADVISE
+        posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+
+    void adviseNotNeeded([[maybe_unused]] QFile& file)
+    {
+#ifdef HAVE_POSIX_FADVISE
+        posix_fadvise(file.handle(), 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    }
+}
+
+
+namespace FileHash
+{
+    std::optional<QByteArray> sha256(const QString& path)
+    {
+        QFile file(path);
+
+        if (file.open(QFile::ReadOnly | QFile::Unbuffered) == false)
+            return {};
+
+        adviseSequentialRead(file);
+
+        Sha256 hasher;
+        std::vector<char> buffer(ReadBufferSize);
+        bool status = true;
+
+        while(status)
+        {
+            const qint64 read = file.read(buffer.data(), ReadBufferSize);
+
+            if (read < 0)
+                status = false;
+            else if (read == 0)
+                break;
+            else
+                status = hasher.addData(buffer.data(), read);
+        }
+
+        adviseNotNeeded(file);
+
+        return status? hasher.result(): std::nullopt;
+    }
+}
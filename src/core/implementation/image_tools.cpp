@@ -3,6 +3,8 @@
 
 #include <any>
 
+#include <QImageReader>
+
 #include "iexif_reader.hpp"
 
 
@@ -26,4 +28,43 @@ namespace Image
 
         return success;
     }
+
+
+    std::uint64_t dHash(const QImage& image)
+    {
+        // Reduce image to 9x8 grayscale and compare neighbouring pixels in rows.
+        // Each comparison gives one bit of hash.
+        const QImage small = image
+                                .convertToFormat(QImage::Format_Grayscale8)
+                                .scaled(9, 8, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        std::uint64_t hash = 0;
+
+        for (int y = 0; y < 8; y++)
+        {
+            const uchar* line = small.constScanLine(y);
+
+            for (int x = 0; x < 8; x++)
+            {
+                hash <<= 1;
+                hash |= line[x] < line[x + 1]? 1: 0;
+            }
+        }
+
+        return hash;
+    }
+
+
+    QImage loadForHashing(const QString& path)
+    {
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+
+        // Let decoder do the scaling (jpeg can decode in reduced resolution which is much faster).
+        const QSize size = reader.size();
+        if (size.isValid())
+            reader.setScaledSize(size.scaled(64, 64, Qt::KeepAspectRatioByExpanding));
+
+        return reader.read();
+    }
 }
@@ -0,0 +1,327 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jpeg_exif_parser.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace
+{
+    enum Tags: std::uint16_t
+    {
+        Orientation        = 0x0112,
+        ExifIFDPointer     = 0x8769,
+        DateTimeOriginal   = 0x9003,
+        ExposureBiasValue  = 0x9204,
+        MakerNote          = 0x927C,
+        PixelXDimension    = 0xA002,
+        PixelYDimension    = 0xA003,
+        SonySequenceNumber = 0xB04A,
+    };
+
+    // Sony's maker note with header is an IFD placed right after it (offsets are relative to TIFF header).
+    // Exiv2 calls it 'Sony1', maker notes without header ('Sony2') are not used by Photo Broom.
+    const std::size_t SonyHeaderSize = 12;
+    const char SonyDscHeader[] = "SONY DSC \0\0\0";
+    const char SonyCamHeader[] = "SONY CAM \0\0\0";
+
+    enum Types: std::uint16_t
+    {
+        Ascii     = 2,
+        Short     = 3,
+        Long      = 4,
+        SRational = 10,
+    };
+
+    class TiffReader
+    {
+        public:
+            TiffReader(const unsigned char* data, std::size_t size)
+                : m_data(data)
+                , m_size(size)
+                , m_bigEndian(false)
+            {
+
+            }
+
+            bool readHeader(std::uint32_t& firstIFD)
+            {
+                if (m_size < 8)
+                    return false;
+
+                if (m_data[0] == 'I' && m_data[1] == 'I')
+                    m_bigEndian = false;
+                else if (m_data[0] == 'M' && m_data[1] == 'M')
+                    m_bigEndian = true;
+                else
+                    return false;
+
+                std::uint16_t magic = 0;
+
+                return u16(2, magic) && magic == 42 && u32(4, firstIFD);
+            }
+
+            // calls callback(tag, type, count, valueOffset) for each entry of IFD
+            template<typename C>
+            bool readIFD(std::uint32_t offset, C&& callback)
+            {
+                std::uint16_t entries = 0;
+
+                if (u16(offset, entries) == false)
+                    return false;
+
+                for (std::uint16_t i = 0; i < entries; i++)
+                {
+                    const std::size_t entry = offset + 2 + i * 12;
+                    std::uint16_t tag = 0, type = 0;
+                    std::uint32_t count = 0;
+
+                    if (u16(entry, tag) == false || u16(entry + 2, type) == false || u32(entry + 4, count) == false)
+                        return false;
+
+                    // values longer than 4 bytes are stored elsewhere, otherwise in place
+                    const std::size_t length = static_cast<std::size_t>(count) * typeSize(type);
+                    std::uint32_t valueOffset = static_cast<std::uint32_t>(entry + 8);
+
+                    if (length > 4 && u32(entry + 8, valueOffset) == false)
+                        return false;
+
+                    if (valueOffset + length > m_size)
+                        continue;                           // broken entry, skip it
+
+                    callback(tag, type, count, valueOffset);
+                }
+
+                return true;
+            }
+
+            bool u16(std::size_t offset, std::uint16_t& value) const
+            {
+                if (offset + 2 > m_size)
+                    return false;
+
+                const unsigned char* p = m_data + offset;
+                value = m_bigEndian?
+                    static_cast<std::uint16_t>(p[0] << 8 | p[1]):
+                    static_cast<std::uint16_t>(p[1] << 8 | p[0]);
+
+                return true;
+            }
+
+            bool u32(std::size_t offset, std::uint32_t& value) const
+            {
+                if (offset + 4 > m_size)
+                    return false;
+
+                const unsigned char* p = m_data + offset;
+                value = m_bigEndian?
+                    static_cast<std::uint32_t>(p[0]) << 24 | static_cast<std::uint32_t>(p[1]) << 16 | static_cast<std::uint32_t>(p[2]) << 8 | p[3]:
+                    static_cast<std::uint32_t>(p[3]) << 24 | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[1]) << 8 | p[0];
+
+                return true;
+            }
+
+            std::optional<std::string> integer(std::uint16_t type, std::uint32_t offset) const
+            {
+                std::optional<std::string> result;
+
+                if (type == Short)
+                {
+                    std::uint16_t v = 0;
+                    if (u16(offset, v))
+                        result = std::to_string(v);
+                }
+                else if (type == Long)
+                {
+                    std::uint32_t v = 0;
+                    if (u32(offset, v))
+                        result = std::to_string(v);
+                }
+
+                return result;
+            }
+
+            std::optional<std::string> ascii(std::uint16_t type, std::uint32_t count, std::uint32_t offset) const
+            {
+                std::optional<std::string> result;
+
+                if (type == Ascii)
+                {
+                    const char* str = reinterpret_cast<const char *>(m_data + offset);
+                    const std::size_t len = strnlen(str, count);
+
+                    result = std::string(str, len);
+                }
+
+                return result;
+            }
+
+            std::optional<std::string> srational(std::uint16_t type, std::uint32_t offset) const
+            {
+                std::optional<std::string> result;
+                std::uint32_t nom = 0, den = 0;
+
+                if (type == SRational && u32(offset, nom) && u32(offset + 4, den))
+                    result = std::to_string(static_cast<std::int32_t>(nom)) + "/" + std::to_string(static_cast<std::int32_t>(den));
+
+                return result;
+            }
+
+        private:
+            const unsigned char* m_data;
+            std::size_t m_size;
+            bool m_bigEndian;
+
+            static std::size_t typeSize(std::uint16_t type)
+            {
+                switch(type)
+                {
+                    case 3:  case 8:            return 2;
+                    case 4:  case 9:  case 11:  return 4;
+                    case 5:  case 10: case 12:  return 8;
+                    default:                    return 1;
+                }
+            }
+    };
+
+
+    bool parseTiff(const unsigned char* data, std::size_t size, JpegExifParser::Data& result)
+    {
+        TiffReader reader(data, size);
+        std::uint32_t ifd0 = 0;
+        std::uint32_t exifIFD = 0;
+        std::uint32_t makerNote = 0;
+        std::uint32_t makerNoteSize = 0;
+
+        if (reader.readHeader(ifd0) == false)
+            return false;
+
+        const bool ifd0_status = reader.readIFD(ifd0, [&](std::uint16_t tag, std::uint16_t type, std::uint32_t, std::uint32_t offset)
+        {
+            if (tag == Orientation)
+                result.orientation = reader.integer(type, offset);
+            else if (tag == ExifIFDPointer)
+                reader.u32(offset, exifIFD);
+        });
+
+        if (ifd0_status == false)
+            return false;
+
+        if (exifIFD != 0)
+        {
+            const bool exif_status = reader.readIFD(exifIFD, [&](std::uint16_t tag, std::uint16_t type, std::uint32_t count, std::uint32_t offset)
+            {
+                switch (tag)
+                {
+                    case DateTimeOriginal:  result.dateTimeOriginal = reader.ascii(type, count, offset); break;
+                    case ExposureBiasValue: result.exposureBias = reader.srational(type, offset);         break;
+                    case PixelXDimension:   result.pixelXDimension = reader.integer(type, offset);        break;
+                    case PixelYDimension:   result.pixelYDimension = reader.integer(type, offset);        break;
+                    case MakerNote:         makerNote = offset; makerNoteSize = count;                    break;
+                }
+            });
+
+            if (exif_status == false)
+                return false;
+        }
+
+        if (makerNoteSize > SonyHeaderSize &&
+            (std::memcmp(data + makerNote, SonyDscHeader, SonyHeaderSize) == 0 || std::memcmp(data + makerNote, SonyCamHeader, SonyHeaderSize) == 0))
+        {
+            // broken maker note is not a reason to reject other tags
+            reader.readIFD(makerNote + SonyHeaderSize, [&](std::uint16_t tag, std::uint16_t type, std::uint32_t, std::uint32_t offset)
+            {
+                if (tag == SonySequenceNumber)
+                    result.sequenceNumber = reader.integer(type, offset);
+            });
+        }
+
+        result.hasExif = true;
+
+        return true;
+    }
+
+
+    bool isSOF(unsigned char marker)
+    {
+        // SOF0 - SOF15 except DHT (C4), JPG (C8) and DAC (CC)
+        return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+    }
+}
+
+
+namespace JpegExifParser
+{
+    std::optional<Data> parse(const unsigned char* data, std::size_t size)
+    {
+        if (size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+            return {};
+
+        Data result;
+        std::size_t pos = 2;
+
+        // walk through segments until image data begins
+        while (pos + 4 <= size)
+        {
+            if (data[pos] != 0xFF)
+                return {};
+
+            const unsigned char marker = data[pos + 1];
+
+            if (marker == 0xFF)                                 // fill byte
+            {
+                pos++;
+                continue;
+            }
+
+            if (marker == 0xD9 || marker == 0xDA)               // EOI or SOS
+                break;
+
+            if ((marker >= 0xD0 && marker <= 0xD7) || marker == 0x01)
+            {
+                pos += 2;                                       // markers without payload
+                continue;
+            }
+
+            const std::size_t length = static_cast<std::size_t>(data[pos + 2] << 8 | data[pos + 3]);
+
+            if (length < 2 || pos + 2 + length > size)
+                return {};
+
+            const unsigned char* segment = data + pos + 4;
+            const std::size_t segmentSize = length - 2;
+
+            if (marker == 0xE1 && result.hasExif == false && segmentSize >= 6 && std::memcmp(segment, "Exif\0\0", 6) == 0)
+            {
+                if (parseTiff(segment + 6, segmentSize - 6, result) == false)
+                    return {};
+            }
+            else if (isSOF(marker) && segmentSize >= 5)
+            {
+                result.height = segment[1] << 8 | segment[2];
+                result.width = segment[3] << 8 | segment[4];
+            }
+
+            pos += 2 + length;
+        }
+
+        return result;
+    }
+}
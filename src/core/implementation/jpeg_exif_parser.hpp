@@ -0,0 +1,49 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JPEG_EXIF_PARSER_HPP
+#define JPEG_EXIF_PARSER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+
+// Minimal parser of JPEG's headers.
+// Walks APP1 (Exif) segment and extracts only tags Photo Broom needs.
+// Values are returned in the same textual form Exiv2 uses, so they can be handled in the same way.
+namespace JpegExifParser
+{
+    struct Data
+    {
+        std::optional<std::string> dateTimeOriginal;
+        std::optional<std::string> orientation;
+        std::optional<std::string> pixelXDimension;
+        std::optional<std::string> pixelYDimension;
+        std::optional<std::string> exposureBias;
+        std::optional<std::string> sequenceNumber;     // from Sony's maker note
+        int width = 0;                                  // from SOF marker
+        int height = 0;
+        bool hasExif = false;
+    };
+
+    // returns std::nullopt when data is not a JPEG image or its headers are malformed
+    std::optional<Data> parse(const unsigned char* data, std::size_t size);
+}
+
+#endif
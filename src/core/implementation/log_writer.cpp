@@ -0,0 +1,161 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "log_writer.hpp"
+
+#include <iostream>
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "log_file_rotator.hpp"
+#include "thread_utils.hpp"
+
+
+namespace
+{
+    constexpr std::size_t QueueCapacity = 8192;
+    constexpr std::size_t MaxBatchSize = 1024 * 1024;
+    constexpr std::size_t MaxLogFileSize = 64 * 1024 * 1024;
+
+    QString severity(ILogger::Severity s)
+    {
+        QString result;
+
+        switch(s)
+        {
+            case ILogger::Severity::Error:   result = "E"; break;
+            case ILogger::Severity::Warning: result = "W"; break;
+            case ILogger::Severity::Info:    result = "I"; break;
+            case ILogger::Severity::Debug:   result = "D"; break;
+            case ILogger::Severity::Trace:   result = "T"; break;
+        }
+
+        return result;
+    }
+
+    void append(std::string& batch, const LogWriter::Record& record)
+    {
+        const auto msecs = std::chrono::duration_cast<std::chrono::milliseconds>(record.time.time_since_epoch()).count();
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(msecs);
+        const QString line = QString("%1 [%2][%3]: %4\n")
+                                .arg(time.toString("yyyy-MM-dd HH:mm:ss:zzz"),
+                                     severity(record.severity),
+                                     record.utility,
+                                     record.message);
+
+        batch += line.toStdString();
+    }
+}
+
+
+LogWriter::LogWriter(const QString& path)
+    : m_records(QueueCapacity)
+    , m_pushed(0)
+    , m_work(true)
+    , m_path(path)
+    , m_file()
+    , m_fileSize(0)
+{
+    LogFileRotator().rotate(m_path);
+    openFile();
+
+    m_thread = std::thread(&LogWriter::run, this);
+}
+
+
+LogWriter::~LogWriter()
+{
+    m_work = false;
+    m_pushed++;
+    m_pushed.notify_one();
+
+    m_thread.join();
+}
+
+
+void LogWriter::write(Record&& record)
+{
+    // when writer cannot keep up, wait for free space rather than lose records
+    while (m_records.push(std::move(record)) == false)
+        std::this_thread::yield();
+
+    m_pushed.fetch_add(1, std::memory_order_release);
+    m_pushed.notify_one();
+}
+
+
+void LogWriter::run()
+{
+    set_thread_name("LogWriter");
+
+    std::string batch;
+    Record record;
+
+    for(;;)
+    {
+        // remember state before draining queue so no push or stop request is missed
+        const std::uint32_t pushed = m_pushed.load(std::memory_order_acquire);
+        const bool work = m_work;
+
+        while (batch.size() < MaxBatchSize && m_records.pop(record))
+            append(batch, record);
+
+        if (batch.empty())
+        {
+            if (work == false)
+                break;
+
+            m_pushed.wait(pushed, std::memory_order_acquire);
+        }
+        else
+        {
+            store(batch);
+            batch.clear();
+        }
+    }
+}
+
+
+void LogWriter::store(const std::string& batch)
+{
+    m_file << batch;
+    m_file.flush();
+
+    std::cout << batch;
+    std::cout.flush();
+
+    m_fileSize += batch.size();
+
+    if (m_fileSize > MaxLogFileSize)
+    {
+        m_file.close();
+        LogFileRotator().rotate(m_path);
+        openFile();
+    }
+}
+
+
+void LogWriter::openFile()
+{
+    const std::string str_path = m_path.toStdString();
+
+    m_file.open(str_path, std::ofstream::out | std::ofstream::app);
+    m_fileSize = static_cast<std::size_t>(QFileInfo(m_path).size());
+}
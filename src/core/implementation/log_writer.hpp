@@ -0,0 +1,76 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LOG_WRITER_HPP_INCLUDED
+#define LOG_WRITER_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <QString>
+
+#include "ilogger.hpp"
+#include "lock_free_queue.hpp"
+
+
+/**
+ * \brief Background writer of log records
+ *
+ * Records are formatted and written by a dedicated thread, in batches, to log file and standard output.
+ * Loggers only put records into lock free queue so logging does not block callers.
+ * Log file is rotated with LogFileRotator on start and whenever it grows too big.
+ */
+class LogWriter
+{
+    public:
+        struct Record
+        {
+            std::chrono::system_clock::time_point time;
+            ILogger::Severity severity = ILogger::Severity::Info;
+            QString utility;
+            QString message;
+        };
+
+        explicit LogWriter(const QString& path);
+        LogWriter(const LogWriter &) = delete;
+        ~LogWriter();                               // writes all pending records
+
+        LogWriter& operator=(const LogWriter &) = delete;
+
+        void write(Record &&);                      // thread safe
+
+    private:
+        LockFreeQueue<Record> m_records;
+        std::atomic<std::uint32_t> m_pushed;        // incremented on each push, writer thread waits for its change
+        std::atomic<bool> m_work;
+        const QString m_path;
+        std::ofstream m_file;
+        std::size_t m_fileSize;
+        std::thread m_thread;
+
+        void run();
+        void store(const std::string &);
+        void openFile();
+};
+
+#endif
@@ -19,57 +19,40 @@
 
 #include "logger.hpp"
 
-#include <cassert>
-#include <iostream>
-
-#include <sstream>
-
-#include <QString>
-#include <QFile>
-#include <QTime>
-#include <QDir>
-
 #include <core/ilogger_factory.hpp>
 
+#include "log_writer.hpp"
 
-Logger::Logger(std::mutex& output_mutex, std::ostream& stream, const QStringList& utility, Severity severity, const ILoggerFactory* factory):
+
+Logger::Logger(LogWriter& writer, const QStringList& utility, Severity severity, const ILoggerFactory* factory):
     m_utility(utility),
+    m_utilityName(utility.join(":")),
     m_severity(severity),
-    m_file(stream),
-    m_outputMutex(output_mutex),
+    m_writer(writer),
     m_loggerFactory(factory)
 {
 
 }
 
 
-Logger::Logger(std::mutex& output_mutex, std::ostream& stream, const QString& utility, Severity severity, const ILoggerFactory* factory):
-    Logger(output_mutex, stream, QStringList({utility}), severity, factory)
+Logger::Logger(LogWriter& writer, const QString& utility, Severity severity, const ILoggerFactory* factory):
+    Logger(writer, QStringList({utility}), severity, factory)
 {
 
 }
 
 
-void Logger::log(ILogger::Severity sev, const QString& message)
+bool Logger::isEnabled(ILogger::Severity sev) const
 {
-    std::lock_guard<std::mutex> lock(m_outputMutex);
-
-    const QString s = severity(sev);
-    const QString m = QString("%1 %2 [%3][%4]: %5")
-                        .arg(currentDate())
-                        .arg(currentTime())
-                        .arg(s)
-                        .arg(m_utility.join(":"))
-                        .arg(message);
-
-    const std::string message_str = m.toStdString();
+    return sev <= m_severity;
+}
 
-    if (sev <= m_severity)
-    {
-        m_file << message_str << "\n";
 
-        std::cout << message_str << std::endl;
-    }
+void Logger::log(ILogger::Severity sev, const QString& message)
+{
+    // message is formatted by writer's thread
+    if (isEnabled(sev))
+        m_writer.write( {std::chrono::system_clock::now(), sev, m_utilityName, message} );
 }
 
 
@@ -110,38 +93,3 @@ std::unique_ptr<ILogger> Logger::subLogger(const QString& sub_utility)
 
     return m_loggerFactory->get(sub_utility_name);
 }
-
-
-QString Logger::currentTime() const
-{
-    QTime now = QTime::currentTime();
-    const QString timeStr = now.toString("HH:mm:ss:zzz");
-
-    return timeStr;
-}
-
-
-QString Logger::currentDate() const
-{
-    QDate now = QDate::currentDate();
-    const QString dateStr = now.toString("yyyy-MM-dd");
-
-    return dateStr;
-}
-
-
-QString Logger::severity(ILogger::Severity s) const
-{
-    QString result;
-
-    switch(s)
-    {
-        case Severity::Error:   result = "E"; break;
-        case Severity::Warning: result = "W"; break;
-        case Severity::Info:    result = "I"; break;
-        case Severity::Debug:   result = "D"; break;
-        case Severity::Trace:   result = "T"; break;
-    }
-
-    return result;
-}
@@ -20,16 +20,19 @@
 #include "logger_factory.hpp"
 
 #include "logger.hpp"
-#include "log_file_rotator.hpp"
+#include "log_writer.hpp"
 
-LoggerFactory::LoggerFactory(const QString& path): m_logFile(), m_logingLevel(ILogger::Severity::Warning), m_outputMutex()
+LoggerFactory::LoggerFactory(const QString& path):
+    m_writer(std::make_unique<LogWriter>(path + "/photo_broom.log")),
+    m_logingLevel(ILogger::Severity::Warning)
 {
-    const QString log_path = path + "/photo_broom.log";
-    LogFileRotator().rotate(log_path);
 
-    const std::string str_path = log_path.toStdString();
+}
+
+
+LoggerFactory::~LoggerFactory()
+{
 
-    m_logFile.open(str_path, std::ofstream::out | std::ofstream::app);
 }
 
 
@@ -47,7 +50,7 @@ std::unique_ptr<ILogger> LoggerFactory::get(const QString& utility) const
 
 std::unique_ptr<ILogger> LoggerFactory::get(const QStringList& utility) const
 {
-    auto logger = std::make_unique<Logger>(m_outputMutex, m_logFile, utility, m_logingLevel, this);
+    auto logger = std::make_unique<Logger>(*m_writer, utility, m_logingLevel, this);
 
     return std::move(logger);
 }
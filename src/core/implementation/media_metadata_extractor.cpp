@@ -0,0 +1,119 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "media_metadata_extractor.hpp"
+
+#include <QFileInfo>
+#include <QImageReader>
+
+#include "icore_factory_accessor.hpp"
+#include "iexif_reader.hpp"
+#include "ilogger_factory.hpp"
+#include "ilogger.hpp"
+#include "media_types.hpp"
+#include "implementation/ffmpeg_media_information.hpp"
+
+
+namespace
+{
+    template<typename T>
+    std::optional<T> read(IExifReader& reader, const QString& path, IExifReader::TagType type)
+    {
+        std::optional<T> result;
+        const std::optional<std::any> raw = reader.get(path, type);
+
+        if (raw.has_value())
+            result = std::any_cast<T>(*raw);
+
+        return result;
+    }
+}
+
+
+struct MediaMetadataExtractor::Impl
+{
+    IExifReaderFactory& m_exif;
+    FFmpegMediaInformation m_ffmpeg_info;
+    std::unique_ptr<ILogger> m_logger;
+
+    explicit Impl(ICoreFactoryAccessor* coreFactory):
+        m_exif(coreFactory->getExifReaderFactory()),
+        m_ffmpeg_info(coreFactory->getConfiguration()),
+        m_logger(coreFactory->getLoggerFactory().get("Media Metadata Extractor"))
+    {
+
+    }
+};
+
+
+MediaMetadataExtractor::MediaMetadataExtractor(ICoreFactoryAccessor* coreFactory): m_impl(std::make_unique<Impl>(coreFactory))
+{
+
+}
+
+
+MediaMetadataExtractor::~MediaMetadataExtractor()
+{
+
+}
+
+
+MediaMetadata MediaMetadataExtractor::extract(const QString& path) const
+{
+    const QFileInfo fileInfo(path);
+    const QString full_path = fileInfo.absoluteFilePath();
+
+    MediaMetadata metadata;
+    std::optional<int> orientation;
+
+    {
+        // keep the same reader for all queries - file is parsed by first one, others use cached data
+        const auto reader = m_impl->m_exif.checkout();
+
+        metadata.tags = reader->getTagsFor(full_path);
+        orientation = read<int>(*reader, full_path, IExifReader::TagType::Orientation);
+
+        if (MediaTypes::isImageFile(full_path))
+            metadata.size = reader->imageSize(full_path);
+    }
+
+    if (metadata.size.has_value() == false && MediaTypes::isImageFile(full_path))  // format unknown to exif reader - read dimensions from image properties
+    {
+        const QImageReader reader(full_path);
+        const QSize imgSize = reader.size();
+
+        if (imgSize.isValid())
+            metadata.size = imgSize;
+    }
+
+    // orientations 5, 6, 7 and 8 require 90⁰ degree rotations which swap dimensions
+    if (metadata.size.has_value() && orientation.value_or(0) > 4)
+        metadata.size->transpose();
+
+    if (metadata.size.has_value() == false && MediaTypes::isVideoFile(full_path))
+        metadata.size = m_impl->m_ffmpeg_info.size(full_path);
+
+    if (metadata.size.has_value() == false)
+    {
+        const QString error = QString("Could not load image data from '%1'. File format unknown or file corrupted").arg(path);
+
+        m_impl->m_logger->error(error);
+    }
+
+    return metadata;
+}
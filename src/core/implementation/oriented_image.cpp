@@ -20,28 +20,34 @@
 
 #include <any>
 
-#include <core/iexif_reader.hpp>
-
+#include <QImageReader>
 
-OrientedImage::OrientedImage():
-    m_oriented()
-{
-}
+#include <core/iexif_reader.hpp>
 
 
-OrientedImage::OrientedImage(IExifReader& exif, const QString& src):
-    m_oriented()
+namespace
 {
-    QImage img(src);
-    QImage rotated;
-
-    if (img.isNull() == false)
+    int readOrientation(IExifReader& exif, const QString& src)
     {
         const std::optional<std::any> orientation_raw = exif.get(src, IExifReader::TagType::Orientation);
         const int orientation = orientation_raw.has_value()?
                                     std::any_cast<int>(*orientation_raw):
                                     0;
 
+        return orientation;
+    }
+
+
+    bool swapsDimensions(int orientation)
+    {
+        return orientation >= 5 && orientation <= 8;
+    }
+
+
+    QImage applyOrientation(const QImage& img, int orientation)
+    {
+        QImage rotated;
+
         switch(orientation)
         {
             case 0:
@@ -102,9 +108,41 @@ OrientedImage::OrientedImage(IExifReader& exif, const QString& src):
                 break;
             }
         }
+
+        return rotated;
     }
+}
+
+
+OrientedImage::OrientedImage():
+    m_oriented()
+{
+}
+
+
+OrientedImage::OrientedImage(IExifReader& exif, const QString& src):
+    m_oriented()
+{
+    const QImage img(src);
+
+    if (img.isNull() == false)
+        m_oriented = applyOrientation(img, readOrientation(exif, src));
+}
 
-    m_oriented = rotated;
+
+OrientedImage::OrientedImage(IExifReader& exif, const QString& src, const QSize& size):
+    m_oriented()
+{
+    const int orientation = readOrientation(exif, src);
+
+    // let decoder do the scaling (jpeg can be decoded in reduced resolution which is much faster and needs less memory)
+    QImageReader reader(src);
+    reader.setScaledSize(swapsDimensions(orientation)? size.transposed(): size);
+
+    const QImage img = reader.read();
+
+    if (img.isNull() == false)
+        m_oriented = applyOrientation(img, orientation);
 }
 
 
@@ -118,3 +156,11 @@ const QImage* OrientedImage::operator->() const
 {
     return &m_oriented;
 }
+
+
+QSize OrientedImage::size(IExifReader& exif, const QString& src)
+{
+    const QSize size = QImageReader(src).size();
+
+    return swapsDimensions(readOrientation(exif, src))? size.transposed(): size;
+}
@@ -37,14 +37,21 @@ struct TasksQueue::IntTask: ITaskExecutor::ITask
 
 
 TasksQueue::TasksQueue(ITaskExecutor* executor, Mode mode):
+    TasksQueue(executor, executor->heavyWorkers() + 2, mode)
+{
+
+}
+
+
+TasksQueue::TasksQueue(ITaskExecutor* executor, int maxTasks, Mode mode):
     m_tasksMutex(),
     m_waitingTasks(),
     m_tasksExecutor(executor),
-    m_maxTasks(executor->heavyWorkers() + 2),
+    m_maxTasks(maxTasks),
     m_executingTasks(0),
     m_mode(mode)
 {
-
+    assert(m_maxTasks > 0);
 }
 
 
@@ -61,7 +61,7 @@ QImage ThumbnailGenerator::generate(const QString& path, const IThumbnailsCache:
 
 QImage ThumbnailGenerator::readFrameFromImage(const QString& path) const
 {
-    IExifReader& reader = m_exifReaderFactory.get();
+    const auto reader = m_exifReaderFactory.checkout();
 
     Stopwatch stopwatch;
     stopwatch.start();
@@ -69,7 +69,7 @@ QImage ThumbnailGenerator::readFrameFromImage(const QString& path) const
     QImage image;
 
     if(QFile::exists(path))
-        image = Image::normalized(path, reader).get();
+        image = Image::normalized(path, *reader).get();
 
     if (image.isNull())
     {
@@ -78,10 +78,13 @@ QImage ThumbnailGenerator::readFrameFromImage(const QString& path) const
         m_logger->error(error);
     }
 
-    const int photo_read = stopwatch.read(true);
+    if (m_logger->isEnabled(ILogger::Severity::Debug))
+    {
+        const int photo_read = stopwatch.read(true);
 
-    const QString read_time_message = QString("photo %1 read time: %2ms").arg(path).arg(photo_read);
-    m_logger->debug(read_time_message);
+        const QString read_time_message = QString("photo %1 read time: %2ms").arg(path).arg(photo_read);
+        m_logger->debug(read_time_message);
+    }
 
     return image;
 }
@@ -163,10 +166,13 @@ QImage ThumbnailGenerator::scaleImage(const QImage& image, const IThumbnailsCach
     else
         thumbnail = image.scaledToHeight(size.height(), Qt::SmoothTransformation);
 
-    const int photo_scaling = stopwatch.stop();
+    if (m_logger->isEnabled(ILogger::Severity::Debug))
+    {
+        const int photo_scaling = stopwatch.stop();
 
-    const QString scaling_time_message = QString("photo scaling time: %1ms").arg(photo_scaling);
-    m_logger->debug(scaling_time_message);
+        const QString scaling_time_message = QString("photo scaling time: %1ms").arg(photo_scaling);
+        m_logger->debug(scaling_time_message);
+    }
 
     return thumbnail;
 }
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+#include <QDirIterator>
+
+#include "implementation/exiv2_exif_reader.hpp"
+
+
+namespace
+{
+    struct Result
+    {
+        Tag::TagsList tags;
+        std::optional<std::any> orientation;
+        std::optional<std::any> exposure;
+        std::optional<QSize> size;
+    };
+
+    QStringList corpus()
+    {
+        QStringList files;
+        const QString dir = qEnvironmentVariable("EXIF_CORPUS_DIR");
+
+        if (dir.isEmpty() == false)
+        {
+            QDirIterator it(dir, {"*.jpg", "*.jpeg", "*.JPG", "*.JPEG", "*.heic", "*.HEIC"}, QDir::Files, QDirIterator::Subdirectories);
+
+            while (it.hasNext())
+                files.append(it.next());
+        }
+
+        return files;
+    }
+
+    std::vector<Result> readAll(Exiv2ExifReader::Parsers parsers, const QStringList& files, std::chrono::milliseconds& time)
+    {
+        std::vector<Result> results;
+        results.reserve(files.size());
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (const QString& file: files)
+        {
+            // new reader for each file, so no caching is involved
+            Exiv2ExifReader exiv2(parsers);
+            IExifReader& reader = exiv2;
+
+            Result result;
+            result.tags = reader.getTagsFor(file);
+            result.orientation = reader.get(file, IExifReader::TagType::Orientation);
+            result.exposure = reader.get(file, IExifReader::TagType::Exposure);
+            result.size = reader.imageSize(file);
+
+            results.push_back(result);
+        }
+
+        time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        return results;
+    }
+
+    template<typename T>
+    std::optional<T> value(const std::optional<std::any>& v)
+    {
+        return v.has_value()? std::optional<T>(std::any_cast<T>(*v)): std::nullopt;
+    }
+}
+
+
+TEST(ExifReadersBenchmark, fastPathVsExiv2)
+{
+    const QStringList files = corpus();
+
+    if (files.isEmpty())
+        GTEST_SKIP() << "EXIF_CORPUS_DIR not set or empty";
+
+    std::chrono::milliseconds exiv2Time, fastTime;
+
+    // warm up disk cache so both readers work in the same conditions
+    readAll(Exiv2ExifReader::Parsers::Exiv2Only, files, exiv2Time);
+
+    const auto exiv2 = readAll(Exiv2ExifReader::Parsers::Exiv2Only, files, exiv2Time);
+    const auto fast = readAll(Exiv2ExifReader::Parsers::FastPathAndExiv2, files, fastTime);
+
+    std::cout << files.size() << " files. Exiv2: " << exiv2Time.count() << "ms, fast path: " << fastTime.count() << "ms" << std::endl;
+
+    ASSERT_EQ(exiv2.size(), fast.size());
+
+    for (std::size_t i = 0; i < exiv2.size(); i++)
+    {
+        SCOPED_TRACE(files[static_cast<int>(i)].toStdString());
+
+        EXPECT_EQ(exiv2[i].tags, fast[i].tags);
+        EXPECT_EQ(value<int>(exiv2[i].orientation), value<int>(fast[i].orientation));
+        EXPECT_EQ(value<float>(exiv2[i].exposure), value<float>(fast[i].exposure));
+        EXPECT_EQ(exiv2[i].size, fast[i].size);
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LOCK_FREE_QUEUE_HPP_INCLUDED
+#define LOCK_FREE_QUEUE_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+/**
+ * \brief Bounded queue for multiple producers and consumers which does not use locks
+ *
+ * Each cell carries sequence number telling if it is ready to be written or read
+ * (Dmitry Vyukov's bounded MPMC queue), so producers and consumers only compete for queue's positions.
+ * Capacity is rounded up to the power of 2.
+ */
+template<typename T>
+class LockFreeQueue
+{
+    public:
+        explicit LockFreeQueue(std::size_t capacity)
+            : m_capacity(std::bit_ceil(std::max<std::size_t>(capacity, 2)))
+            , m_mask(m_capacity - 1)
+            , m_cells(std::make_unique<Cell[]>(m_capacity))
+            , m_enqueuePos(0)
+            , m_dequeuePos(0)
+        {
+            for (std::size_t i = 0; i < m_capacity; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        LockFreeQueue(const LockFreeQueue &) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue &) = delete;
+
+        /**
+         * \brief put value at the end of queue
+         * \return false when queue is full (value is not moved then)
+         */
+        bool push(T&& value)
+        {
+            std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+
+            for(;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /**
+         * \brief take value from the front of queue
+         * \return false when queue is empty
+         */
+        bool pop(T& value)
+        {
+            std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+
+            for(;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+                if (diff == 0)
+                {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+
+            value = std::move(cell->value);
+            cell->value = T();
+            cell->sequence.store(pos + m_capacity, std::memory_order_release);
+
+            return true;
+        }
+
+        std::size_t capacity() const
+        {
+            return m_capacity;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        const std::size_t m_capacity;
+        const std::size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+
+        // keep positions in separate cache lines so producers and consumers do not disturb each other
+        alignas(64) std::atomic<std::size_t> m_enqueuePos;
+        alignas(64) std::atomic<std::size_t> m_dequeuePos;
+};
+
+#endif
@@ -20,18 +20,14 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
-#include <string>
-#include <map>
-#include <mutex>
-
 #include <QStringList>
 
 #include "ilogger.hpp"
 
 #include "core_export.h"
 
-class QIODevice;
 class QString;
+class LogWriter;
 
 struct ILoggerFactory;
 
@@ -39,13 +35,14 @@ struct ILoggerFactory;
 class CORE_EXPORT Logger: public ILogger
 {
     public:
-        Logger(std::mutex &, std::ostream &, const QString& utility, Severity, const ILoggerFactory *);
-        Logger(std::mutex &, std::ostream &, const QStringList& utility, Severity, const ILoggerFactory *);
+        Logger(LogWriter &, const QString& utility, Severity, const ILoggerFactory *);
+        Logger(LogWriter &, const QStringList& utility, Severity, const ILoggerFactory *);
         Logger(const Logger& other) = delete;
         ~Logger() = default;
 
         Logger& operator=(const Logger& other) = delete;
 
+        bool isEnabled(Severity) const override;
         void log(Severity, const QString& message) override;
 
         void info(const QString &) override;
@@ -58,14 +55,10 @@ class CORE_EXPORT Logger: public ILogger
 
     private:
         const QStringList m_utility;
+        const QString m_utilityName;
         Severity m_severity;
-        std::ostream& m_file;
-        std::mutex& m_outputMutex;
+        LogWriter& m_writer;
         const ILoggerFactory* m_loggerFactory;
-
-        QString currentTime() const;
-        QString currentDate() const;
-        QString severity(Severity) const;
 };
 
 #endif // LOGGER_HPP
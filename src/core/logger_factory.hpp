@@ -20,20 +20,21 @@
 #ifndef LOGGERFACTORY_HPP
 #define LOGGERFACTORY_HPP
 
-#include <fstream>
-#include <mutex>
+#include <memory>
 
 #include "ilogger_factory.hpp"
 #include "ilogger.hpp"
 
 #include "core_export.h"
 
+class LogWriter;
+
 class CORE_EXPORT LoggerFactory: public ILoggerFactory
 {
     public:
         LoggerFactory(const QString &);
         LoggerFactory(const LoggerFactory &) = delete;
-        virtual ~LoggerFactory() = default;
+        virtual ~LoggerFactory();
 
         LoggerFactory& operator=(const LoggerFactory &) = delete;
         void setLogingLevel(ILogger::Severity);
@@ -42,9 +43,8 @@ class CORE_EXPORT LoggerFactory: public ILoggerFactory
         std::unique_ptr<ILogger> get(const QStringList& utility) const override;
 
     private:
-        mutable std::ofstream m_logFile;
+        std::unique_ptr<LogWriter> m_writer;
         ILogger::Severity m_logingLevel;
-        mutable std::mutex m_outputMutex;
 };
 
 #endif // LOGGERFACTORY_HPP
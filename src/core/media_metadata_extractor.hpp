@@ -0,0 +1,61 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEDIA_METADATA_EXTRACTOR_HPP
+#define MEDIA_METADATA_EXTRACTOR_HPP
+
+#include <memory>
+#include <optional>
+
+#include <QSize>
+
+#include "tag.hpp"
+
+#include "core_export.h"
+
+struct ICoreFactoryAccessor;
+
+
+struct MediaMetadata
+{
+    Tag::TagsList tags;
+    std::optional<QSize> size;              // orientation applied
+};
+
+
+// Reads all metadata of media file at once (file is opened and parsed only once)
+class CORE_EXPORT MediaMetadataExtractor
+{
+    public:
+        explicit MediaMetadataExtractor(ICoreFactoryAccessor* coreFactory);
+        MediaMetadataExtractor(const MediaMetadataExtractor &) = delete;
+        MediaMetadataExtractor(MediaMetadataExtractor &&) = delete;
+
+        ~MediaMetadataExtractor();
+
+        MediaMetadataExtractor& operator=(const MediaMetadataExtractor &) = delete;
+        MediaMetadataExtractor& operator=(MediaMetadataExtractor &&) = delete;
+
+        MediaMetadata extract(const QString &) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+};
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTS_POOL_HPP_INCLUDED
+#define OBJECTS_POOL_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * \brief Thread safe pool of reusable objects
+ *
+ * Objects are borrowed with checkout() and returned to pool when Lease goes out of scope.
+ * Pool keeps at most maxIdle unused objects and destroys the ones not used for longer than maxIdleTime.
+ * Objects are never used by two threads at the same time, but may be used by different threads one after another.
+ * Pool must be owned by std::shared_ptr (use create()) so leases may safely outlive it.
+ */
+template<typename T>
+class ObjectsPool: public std::enable_shared_from_this<ObjectsPool<T>>
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Factory = std::function<std::unique_ptr<T>()>;
+
+        class Lease
+        {
+            public:
+                Lease() = default;
+
+                Lease(std::weak_ptr<ObjectsPool> pool, std::unique_ptr<T> object)
+                    : m_pool(pool)
+                    , m_object(std::move(object))
+                {
+
+                }
+
+                Lease(Lease &&) = default;
+                Lease(const Lease &) = delete;
+
+                ~Lease()
+                {
+                    release();
+                }
+
+                Lease& operator=(Lease&& other)
+                {
+                    if (this != &other)
+                    {
+                        release();
+
+                        m_pool = std::move(other.m_pool);
+                        m_object = std::move(other.m_object);
+                    }
+
+                    return *this;
+                }
+
+                Lease& operator=(const Lease &) = delete;
+
+                T* get() const
+                {
+                    return m_object.get();
+                }
+
+                T& operator*() const
+                {
+                    return *m_object;
+                }
+
+                T* operator->() const
+                {
+                    return m_object.get();
+                }
+
+                bool belongsTo(const ObjectsPool* pool) const
+                {
+                    const auto owner = m_pool.lock();
+
+                    return owner.get() == pool;
+                }
+
+                bool orphaned() const
+                {
+                    return m_pool.expired();
+                }
+
+            private:
+                std::weak_ptr<ObjectsPool> m_pool;
+                std::unique_ptr<T> m_object;
+
+                void release()
+                {
+                    if (m_object)
+                    {
+                        // when pool is gone, object is just destroyed
+                        if (auto pool = m_pool.lock())
+                            pool->giveBack(std::move(m_object));
+
+                        m_object.reset();
+                    }
+                }
+        };
+
+        static std::shared_ptr<ObjectsPool> create(Factory factory, std::size_t maxIdle, Clock::duration maxIdleTime)
+        {
+            return std::shared_ptr<ObjectsPool>(new ObjectsPool(factory, maxIdle, maxIdleTime));
+        }
+
+        ObjectsPool(const ObjectsPool &) = delete;
+        ObjectsPool& operator=(const ObjectsPool &) = delete;
+
+        /**
+         * \brief borrow object from pool
+         *
+         * Reuses idle object or constructs a new one when there are no idle objects.
+         */
+        Lease checkout()
+        {
+            std::unique_ptr<T> object;
+
+            {
+                std::lock_guard<std::mutex> lock(m_idleMutex);
+                trimIdle(Clock::now());
+
+                if (m_idle.empty() == false)
+                {
+                    // most recently used object is the most likely one to have warm caches
+                    object = std::move(m_idle.back().object);
+                    m_idle.pop_back();
+                }
+            }
+
+            if (object.get() == nullptr)
+                object = m_factory();
+
+            return Lease(this->weak_from_this(), std::move(object));
+        }
+
+        /**
+         * \brief object bound to calling thread
+         *
+         * Object is borrowed on first use in a thread and returned to pool when thread finishes.
+         * Subsequent calls from the same thread do not lock.
+         */
+        T& threadBound()
+        {
+            thread_local std::vector<Lease> threadLeases;
+
+            // drop leases of pools which do not exist anymore
+            threadLeases.erase(std::remove_if(threadLeases.begin(), threadLeases.end(), [](const Lease& lease)
+            {
+                return lease.orphaned();
+            }), threadLeases.end());
+
+            auto it = std::find_if(threadLeases.begin(), threadLeases.end(), [this](const Lease& lease)
+            {
+                return lease.belongsTo(this);
+            });
+
+            if (it == threadLeases.end())
+            {
+                threadLeases.push_back(checkout());
+                it = std::prev(threadLeases.end());
+            }
+
+            return **it;
+        }
+
+        /**
+         * \brief destroy objects idle for too long
+         */
+        void trim()
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            trimIdle(Clock::now());
+        }
+
+        std::size_t idle() const
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            return m_idle.size();
+        }
+
+    private:
+        struct IdleObject
+        {
+            std::unique_ptr<T> object;
+            Clock::time_point since;
+        };
+
+        mutable std::mutex m_idleMutex;
+        std::deque<IdleObject> m_idle;         // oldest first
+        Factory m_factory;
+        const std::size_t m_maxIdle;
+        const Clock::duration m_maxIdleTime;
+
+        ObjectsPool(Factory factory, std::size_t maxIdle, Clock::duration maxIdleTime)
+            : m_factory(factory)
+            , m_maxIdle(maxIdle)
+            , m_maxIdleTime(maxIdleTime)
+        {
+
+        }
+
+        void giveBack(std::unique_ptr<T> object)
+        {
+            // destroy surplus outside of lock
+            std::deque<IdleObject> surplus;
+
+            {
+                std::lock_guard<std::mutex> lock(m_idleMutex);
+                const auto now = Clock::now();
+
+                m_idle.push_back( {std::move(object), now} );
+
+                trimIdle(now, &surplus);
+            }
+        }
+
+        void trimIdle(Clock::time_point now, std::deque<IdleObject>* removed = nullptr)
+        {
+            while (m_idle.empty() == false &&
+                   (m_idle.size() > m_maxIdle || now - m_idle.front().since > m_maxIdleTime))
+            {
+                if (removed)
+                    removed->push_back(std::move(m_idle.front()));
+
+                m_idle.pop_front();
+            }
+        }
+};
+
+#endif
@@ -31,10 +31,13 @@ class CORE_EXPORT OrientedImage
     public:
         OrientedImage();
         OrientedImage(IExifReader &, const QString& path);
+        OrientedImage(IExifReader &, const QString& path, const QSize& size);      // load image scaled to given size (orientation applied)
 
         QImage get() const;
         const QImage* operator->() const;
 
+        static QSize size(IExifReader &, const QString& path);                   // size of image with orientation applied (image is not decoded)
+
     private:
         QImage m_oriented;
 };
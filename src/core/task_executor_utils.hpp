@@ -2,6 +2,8 @@
 #ifndef TASK_EXECUTOR_UTILS
 #define TASK_EXECUTOR_UTILS
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <mutex>
 #include <future>
@@ -116,6 +118,61 @@ QFuture<R> runOn(ITaskExecutor& executor, Callable&& callable, const std::string
 }
 
 
+// Call callable(i) for each i in range [0, count) using executor's heavy workers.
+// Calling thread takes part in work, so it is safe to use it inside of executor's task
+// (even if there are no free workers). Returns when all items were processed.
+// Callable must not throw.
+template<typename Callable>
+void parallelFor(ITaskExecutor& executor, std::size_t count, Callable&& callable, const std::string& taskName)
+{
+    struct State
+    {
+        std::atomic<std::size_t> next = 0;
+        std::size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    auto state = std::make_shared<State>();
+
+    // Helpers starting after all items were taken do not touch callable,
+    // so it is safe to capture it by reference.
+    auto work = [state, count, &callable]()
+    {
+        std::size_t processed = 0;
+
+        for (std::size_t i = state->next++; i < count; i = state->next++)
+        {
+            callable(i);
+            processed++;
+        }
+
+        if (processed > 0)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done += processed;
+
+            if (state->done == count)
+                state->finished.notify_all();
+        }
+    };
+
+    const std::size_t workers = static_cast<std::size_t>(std::max(executor.heavyWorkers(), 1));
+    const std::size_t helpers = std::min(workers - 1, count > 0? count - 1: 0);
+
+    for (std::size_t i = 0; i < helpers; i++)
+        runOn(executor, work, taskName);
+
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, count]
+    {
+        return state->done == count;
+    });
+}
+
+
 // Helper class.
 // A subqueue for ITaskExecutor.
 // Its purpose is to have a queue of tasks to be executed by executor
@@ -130,6 +187,7 @@ class CORE_EXPORT TasksQueue final: public ITaskExecutor
         };
 
         TasksQueue(ITaskExecutor *, Mode = Mode::Fifo);
+        TasksQueue(ITaskExecutor *, int maxTasks, Mode = Mode::Fifo);      // limit number of tasks passed to executor at once
         ~TasksQueue();
 
         void push(std::unique_ptr<ITaskExecutor::ITask> &&);
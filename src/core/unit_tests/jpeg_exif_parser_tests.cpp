@@ -0,0 +1,190 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "implementation/jpeg_exif_parser.hpp"
+
+
+namespace
+{
+    // helper for building little endian TIFF structures
+    struct Bytes: std::vector<unsigned char>
+    {
+        Bytes& u8(std::uint8_t v)
+        {
+            push_back(v);
+            return *this;
+        }
+
+        Bytes& u16le(std::uint16_t v)
+        {
+            return u8(v & 0xff).u8(v >> 8);
+        }
+
+        Bytes& u16be(std::uint16_t v)
+        {
+            return u8(v >> 8).u8(v & 0xff);
+        }
+
+        Bytes& u32le(std::uint32_t v)
+        {
+            return u16le(v & 0xffff).u16le(v >> 16);
+        }
+
+        Bytes& str(const std::string& s)
+        {
+            insert(end(), s.begin(), s.end());
+            return *this;
+        }
+
+        Bytes& append(const Bytes& other)
+        {
+            insert(end(), other.begin(), other.end());
+            return *this;
+        }
+    };
+
+    Bytes tiff()
+    {
+        Bytes t;
+        const std::string date = "2021:05:04 12:34:56";
+
+        t.str("II").u16le(42).u32le(8);
+
+        // IFD0 at 8: 2 entries
+        t.u16le(2);
+        t.u16le(0x0112).u16le(3).u32le(1).u16le(6).u16le(0);      // Orientation = 6
+        t.u16le(0x8769).u16le(4).u32le(1).u32le(38);              // Exif IFD at 38
+        t.u32le(0);                                                // next IFD
+
+        // Exif IFD at 38: 4 entries
+        t.u16le(4);
+        t.u16le(0x9003).u16le(2).u32le(date.size() + 1).u32le(92); // DateTimeOriginal at 92
+        t.u16le(0x9204).u16le(10).u32le(1).u32le(112);             // ExposureBias at 112
+        t.u16le(0xA002).u16le(4).u32le(1).u32le(4000);             // PixelXDimension
+        t.u16le(0xA003).u16le(3).u32le(1).u16le(3000).u16le(0);    // PixelYDimension
+        t.u32le(0);
+
+        // values
+        t.str(date).u8(0);                                         // 92 - 111
+        t.u32le(static_cast<std::uint32_t>(-1)).u32le(3);          // 112
+
+        return t;
+    }
+
+    Bytes sonyTiff(const std::string& makerNoteHeader)
+    {
+        Bytes t;
+
+        t.str("II").u16le(42).u32le(8);
+
+        // IFD0 at 8: 1 entry
+        t.u16le(1);
+        t.u16le(0x8769).u16le(4).u32le(1).u32le(26);              // Exif IFD at 26
+        t.u32le(0);
+
+        // Exif IFD at 26: 1 entry
+        t.u16le(1);
+        t.u16le(0x927C).u16le(7).u32le(30).u32le(44);             // MakerNote at 44
+        t.u32le(0);
+
+        // maker note at 44: header followed by IFD
+        t.str(makerNoteHeader);
+        t.u16le(1);
+        t.u16le(0xB04A).u16le(3).u32le(1).u16le(2).u16le(0);      // SequenceNumber = 2
+        t.u32le(0);
+
+        return t;
+    }
+
+    Bytes jpeg(const Bytes& tiffData)
+    {
+        Bytes j;
+        j.u8(0xFF).u8(0xD8);
+
+        if (tiffData.empty() == false)
+        {
+            j.u8(0xFF).u8(0xE1).u16be(static_cast<std::uint16_t>(tiffData.size() + 8)).str(std::string("Exif\0\0", 6));
+            j.append(tiffData);
+        }
+
+        // SOF0: precision, height, width, components
+        j.u8(0xFF).u8(0xC0).u16be(8 + 3).u8(8).u16be(3000).u16be(4000).u8(1).u8(1).u8(0x11).u8(0);
+
+        // SOS - parsing stops here
+        j.u8(0xFF).u8(0xDA).u16be(2);
+
+        return j;
+    }
+}
+
+
+TEST(JpegExifParserTest, notJpeg)
+{
+    const std::string png = "\x89PNG\r\n\x1a\n";
+
+    EXPECT_FALSE(JpegExifParser::parse(reinterpret_cast<const unsigned char *>(png.data()), png.size()).has_value());
+}
+
+
+TEST(JpegExifParserTest, jpegWithoutExif)
+{
+    const Bytes data = jpeg({});
+    const auto result = JpegExifParser::parse(data.data(), data.size());
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(result->hasExif);
+    EXPECT_EQ(result->width, 4000);
+    EXPECT_EQ(result->height, 3000);
+    EXPECT_FALSE(result->orientation.has_value());
+}
+
+
+TEST(JpegExifParserTest, exifTags)
+{
+    const Bytes data = jpeg(tiff());
+    const auto result = JpegExifParser::parse(data.data(), data.size());
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->hasExif);
+    EXPECT_EQ(result->orientation, "6");
+    EXPECT_EQ(result->dateTimeOriginal, "2021:05:04 12:34:56");
+    EXPECT_EQ(result->exposureBias, "-1/3");
+    EXPECT_EQ(result->pixelXDimension, "4000");
+    EXPECT_EQ(result->pixelYDimension, "3000");
+    EXPECT_EQ(result->width, 4000);
+    EXPECT_EQ(result->height, 3000);
+}
+
+
+TEST(JpegExifParserTest, sonySequenceNumber)
+{
+    const Bytes data = jpeg(sonyTiff(std::string("SONY DSC \0\0\0", 12)));
+    const auto result = JpegExifParser::parse(data.data(), data.size());
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->sequenceNumber, "2");
+}
+
+
+TEST(JpegExifParserTest, otherMakerNotesAreIgnored)
+{
+    const Bytes data = jpeg(sonyTiff(std::string("Nikon\0\2\0\0\0\0\0", 12)));
+    const auto result = JpegExifParser::parse(data.data(), data.size());
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->hasExif);
+    EXPECT_FALSE(result->sequenceNumber.has_value());
+}
+
+
+TEST(JpegExifParserTest, truncatedData)
+{
+    const Bytes data = jpeg(tiff());
+
+    // any truncation must be handled gracefully
+    for (std::size_t size = 0; size < data.size(); size++)
+        JpegExifParser::parse(data.data(), size);
+}
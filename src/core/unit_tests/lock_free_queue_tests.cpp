@@ -0,0 +1,93 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "lock_free_queue.hpp"
+
+
+TEST(LockFreeQueueTest, capacityIsRoundedUpToPowerOfTwo)
+{
+    const LockFreeQueue<int> queue(5);
+
+    EXPECT_EQ(queue.capacity(), 8);
+}
+
+
+TEST(LockFreeQueueTest, valuesArePoppedInPushOrder)
+{
+    LockFreeQueue<std::string> queue(4);
+
+    EXPECT_TRUE(queue.push("a"));
+    EXPECT_TRUE(queue.push("b"));
+    EXPECT_TRUE(queue.push("c"));
+
+    std::string value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, "a");
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, "b");
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, "c");
+    EXPECT_FALSE(queue.pop(value));
+}
+
+
+TEST(LockFreeQueueTest, pushFailsWhenQueueIsFull)
+{
+    LockFreeQueue<std::string> queue(2);
+
+    EXPECT_TRUE(queue.push("a"));
+    EXPECT_TRUE(queue.push("b"));
+
+    std::string rejected = "c";
+    EXPECT_FALSE(queue.push(std::move(rejected)));
+    EXPECT_EQ(rejected, "c");               // not consumed
+
+    std::string value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_TRUE(queue.push(std::move(rejected)));
+}
+
+
+TEST(LockFreeQueueTest, valuesFromManyProducersAreDeliveredOnce)
+{
+    constexpr int producers = 4;
+    constexpr int valuesPerProducer = 10000;
+
+    LockFreeQueue<int> queue(64);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < valuesPerProducer; i++)
+            {
+                int value = p * valuesPerProducer + i;
+
+                while (queue.push(std::move(value)) == false)
+                    std::this_thread::yield();
+            }
+        });
+
+    std::vector<int> received(producers * valuesPerProducer, 0);
+
+    for (int count = 0; count < producers * valuesPerProducer;)
+    {
+        int value = 0;
+
+        if (queue.pop(value))
+        {
+            received[value]++;
+            count++;
+        }
+        else
+            std::this_thread::yield();
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    EXPECT_THAT(received, testing::Each(1));
+}
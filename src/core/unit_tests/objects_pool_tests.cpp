@@ -0,0 +1,124 @@
+#include <thread>
+
+#include <gmock/gmock.h>
+
+#include "objects_pool.hpp"
+
+
+namespace
+{
+    struct Counter
+    {
+        int created = 0;
+
+        std::unique_ptr<int> operator()()
+        {
+            return std::make_unique<int>(created++);
+        }
+    };
+}
+
+
+TEST(ObjectsPoolTest, objectIsReusedAfterLeaseIsReleased)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::hours(1));
+
+    const int* first = nullptr;
+
+    {
+        auto lease = pool->checkout();
+        first = lease.get();
+    }
+
+    EXPECT_EQ(pool->idle(), 1);
+
+    auto lease = pool->checkout();
+    EXPECT_EQ(lease.get(), first);
+    EXPECT_EQ(counter.created, 1);
+    EXPECT_EQ(pool->idle(), 0);
+}
+
+
+TEST(ObjectsPoolTest, concurrentLeasesGetDifferentObjects)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::hours(1));
+
+    auto lease1 = pool->checkout();
+    auto lease2 = pool->checkout();
+
+    EXPECT_NE(lease1.get(), lease2.get());
+    EXPECT_EQ(counter.created, 2);
+}
+
+
+TEST(ObjectsPoolTest, numberOfIdleObjectsIsBounded)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 2, std::chrono::hours(1));
+
+    {
+        auto lease1 = pool->checkout();
+        auto lease2 = pool->checkout();
+        auto lease3 = pool->checkout();
+    }
+
+    EXPECT_EQ(pool->idle(), 2);
+}
+
+
+TEST(ObjectsPoolTest, objectsIdleForTooLongAreTrimmed)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::milliseconds(0));
+
+    {
+        auto lease = pool->checkout();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pool->trim();
+
+    EXPECT_EQ(pool->idle(), 0);
+}
+
+
+TEST(ObjectsPoolTest, leaseMayOutliveThePool)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::hours(1));
+
+    auto lease = pool->checkout();
+    pool.reset();
+
+    EXPECT_TRUE(lease.orphaned());
+    EXPECT_EQ(*lease, 0);
+}
+
+
+TEST(ObjectsPoolTest, threadBoundObjectIsStableWithinThread)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::hours(1));
+
+    int& first = pool->threadBound();
+    int& second = pool->threadBound();
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(counter.created, 1);
+}
+
+
+TEST(ObjectsPoolTest, threadBoundObjectReturnsToPoolWhenThreadFinishes)
+{
+    Counter counter;
+    auto pool = ObjectsPool<int>::create(std::ref(counter), 4, std::chrono::hours(1));
+
+    std::thread([&pool]{ pool->threadBound(); }).join();
+    EXPECT_EQ(pool->idle(), 1);
+
+    // next thread reuses object of finished one
+    std::thread([&pool]{ pool->threadBound(); }).join();
+    EXPECT_EQ(counter.created, 1);
+}
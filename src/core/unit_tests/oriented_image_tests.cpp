@@ -2,22 +2,38 @@
 #include <gmock/gmock.h>
 
 #include <QImage>
+#include <QTemporaryDir>
 
 #include <unit_tests_utils/mock_exif_reader.hpp>
 #include "oriented_image.hpp"
 
+using testing::Return;
 
-TEST(OrientedImageTest, constructor)
+
+TEST(OrientedImageTest, sizeWithoutRotation)
 {
-    // TODO: build issues...
-    //       probably broken by https://gcc.gnu.org/bugzilla/show_bug.cgi?id=90415
+    QTemporaryDir dir;
+    const QString path = dir.filePath("image.png");
+    ASSERT_TRUE(QImage(40, 20, QImage::Format_RGB32).save(path));
+
+    MockExifReader exif;
+    EXPECT_CALL(exif, get(path, IExifReader::TagType::Orientation)).WillRepeatedly(Return(std::any(1)));
 
-    /*
-    OrientedImage();
+    EXPECT_EQ(OrientedImage::size(exif, path), QSize(40, 20));
+    EXPECT_EQ(OrientedImage(exif, path, QSize(20, 10))->size(), QSize(20, 10));
+}
+
+
+TEST(OrientedImageTest, sizeWithRotation)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("image.png");
+    ASSERT_TRUE(QImage(40, 20, QImage::Format_RGB32).save(path));
 
-    QImage qimage(10, 100, QImage::Format_RGB32);
     MockExifReader exif;
+    EXPECT_CALL(exif, get(path, IExifReader::TagType::Orientation)).WillRepeatedly(Return(std::any(6)));
 
-    OrientedImage(&exif, qimage);
-    */
+    // size and scaled image are expected to be rotated by 90 degrees
+    EXPECT_EQ(OrientedImage::size(exif, path), QSize(20, 40));
+    EXPECT_EQ(OrientedImage(exif, path, QSize(10, 20))->size(), QSize(10, 20));
 }
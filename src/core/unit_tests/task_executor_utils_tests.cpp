@@ -0,0 +1,108 @@
+#include <atomic>
+#include <set>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+#include <unit_tests_utils/fake_task_executor.hpp>
+#include "task_executor_utils.hpp"
+
+
+namespace
+{
+    // executes each task in a separate thread
+    class ThreadedTaskExecutor: public ITaskExecutor
+    {
+        public:
+            ~ThreadedTaskExecutor()
+            {
+                for (auto& thread: m_threads)
+                    thread.join();
+            }
+
+            void add(std::unique_ptr<ITask>&& task) override
+            {
+                m_threads.emplace_back([t = std::shared_ptr<ITask>(std::move(task))]
+                {
+                    t->perform();
+                });
+            }
+
+            void addLight(std::unique_ptr<ITask>&& task) override
+            {
+                add(std::move(task));
+            }
+
+            int heavyWorkers() const override
+            {
+                return 4;
+            }
+
+        private:
+            std::vector<std::thread> m_threads;
+    };
+}
+
+
+TEST(ParallelForTest, eachItemIsProcessedOnce)
+{
+    ThreadedTaskExecutor executor;
+    std::vector<std::atomic<int>> visits(1000);
+
+    parallelFor(executor, visits.size(), [&visits](std::size_t i)
+    {
+        visits[i]++;
+    }, "test");
+
+    for (const auto& v: visits)
+        EXPECT_EQ(v, 1);
+}
+
+
+TEST(ParallelForTest, emptyRange)
+{
+    ThreadedTaskExecutor executor;
+    int calls = 0;
+
+    parallelFor(executor, 0, [&calls](std::size_t)
+    {
+        calls++;
+    }, "test");
+
+    EXPECT_EQ(calls, 0);
+}
+
+
+TEST(ParallelForTest, workIsDoneWhenExecutorHasNoFreeWorkers)
+{
+    // executor which never runs tasks (all workers busy)
+    struct BusyExecutor: ITaskExecutor
+    {
+        void add(std::unique_ptr<ITask> &&) override {}
+        void addLight(std::unique_ptr<ITask> &&) override {}
+        int heavyWorkers() const override { return 4; }
+    } executor;
+
+    std::set<std::size_t> processed;
+
+    parallelFor(executor, 10, [&processed](std::size_t i)
+    {
+        processed.insert(i);
+    }, "test");
+
+    EXPECT_EQ(processed.size(), 10);
+}
+
+
+TEST(ParallelForTest, synchronousExecutor)
+{
+    FakeTaskExecutor executor;
+    std::vector<int> visits(10, 0);
+
+    parallelFor(executor, visits.size(), [&visits](std::size_t i)
+    {
+        visits[i]++;
+    }, "test");
+
+    EXPECT_THAT(visits, testing::Each(1));
+}
@@ -1,7 +1,12 @@
+#include <algorithm>
+#include <map>
+
 
 #include <QFileInfo>
 
 #include "memory_backend.hpp"
+#include "core/tags_utils.hpp"
+#include "database/general_flags.hpp"
 #include "database/project_info.hpp"
 
 
@@ -25,6 +30,42 @@ namespace
 
         return (is_less? -1: 0) + (is_greater? 1: 0);
     }
+
+    // in-memory counterpart of SqlFilterQueryGenerator's FilterPhotosWithTag
+    bool tag_matches(const Photo::Data& photo, const Database::FilterPhotosWithTag& filter)
+    {
+        using ValueMode = Database::FilterPhotosWithTag::ValueMode;
+
+        const auto it = photo.tags.find(filter.tagType);
+        const bool hasTag = it != photo.tags.end() && it->second.type() != Tag::ValueType::Empty;
+
+        // no value to compare with: only presence of tag matters (includeEmpty does not change that)
+        if (filter.tagValue.type() == Tag::ValueType::Empty)
+            return hasTag;
+
+        if (hasTag == false && filter.includeEmpty == false)
+            return false;
+
+        // when empty values are included, missing tag is compared as an empty string
+        // and values are compared as strings. Otherwise rating is compared as a number.
+        const QString value = hasTag? it->second.rawValue(): QString("");
+        const QString expected = filter.tagValue.rawValue();
+        const bool numeric = filter.includeEmpty == false && filter.tagType == TagTypes::Rating;
+        const int cmp = numeric?
+            (value.toInt() > expected.toInt()) - (value.toInt() < expected.toInt()):
+            QString::compare(value, expected);
+
+        switch (filter.valueMode)
+        {
+            case ValueMode::Equal:          return cmp == 0;
+            case ValueMode::Less:           return cmp < 0;
+            case ValueMode::LessOrEqual:    return cmp <= 0;
+            case ValueMode::Greater:        return cmp > 0;
+            case ValueMode::GreaterOrEqual: return cmp >= 0;
+        }
+
+        return false;
+    }
 }
 
 
@@ -73,6 +114,10 @@ namespace Database
 
             data.apply(delta);
 
+            // photo's timestamp has changed
+            if (delta.has(Photo::Field::Tags) && Tag::timestamp(it->tags) != Tag::timestamp(delta.get<Photo::Field::Tags>()))
+                m_seriesFeatures.erase(delta.getId());
+
             it = m_photos.erase(it);
             m_photos.insert(it, data);
 
@@ -85,12 +130,15 @@ namespace Database
     }
 
 
-    std::vector<TagValue> MemoryBackend::listTagValues(const TagTypes& type, const Filter &)
+    std::vector<TagValue> MemoryBackend::listTagValues(const TagTypes& type, const Filter& filter)
     {
         std::set<TagValue> values;
 
         for(const auto& photo: m_photos)
         {
+            if (matches(photo, filter) == false)
+                continue;
+
             auto it = photo.tags.find(type);
             if (it != photo.tags.end() && it->second.type() != Tag::ValueType::Empty)
                 values.insert(it->second);
@@ -105,6 +153,21 @@ namespace Database
     }
 
 
+    std::vector<std::pair<TagValue, int>> MemoryBackend::countTagValues(const TagTypes& type)
+    {
+        std::map<TagValue, int> values;
+
+        for(const auto& photo: m_photos)
+        {
+            auto it = photo.tags.find(type);
+            if (it != photo.tags.end() && it->second.type() != Tag::ValueType::Empty)
+                values[it->second]++;
+        }
+
+        return std::vector<std::pair<TagValue, int>>(values.begin(), values.end());
+    }
+
+
     Photo::Data MemoryBackend::getPhoto(const Photo::Id& id)
     {
         auto it = m_photos.find(id);
@@ -150,6 +213,14 @@ namespace Database
         if (fields.contains(Photo::Field::GroupInfo))
             delta.insert<Photo::Field::GroupInfo>(data.groupInfo);
 
+        if (fields.contains(Photo::Field::PHash))
+        {
+            const auto& phash = data.phash;
+
+            if (phash.valid())
+                delta.insert<Photo::Field::PHash>(phash);
+        }
+
         if (fields.contains(Photo::Field::Flags))
             delta.insert<Photo::Field::Flags>(data.flags);
 
@@ -157,15 +228,63 @@ namespace Database
     }
 
 
-    int MemoryBackend::getPhotosCount(const Filter &)
+    std::vector<Photo::Data> MemoryBackend::getPhotos(const std::vector<Photo::Id>& ids)
     {
-        return 0;
+        std::vector<Photo::Data> photos;
+        photos.reserve(ids.size());
+
+        for(const auto& id: ids)
+        {
+            auto it = m_photos.find(id);
+
+            if (it != m_photos.end())
+                photos.push_back(*it);
+        }
+
+        return photos;
+    }
+
+
+    int MemoryBackend::getPhotosCount(const Filter& filter)
+    {
+        const auto count = std::count_if(m_photos.begin(), m_photos.end(), [this, &filter](const Photo::Data& photo)
+        {
+            return matches(photo, filter);
+        });
+
+        return static_cast<int>(count);
+    }
+
+
+    DateHistogram MemoryBackend::getDateHistogram(const Filter& filter, DateHistogram::Granularity granularity)
+    {
+        DateHistogram histogram(granularity);
+
+        for(const auto& photo: m_photos)
+        {
+            if (matches(photo, filter) == false)
+                continue;
+
+            auto it = photo.tags.find(TagTypes::Date);
+            histogram.add(it == photo.tags.end()? QDate(): it->second.getDate());
+        }
+
+        return histogram;
     }
 
 
     void MemoryBackend::set(const Photo::Id &id, const QString& name, int value)
     {
         m_flags[id][name] = value;
+
+        emit generalFlagChanged(id, name, value);
+    }
+
+
+    void MemoryBackend::set(const QString& name, const std::map<Photo::Id, int>& values)
+    {
+        for (const auto& [id, value]: values)
+            set(id, name, value);
     }
 
 
@@ -195,6 +314,23 @@ namespace Database
     }
 
 
+    void MemoryBackend::storeFaces(const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>>& faces)
+    {
+        auto& peopleAccessor = peopleInformationAccessor();
+
+        for (const auto& [id, photoFaces]: faces)
+        {
+            for (const auto& [rect, fingerprint]: photoFaces)
+            {
+                const PersonFingerprint::Id fid = peopleAccessor.store(PersonFingerprint(fingerprint));
+                peopleAccessor.store(PersonInfo(Person::Id(), id, fid, rect));
+            }
+
+            set(id, CommonGeneralFlags::FacesRecognized, 1);
+        }
+    }
+
+
     BackendStatus MemoryBackend::init(const ProjectInfo& prjInfo)
     {
         BackendStatus status;
@@ -236,6 +372,12 @@ namespace Database
     }
 
 
+    ISeriesCacheOperator& MemoryBackend::seriesCacheOperator()
+    {
+        return *this;
+    }
+
+
     std::vector<PersonName> MemoryBackend::listPeople()
     {
         std::vector<PersonName> result;
@@ -260,6 +402,20 @@ namespace Database
     }
 
 
+    std::vector<PersonInfo> MemoryBackend::listPeople(const std::vector<Photo::Id>& ids)
+    {
+        const std::set<Photo::Id> photos(ids.begin(), ids.end());
+        std::vector<PersonInfo> people;
+
+        std::copy_if(m_peopleInfo.cbegin(), m_peopleInfo.cend(), std::back_inserter(people), [&photos](const auto& info)
+        {
+            return photos.contains(info.ph_id);
+        });
+
+        return people;
+    }
+
+
     PersonName MemoryBackend::person(const Person::Id& id)
     {
         auto it = m_peopleNames.find(id);
@@ -485,17 +641,93 @@ namespace Database
     }
 
 
-    std::vector<Photo::Id> MemoryBackend::getPhotos(const Filter &)
+    std::vector<Photo::Id> MemoryBackend::getPhotos(const Filter& filter)
     {
         std::vector<Photo::Id> ids;
 
         for(const auto& photo: m_photos)
-            ids.push_back(photo.id);
+            if (matches(photo, filter))
+                ids.push_back(photo.id);
 
         return ids;
     }
 
 
+    std::vector<std::vector<Photo::Id>> MemoryBackend::findDuplicates(const Filter& filter)
+    {
+        std::map<Photo::Sha256sum, std::vector<Photo::Id>> photosBySha256;
+
+        for(const auto& photo: m_photos)
+            if (photo.sha256Sum.isEmpty() == false && matches(photo, filter))
+                photosBySha256[photo.sha256Sum].push_back(photo.id);
+
+        std::vector<std::vector<Photo::Id>> duplicates;
+
+        for(auto& [sha256, ids]: photosBySha256)
+            if (ids.size() > 1)
+                duplicates.push_back(std::move(ids));
+
+        return duplicates;
+    }
+
+
+    std::vector<SeriesFeatures> MemoryBackend::listFeatures()
+    {
+        std::vector<SeriesFeatures> features;
+        features.reserve(m_seriesFeatures.size());
+
+        for (const auto& [id, f]: m_seriesFeatures)
+            features.push_back(f);
+
+        return features;
+    }
+
+
+    bool MemoryBackend::store(const std::vector<SeriesFeatures>& features)
+    {
+        for (const auto& f: features)
+            m_seriesFeatures[f.id] = f;
+
+        return true;
+    }
+
+
+    bool MemoryBackend::dropFeatures(const std::vector<Photo::Id>& ids)
+    {
+        for (const auto& id: ids)
+            m_seriesFeatures.erase(id);
+
+        return true;
+    }
+
+
+    std::vector<SeriesWindow> MemoryBackend::listWindows()
+    {
+        std::vector<SeriesWindow> windows;
+        windows.reserve(m_seriesWindows.size());
+
+        for (const auto& [id, window]: m_seriesWindows)
+            windows.push_back(window);
+
+        return windows;
+    }
+
+
+    bool MemoryBackend::replaceWindows(const std::vector<int>& obsolete, const std::vector<SeriesWindow>& windows)
+    {
+        for (const int id: obsolete)
+            m_seriesWindows.erase(id);
+
+        for (SeriesWindow window: windows)
+        {
+            window.id = m_nextSeriesWindow++;
+            m_seriesWindows.emplace(window.id, window);
+        }
+
+        return true;
+    }
+
+
     Photo::Id MemoryBackend::getIdFor(const Photo::Data& d)
     {
         return d.id;
@@ -549,4 +781,83 @@ namespace Database
         }
     }
 
+
+    bool MemoryBackend::matches(const Photo::Data& photo, const Filter& filter) const
+    {
+        return std::visit([this, &photo](const auto& f)
+        {
+            using F = std::decay_t<decltype(f)>;
+
+            if constexpr (std::is_same_v<F, EmptyFilter>)
+                return true;
+            else if constexpr (std::is_same_v<F, GroupFilter>)
+                return std::all_of(f.filters.begin(), f.filters.end(), [this, &photo](const Filter& sub)
+                {
+                    return matches(photo, sub);
+                });
+            else if constexpr (std::is_same_v<F, FilterPhotosWithTag>)
+                return tag_matches(photo, f);
+            else if constexpr (std::is_same_v<F, FilterPhotosWithFlags>)
+            {
+                auto flag_matches = [&photo](const auto& flag)
+                {
+                    const auto it = photo.flags.find(flag.first);
+                    return (it == photo.flags.end()? 0: it->second) == flag.second;
+                };
+
+                return f.mode == FilterPhotosWithFlags::Mode::And?
+                    std::all_of(f.flags.begin(), f.flags.end(), flag_matches):
+                    std::any_of(f.flags.begin(), f.flags.end(), flag_matches);
+            }
+            else if constexpr (std::is_same_v<F, FilterPhotosWithSha256>)
+                return photo.sha256Sum == f.sha256;
+            else if constexpr (std::is_same_v<F, FilterNotMatchingFilter>)
+                return matches(photo, *f.filter.get()) == false;
+            else if constexpr (std::is_same_v<F, FilterPhotosWithId>)
+                return photo.id == f.filter;
+            else if constexpr (std::is_same_v<F, FilterPhotosMatchingExpression>)
+                return std::any_of(f.expression.begin(), f.expression.end(), [&photo](const SearchExpressionEvaluator::Filter& condition)
+                {
+                    return std::any_of(photo.tags.begin(), photo.tags.end(), [&condition](const auto& tag)
+                    {
+                        const QString value = tag.second.rawValue();
+                        return condition.m_exact? value == condition.m_value: value.contains(condition.m_value);
+                    });
+                });
+            else if constexpr (std::is_same_v<F, FilterPhotosWithPath>)
+                return photo.path == f.path;
+            else if constexpr (std::is_same_v<F, FilterPhotosWithRole>)
+            {
+                switch (f.m_role)
+                {
+                    case FilterPhotosWithRole::Role::Regular:             return photo.groupInfo.role == GroupInfo::Role::None;
+                    case FilterPhotosWithRole::Role::GroupRepresentative: return photo.groupInfo.role == GroupInfo::Role::Representative;
+                    case FilterPhotosWithRole::Role::GroupMember:         return photo.groupInfo.role == GroupInfo::Role::Member;
+                }
+
+                return false;
+            }
+            else if constexpr (std::is_same_v<F, FilterPhotosWithPerson>)
+                return std::any_of(m_peopleInfo.begin(), m_peopleInfo.end(), [&photo, &f](const PersonInfo& pi)
+                {
+                    return pi.ph_id == photo.id && pi.p_id == f.person_id;
+                });
+            else if constexpr (std::is_same_v<F, FilterPhotosWithGeneralFlag>)
+            {
+                int value = 0;                  // missing flag is treated as 0, as in sql backend
+                const auto it = m_flags.find(photo.id);
+
+                if (it != m_flags.end())
+                {
+                    const auto f_it = it->second.find(f.name);
+
+                    if (f_it != it->second.end())
+                        value = f_it->second;
+                }
+
+                return value == f.value;
+            }
+        }, filter);
+    }
+
 }
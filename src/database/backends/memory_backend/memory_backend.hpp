@@ -7,6 +7,7 @@
 #include "database/ibackend.hpp"
 #include "database/igroup_operator.hpp"
 #include "database/iphoto_operator.hpp"
+#include "database/iseries_cache_operator.hpp"
 
 #include "database_memory_backend_export.h"
 
@@ -21,30 +22,38 @@ namespace Database
                APeopleInformationAccessor,
                APhotoChangeLogOperator,
                IGroupOperator,
-               IPhotoOperator
+               IPhotoOperator,
+               ISeriesCacheOperator
     {
         public:
             // IBackend interface
             bool addPhotos(std::vector<Photo::DataDelta>& photos) override;
             bool update(const std::vector<Photo::DataDelta> &) override;
             std::vector<TagValue> listTagValues(const TagTypes &, const Filter &) override;
+            std::vector<std::pair<TagValue, int>> countTagValues(const TagTypes &) override;
             Photo::Data getPhoto(const Photo::Id &) override;
             Photo::DataDelta getPhotoDelta(const Photo::Id &, const std::set<Photo::Field> &) override;
+            std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) override;
             int getPhotosCount(const Filter &) override;
+            DateHistogram getDateHistogram(const Filter &, DateHistogram::Granularity) override;
             void set(const Photo::Id& id, const QString& name, int value) override;
+            void set(const QString& name, const std::map<Photo::Id, int>& values) override;
             std::optional<int> get(const Photo::Id& id, const QString& name) override;
             std::vector<Photo::Id> markStagedAsReviewed() override;
+            void storeFaces(const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>> &) override;
             BackendStatus init(const ProjectInfo &) override;
             void closeConnections() override;
             IGroupOperator& groupOperator() override;
             IPhotoOperator& photoOperator() override;
             IPhotoChangeLogOperator& photoChangeLogOperator() override;
             IPeopleInformationAccessor& peopleInformationAccessor() override;
+            ISeriesCacheOperator& seriesCacheOperator() override;
 
         private:
             // APeopleInformationAccessor interface
             std::vector<PersonName> listPeople() override;
             std::vector<PersonInfo> listPeople(const Photo::Id &) override;
+            std::vector<PersonInfo> listPeople(const std::vector<Photo::Id> &) override;
             PersonName person(const Person::Id &) override;
             std::vector<PersonFingerprint> fingerprintsFor(const Person::Id &) override;
             std::map<PersonInfo::Id, PersonFingerprint> fingerprintsFor(const std::vector<PersonInfo::Id>& id) override;
@@ -68,6 +77,14 @@ namespace Database
             bool removePhotos(const Filter &) override;
             std::vector<Photo::Id> onPhotos(const Filter &, const Action &) override;
             std::vector<Photo::Id> getPhotos(const Filter &) override;
+            std::vector<std::vector<Photo::Id>> findDuplicates(const Filter &) override;
+
+            // ISeriesCacheOperator interface
+            std::vector<SeriesFeatures> listFeatures() override;
+            bool store(const std::vector<SeriesFeatures> &) override;
+            bool dropFeatures(const std::vector<Photo::Id> &) override;
+            std::vector<SeriesWindow> listWindows() override;
+            bool replaceWindows(const std::vector<int> &, const std::vector<SeriesWindow> &) override;
 
             //
             typedef std::map<QString, int> Flags;
@@ -79,6 +96,7 @@ namespace Database
             static PersonInfo::Id getIdFor(const PersonInfo& pn);
 
             void onPhotos(std::vector<Photo::Data> &, const Action &) const;
+            bool matches(const Photo::Data &, const Filter &) const;
 
             template<typename T, typename IdT>
             struct IdComparer
@@ -103,6 +121,8 @@ namespace Database
 
             std::map<Photo::Id, Flags> m_flags;
             std::map<Group::Id, GroupData> m_groups;
+            std::map<Photo::Id, SeriesFeatures> m_seriesFeatures;
+            std::map<int, SeriesWindow> m_seriesWindows;
             std::set<Photo::Data, IdComparer<Photo::Data, Photo::Id>> m_photos;
             std::set<PersonName, IdComparer<PersonName, Person::Id>> m_peopleNames;
             std::set<PersonInfo, IdComparer<PersonInfo, PersonInfo::Id>> m_peopleInfo;
@@ -112,6 +132,7 @@ namespace Database
             int m_nextPersonName = 0;
             int m_nextGroup = 0;
             int m_nextPersonInfo = 0;
+            int m_nextSeriesWindow = 0;
     };
 }
 
@@ -75,9 +75,22 @@ namespace Database
 
     std::vector<PersonInfo> PeopleInformationAccessor::listPeople(const Photo::Id& ph_id )
     {
-        const QString findQuery = QString("SELECT %1.id, %1.person_id, %1.location, %1.fingerprint_id FROM %1 WHERE %1.photo_id = %2")
+        return listPeople(std::vector<Photo::Id>{ph_id});
+    }
+
+
+    std::vector<PersonInfo> PeopleInformationAccessor::listPeople(const std::vector<Photo::Id>& ph_ids)
+    {
+        if (ph_ids.empty())
+            return {};
+
+        QStringList ids_list;
+        for(const auto& id: ph_ids)
+            ids_list.append(QString::number(id));
+
+        const QString findQuery = QString("SELECT %1.id, %1.person_id, %1.location, %1.fingerprint_id, %1.photo_id FROM %1 WHERE %1.photo_id IN(%2)")
                                     .arg(TAB_PEOPLE)
-                                    .arg(ph_id);
+                                    .arg(ids_list.join(","));
 
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
@@ -102,6 +115,8 @@ namespace Database
                             PersonFingerprint::Id():
                             PersonFingerprint::Id(query.value(3).toInt());
 
+                const Photo::Id ph_id(query.value(4).toInt());
+
                 QRect location;
 
                 if (query.isNull(2) == false)
@@ -106,8 +106,16 @@ namespace Database
             QString("DELETE FROM " TAB_GEOMETRY          " WHERE photo_id IN (SELECT * FROM drop_indices)"),
             // There should be no data in groups and group members TODO: check + remove group if not true
             QString("DELETE FROM " TAB_PEOPLE            " WHERE photo_id IN (SELECT * FROM drop_indices)"),
+            QString("DELETE FROM " TAB_PHASHES           " WHERE photo_id IN (SELECT * FROM drop_indices)"),
             QString("DELETE FROM " TAB_PHOTOS_CHANGE_LOG " WHERE photo_id IN (SELECT * FROM drop_indices)"),
+            QString("DELETE FROM " TAB_SERIES_CANDIDATES " WHERE photo_id IN (SELECT * FROM drop_indices)"),
+            QString("DELETE FROM " TAB_SERIES_FEATURES   " WHERE photo_id IN (SELECT * FROM drop_indices)"),
             QString("DELETE FROM " TAB_SHA256SUMS        " WHERE photo_id IN (SELECT * FROM drop_indices)"),
+            QString("UPDATE " TAB_TAG_VALUES " SET photos_count = photos_count - "
+                    "(SELECT COUNT(*) FROM " TAB_TAGS " WHERE " TAB_TAGS ".photo_id IN (SELECT * FROM drop_indices) "
+                    "AND " TAB_TAGS ".name = " TAB_TAG_VALUES ".name AND " TAB_TAGS ".value = " TAB_TAG_VALUES ".value) "
+                    "WHERE (name, value) IN (SELECT name, value FROM " TAB_TAGS " WHERE photo_id IN (SELECT * FROM drop_indices))"),
+            QString("DELETE FROM " TAB_TAG_VALUES        " WHERE photos_count <= 0"),
             QString("DELETE FROM " TAB_TAGS              " WHERE photo_id IN (SELECT * FROM drop_indices)"),
             QString("DELETE FROM " TAB_THUMBS            " WHERE photo_id IN (SELECT * FROM drop_indices)"),
 
@@ -170,6 +178,48 @@ namespace Database
     }
 
 
+    std::vector<std::vector<Photo::Id>> PhotoOperator::findDuplicates(const Filter& filter)
+    {
+        const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
+
+        // sha256 index is used to find sums shared by many photos
+        const QString queryStr =
+            QString("SELECT photo_id, sha256 FROM %1 "
+                    "WHERE photo_id IN (%2) AND sha256 IN "
+                    "(SELECT sha256 FROM %1 WHERE photo_id IN (%2) AND sha256 <> '' GROUP BY sha256 HAVING COUNT(*) > 1) "
+                    "ORDER BY sha256, photo_id")
+            .arg(TAB_SHA256SUMS)
+            .arg(filterQuery);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        std::vector<std::vector<Photo::Id>> duplicates;
+
+        if (m_executor->exec(queryStr, &query))
+        {
+            QByteArray lastSha256;
+
+            while (query.next())
+            {
+                const Photo::Id id(query.value(0).toInt());
+                const QByteArray sha256 = query.value(1).toByteArray();
+
+                // rows are sorted by sha256, new group starts when it changes
+                if (duplicates.empty() || sha256 != lastSha256)
+                {
+                    duplicates.emplace_back();
+                    lastSha256 = sha256;
+                }
+
+                duplicates.back().push_back(id);
+            }
+        }
+
+        return duplicates;
+    }
+
+
     /**
      * \brief collect photo ids SELECTed by SQL query
      * \param query SQL SELECT query which returns photo ids
@@ -42,6 +42,7 @@ namespace Database
             std::vector<Photo::Id> onPhotos(const Filter &, const Action &) override;
 
             std::vector<Photo::Id> getPhotos(const Filter &) override final;
+            std::vector<std::vector<Photo::Id>> findDuplicates(const Filter &) override final;
 
         private:
             struct SortingContext
@@ -0,0 +1,261 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "series_cache_operator.hpp"
+
+#include <map>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "isql_query_executor.hpp"
+#include "tables.hpp"
+
+
+namespace Database
+{
+    SeriesCacheOperator::SeriesCacheOperator(const QString& connection, ISqlQueryExecutor* executor, ILogger* logger):
+        m_connectionName(connection),
+        m_executor(executor),
+        m_logger(logger)
+    {
+
+    }
+
+
+    std::vector<SeriesFeatures> SeriesCacheOperator::listFeatures()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString queryStr = QString("SELECT photo_id, timestamp, sequence_number, exposure, image FROM %1")
+                                    .arg(TAB_SERIES_FEATURES);
+
+        std::vector<SeriesFeatures> result;
+
+        if (m_executor->exec(queryStr, &query))
+            while(query.next())
+            {
+                SeriesFeatures features;
+                features.id = Photo::Id(query.value(0).toInt());
+                features.timestamp = std::chrono::milliseconds(query.value(1).toLongLong());
+
+                if (query.isNull(2) == false)
+                    features.sequenceNumber = query.value(2).toInt();
+
+                if (query.isNull(3) == false)
+                    features.exposure = query.value(3).toInt();
+
+                features.image = query.value(4).toInt() != 0;
+
+                result.push_back(features);
+            }
+
+        return result;
+    }
+
+
+    bool SeriesCacheOperator::store(const std::vector<SeriesFeatures>& features)
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        // REPLACE is understood by both SQLite and MySQL
+        const QString queryStr = QString("REPLACE INTO %1(photo_id, timestamp, sequence_number, exposure, image) "
+                                         "VALUES(:photo_id, :timestamp, :sequence_number, :exposure, :image)")
+                                    .arg(TAB_SERIES_FEATURES);
+
+        bool status = db.transaction();
+
+        if (status)
+            status = m_executor->prepare(queryStr, &query);
+
+        for (auto it = features.begin(); status && it != features.end(); ++it)
+        {
+            query.bindValue(":photo_id", it->id.value());
+            query.bindValue(":timestamp", static_cast<qint64>(it->timestamp.count()));
+            query.bindValue(":sequence_number", it->sequenceNumber? QVariant(*it->sequenceNumber): QVariant());
+            query.bindValue(":exposure", it->exposure? QVariant(*it->exposure): QVariant());
+            query.bindValue(":image", it->image? 1: 0);
+
+            status = m_executor->exec(query);
+        }
+
+        if (status)
+            status = db.commit();
+        else
+            db.rollback();
+
+        return status;
+    }
+
+
+    bool SeriesCacheOperator::dropFeatures(const std::vector<Photo::Id>& ids)
+    {
+        if (ids.empty())
+            return true;
+
+        QStringList ids_list;
+        for (const auto& id: ids)
+            ids_list.append(QString::number(id));
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString queryStr = QString("DELETE FROM %1 WHERE photo_id IN(%2)")
+                                    .arg(TAB_SERIES_FEATURES)
+                                    .arg(ids_list.join(","));
+
+        return m_executor->exec(queryStr, &query);
+    }
+
+
+    std::vector<SeriesWindow> SeriesCacheOperator::listWindows()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString windowsQuery = QString("SELECT id, first_timestamp, last_timestamp, max_gap, photos FROM %1")
+                                        .arg(TAB_SERIES_WINDOWS);
+
+        std::map<int, SeriesWindow> windows;
+
+        if (m_executor->exec(windowsQuery, &query))
+            while(query.next())
+            {
+                SeriesWindow window;
+                window.id = query.value(0).toInt();
+                window.first = std::chrono::milliseconds(query.value(1).toLongLong());
+                window.last = std::chrono::milliseconds(query.value(2).toLongLong());
+                window.maxGap = std::chrono::milliseconds(query.value(3).toLongLong());
+                window.photos = query.value(4).toUInt();
+
+                windows.emplace(window.id, window);
+            }
+
+        const QString candidatesQuery = QString("SELECT window_id, candidate, type, photo_id FROM %1 ORDER BY window_id, candidate, id")
+                                            .arg(TAB_SERIES_CANDIDATES);
+
+        if (m_executor->exec(candidatesQuery, &query))
+        {
+            int lastWindow = -1;
+            int lastCandidate = -1;
+
+            while(query.next())
+            {
+                const int windowId = query.value(0).toInt();
+                const int candidate = query.value(1).toInt();
+
+                auto it = windows.find(windowId);
+                if (it == windows.end())
+                    continue;
+
+                // rows are sorted, so new candidate starts when window or candidate number changes
+                if (windowId != lastWindow || candidate != lastCandidate)
+                {
+                    SeriesWindow::Candidate c;
+                    c.type = static_cast<Group::Type>(query.value(2).toInt());
+
+                    it->second.candidates.push_back(c);
+
+                    lastWindow = windowId;
+                    lastCandidate = candidate;
+                }
+
+                it->second.candidates.back().members.push_back(Photo::Id(query.value(3).toInt()));
+            }
+        }
+
+        std::vector<SeriesWindow> result;
+        result.reserve(windows.size());
+
+        for (auto& [id, window]: windows)
+            result.push_back(std::move(window));
+
+        return result;
+    }
+
+
+    bool SeriesCacheOperator::replaceWindows(const std::vector<int>& obsolete, const std::vector<SeriesWindow>& windows)
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        bool status = db.transaction();
+
+        if (status && obsolete.empty() == false)
+        {
+            QStringList ids_list;
+            for (const int id: obsolete)
+                ids_list.append(QString::number(id));
+
+            const QString ids = ids_list.join(",");
+
+            status = m_executor->exec(QString("DELETE FROM %1 WHERE window_id IN(%2)").arg(TAB_SERIES_CANDIDATES).arg(ids), &query);
+
+            if (status)
+                status = m_executor->exec(QString("DELETE FROM %1 WHERE id IN(%2)").arg(TAB_SERIES_WINDOWS).arg(ids), &query);
+        }
+
+        QSqlQuery candidateQuery(db);
+
+        if (status && windows.empty() == false)
+        {
+            status = m_executor->prepare(QString("INSERT INTO %1(first_timestamp, last_timestamp, max_gap, photos) "
+                                                 "VALUES(:first_timestamp, :last_timestamp, :max_gap, :photos)")
+                                            .arg(TAB_SERIES_WINDOWS), &query);
+
+            if (status)
+                status = m_executor->prepare(QString("INSERT INTO %1(window_id, candidate, type, photo_id) "
+                                                     "VALUES(:window_id, :candidate, :type, :photo_id)")
+                                                .arg(TAB_SERIES_CANDIDATES), &candidateQuery);
+        }
+
+        for (auto it = windows.begin(); status && it != windows.end(); ++it)
+        {
+            query.bindValue(":first_timestamp", static_cast<qint64>(it->first.count()));
+            query.bindValue(":last_timestamp", static_cast<qint64>(it->last.count()));
+            query.bindValue(":max_gap", static_cast<qint64>(it->maxGap.count()));
+            query.bindValue(":photos", static_cast<qulonglong>(it->photos));
+
+            status = m_executor->exec(query);
+
+            const QVariant windowId = query.lastInsertId();
+            status = status && windowId.isValid();
+
+            for (std::size_t c = 0; status && c < it->candidates.size(); c++)
+                for (auto m_it = it->candidates[c].members.begin(); status && m_it != it->candidates[c].members.end(); ++m_it)
+                {
+                    candidateQuery.bindValue(":window_id", windowId);
+                    candidateQuery.bindValue(":candidate", static_cast<int>(c));
+                    candidateQuery.bindValue(":type", static_cast<int>(it->candidates[c].type));
+                    candidateQuery.bindValue(":photo_id", m_it->value());
+
+                    status = m_executor->exec(candidateQuery);
+                }
+        }
+
+        if (status)
+            status = db.commit();
+        else
+            db.rollback();
+
+        return status;
+    }
+}
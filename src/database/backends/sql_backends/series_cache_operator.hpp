@@ -0,0 +1,52 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SERIESCACHEOPERATOR_HPP
+#define SERIESCACHEOPERATOR_HPP
+
+#include <QString>
+
+#include <database/iseries_cache_operator.hpp>
+
+
+struct ILogger;
+
+namespace Database
+{
+    struct ISqlQueryExecutor;
+
+    class SeriesCacheOperator final: public ISeriesCacheOperator
+    {
+        public:
+            SeriesCacheOperator(const QString &, ISqlQueryExecutor *, ILogger *);
+
+            std::vector<SeriesFeatures> listFeatures() override;
+            bool store(const std::vector<SeriesFeatures> &) override;
+            bool dropFeatures(const std::vector<Photo::Id> &) override;
+            std::vector<SeriesWindow> listWindows() override;
+            bool replaceWindows(const std::vector<int> &, const std::vector<SeriesWindow> &) override;
+
+        private:
+            QString m_connectionName;
+            ISqlQueryExecutor* m_executor;
+            ILogger* m_logger;
+    };
+}
+
+#endif // SERIESCACHEOPERATOR_HPP
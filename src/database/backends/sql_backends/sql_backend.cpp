@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <optional>
 #include <set>
 #include <sstream>
@@ -38,10 +39,12 @@
 
 #include <core/base_tags.hpp>
 #include <core/tag.hpp>
+#include <core/tags_utils.hpp>
 #include <core/task_executor.hpp>
 #include <core/ilogger.hpp>
 #include <core/ilogger_factory.hpp>
 #include <database/filter.hpp>
+#include <database/general_flags.hpp>
 #include <database/project_info.hpp>
 
 #include "isql_query_constructor.hpp"
@@ -155,6 +158,18 @@ namespace Database
     }
 
 
+    SeriesCacheOperator& ASqlBackend::seriesCacheOperator()
+    {
+        if (m_seriesCacheOperator.get() == nullptr)
+            m_seriesCacheOperator = std::make_unique<SeriesCacheOperator>(m_connectionName,
+                                                                          &m_executor,
+                                                                          m_logger.get()
+                                                                         );
+
+        return *m_seriesCacheOperator.get();
+    }
+
+
     bool ASqlBackend::dbOpened()
     {
         return true;
@@ -310,6 +325,17 @@ namespace Database
 
     std::vector<TagValue> ASqlBackend::listTagValues(const TagTypes& tagType, const Filter& filter)
     {
+        // no filtering - use dictionary of tag values instead of scanning all tags
+        if (std::holds_alternative<EmptyFilter>(filter))
+        {
+            std::vector<TagValue> result;
+
+            for (auto& [value, count]: countTagValues(tagType))
+                result.push_back(std::move(value));
+
+            return result;
+        }
+
         std::vector<TagValue> result;
 
         const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
@@ -348,6 +374,31 @@ namespace Database
     }
 
 
+    std::vector<std::pair<TagValue, int>> ASqlBackend::countTagValues(const TagTypes& tagType)
+    {
+        std::vector<std::pair<TagValue, int>> result;
+
+        const QString queryStr = QString("SELECT value, photos_count FROM %1 WHERE name=%2")
+                                    .arg(TAB_TAG_VALUES)
+                                    .arg(tagType);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        if (m_executor.exec(queryStr, &query))
+            while (query.next())
+            {
+                const QString raw_value = query.value(0).toString();
+                const int count = query.value(1).toInt();
+
+                if (raw_value.isEmpty() == false)
+                    result.emplace_back(TagValue::fromRaw(raw_value, BaseTags::getType(tagType)), count);
+            }
+
+        return result;
+    }
+
+
     Photo::Data ASqlBackend::getPhoto(const Photo::Id& id)
     {
         const Photo::DataDelta photoDelta = getPhotoDelta(id);
@@ -401,6 +452,14 @@ namespace Database
             if (fields.contains(Photo::Field::GroupInfo))
                 photoData.insert<Photo::Field::GroupInfo>(getGroupFor(id));
 
+            if (fields.contains(Photo::Field::PHash))
+            {
+                const auto phash = getPHashFor(id);
+
+                if (phash.valid())
+                    photoData.insert<Photo::Field::PHash>(phash);
+            }
+
             if (fields.contains(Photo::Field::Flags))
                 photoData.insert<Photo::Field::Flags>(getFlagsFor(id));
         }
@@ -409,26 +468,179 @@ namespace Database
     }
 
 
-    int ASqlBackend::getPhotosCount(const Filter& filter)
+    std::vector<Photo::Data> ASqlBackend::getPhotos(const std::vector<Photo::Id>& ids)
     {
-        const QString queryStr = SqlFilterQueryGenerator().generate(filter);
+        if (ids.empty())
+            return {};
 
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
 
-        m_executor.exec(queryStr, &query);
+        QStringList idsList;
+        idsList.reserve(static_cast<qsizetype>(ids.size()));
+
+        for(const Photo::Id& id: ids)
+            idsList.append(QString::number(id.value()));
+
+        const QString idsStr = idsList.join(", ");
+
+        // read each kind of data for all photos at once instead of querying each photo separately
+        std::map<Photo::Id, Photo::Data> photos;
+
+        if (m_executor.exec(QString("SELECT id, path FROM %1 WHERE id IN (%2)").arg(TAB_PHOTOS).arg(idsStr), &query))
+            while (query.next())
+            {
+                const Photo::Id id(query.value(0).toInt());
+                Photo::Data& data = photos[id];
+
+                data.id = id;
+                data.path = query.value(1).toString();
+            }
+
+        auto dataFor = [&photos](const QVariant& id) -> Photo::Data*
+        {
+            auto it = photos.find(Photo::Id(id.toInt()));
+            return it == photos.end()? nullptr: &it->second;
+        };
+
+        if (m_executor.exec(QString("SELECT photo_id, name, value FROM %1 WHERE photo_id IN (%2)").arg(TAB_TAGS).arg(idsStr), &query))
+            while (query.next())
+                if (Photo::Data* data = dataFor(query.value(0)))
+                {
+                    const TagTypes tagNameType = static_cast<TagTypes>( query.value(1).toInt() );
+                    const QVariant value = query.value(2);
+
+                    // storing routine doesn't store empty tags (see store() for tags)
+                    if (value.isValid() == false || value.isNull())
+                        continue;
+
+                    data->tags[tagNameType] = TagValue::fromRaw(value.toString(), BaseTags::getType(tagNameType));
+                }
+
+        if (m_executor.exec(QString("SELECT photo_id, width, height FROM %1 WHERE photo_id IN (%2)").arg(TAB_GEOMETRY).arg(idsStr), &query))
+            while (query.next())
+                if (Photo::Data* data = dataFor(query.value(0)))
+                    data->geometry = QSize(query.value(1).toInt(), query.value(2).toInt());
+
+        if (m_executor.exec(QString("SELECT photo_id, sha256 FROM %1 WHERE photo_id IN (%2)").arg(TAB_SHA256SUMS).arg(idsStr), &query))
+            while (query.next())
+                if (Photo::Data* data = dataFor(query.value(0)))
+                    data->sha256Sum = query.value(1).toByteArray();
+
+        if (m_executor.exec(QString("SELECT photo_id, hash FROM %1 WHERE photo_id IN (%2)").arg(TAB_PHASHES).arg(idsStr), &query))
+            while (query.next())
+                if (Photo::Data* data = dataFor(query.value(0)))
+                    data->phash = static_cast<std::uint64_t>(query.value(1).toLongLong());
+
+        const QString flagsQuery = QString("SELECT photo_id, staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded, phash_loaded "
+                                           "FROM %1 WHERE photo_id IN (%2)")
+                                    .arg(TAB_FLAGS)
+                                    .arg(idsStr);
+
+        if (m_executor.exec(flagsQuery, &query))
+            while (query.next())
+                if (Photo::Data* data = dataFor(query.value(0)))
+                {
+                    data->flags[Photo::FlagsE::StagingArea]     = query.value(1).toInt();
+                    data->flags[Photo::FlagsE::ExifLoaded]      = query.value(2).toInt();
+                    data->flags[Photo::FlagsE::Sha256Loaded]    = query.value(3).toInt();
+                    data->flags[Photo::FlagsE::ThumbnailLoaded] = query.value(4).toInt();
+                    data->flags[Photo::FlagsE::GeometryLoaded]  = query.value(5).toInt();
+                    data->flags[Photo::FlagsE::PHashLoaded]     = query.value(6).toInt();
+                }
+
+        const QString groupsQuery = QString("SELECT %1.id, %1.representative_id, %2.photo_id FROM %1 "
+                                            "JOIN %2 ON (%1.id = %2.group_id) "
+                                            "WHERE (%1.representative_id IN (%3) OR %2.photo_id IN (%3))")
+                                    .arg(TAB_GROUPS)
+                                    .arg(TAB_GROUPS_MEMBERS)
+                                    .arg(idsStr);
+
+        if (m_executor.exec(groupsQuery, &query))
+            while (query.next())
+            {
+                const Group::Id gid(query.value(0).toInt());
+
+                if (Photo::Data* data = dataFor(query.value(1)))
+                    data->groupInfo = GroupInfo(gid, GroupInfo::Representative);
+
+                if (Photo::Data* data = dataFor(query.value(2)))
+                    data->groupInfo = GroupInfo(gid, GroupInfo::Member);
+            }
+
+        std::vector<Photo::Data> result;
+        result.reserve(photos.size());
+
+        for(const Photo::Id& id: ids)
+        {
+            auto it = photos.find(id);
+
+            if (it != photos.end())
+                result.push_back(it->second);
+        }
+
+        return result;
+    }
+
+
+    int ASqlBackend::getPhotosCount(const Filter& filter)
+    {
+        const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
+        const QString queryStr = QString("SELECT COUNT(*) FROM (%1) AS filtered_photos").arg(filterQuery);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
 
         int result = 0;
 
-        if (m_dbHasSizeFeature)
-            result = query.size();
-        else
-            result = query.next()? 1: 0;
+        if (m_executor.exec(queryStr, &query) && query.next())
+            result = query.value(0).toInt();
 
         return result;
     }
 
 
+    DateHistogram ASqlBackend::getDateHistogram(const Filter& filter, DateHistogram::Granularity granularity)
+    {
+        DateHistogram histogram(granularity);
+
+        if (std::holds_alternative<EmptyFilter>(filter))
+        {
+            // no filtering - use counters of tag values
+            for (const auto& [date, count]: countTagValues(TagTypes::Date))
+                histogram.add(date.getDate(), count);
+        }
+        else
+        {
+            const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
+
+            // NOTE: filterQuery must go as a last item as it may contain '%X' which would ruin queryStr
+            const QString queryStr = QString("SELECT value, COUNT(*) FROM %1 WHERE name=%2 AND photo_id IN (%3) GROUP BY value")
+                                        .arg(TAB_TAGS)
+                                        .arg(TagTypes::Date)
+                                        .arg(filterQuery);
+
+            QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+            QSqlQuery query(db);
+
+            if (m_executor.exec(queryStr, &query))
+                while (query.next())
+                {
+                    const TagValue date = TagValue::fromRaw(query.value(0).toString(), Tag::ValueType::Date);
+                    histogram.add(date.getDate(), query.value(1).toInt());
+                }
+        }
+
+        // each photo has at most one date so all remaining ones have none
+        const int without_date = getPhotosCount(filter) - histogram.total();
+
+        if (without_date > 0)
+            histogram.add(QDate(), without_date);
+
+        return histogram;
+    }
+
+
     void ASqlBackend::set(const Photo::Id& id, const QString& name, int value)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
@@ -439,7 +651,41 @@ namespace Database
         updateData.addCondition("photo_id", QString::number(id));
         updateData.addCondition("name", name);
 
-        updateOrInsert(updateData);
+        if (updateOrInsert(updateData))
+            emit generalFlagChanged(id, name, value);
+    }
+
+
+    void ASqlBackend::set(const QString& name, const std::map<Photo::Id, int>& values)
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+
+        Transaction transaction(m_tr_db);
+
+        try
+        {
+            DbErrorOnFalse(transaction.begin());
+
+            for (const auto& [id, value]: values)
+            {
+                UpdateQueryData updateData(TAB_GENERAL_FLAGS);
+                updateData.setColumns("photo_id", "name", "value");
+                updateData.setValues(id, name, value);
+                updateData.addCondition("photo_id", QString::number(id));
+                updateData.addCondition("name", name);
+
+                DbErrorOnFalse(updateOrInsert(updateData));
+            }
+
+            DbErrorOnFalse(transaction.commit());
+
+            for (const auto& [id, value]: values)
+                emit generalFlagChanged(id, name, value);
+        }
+        catch(const db_error& error)
+        {
+            m_logger->error(error.what());
+        }
     }
 
 
@@ -488,6 +734,48 @@ namespace Database
     }
 
 
+    void ASqlBackend::storeFaces(const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>>& faces)
+    {
+        Transaction transaction(m_tr_db);
+
+        try
+        {
+            DbErrorOnFalse(transaction.begin(), StatusCodes::TransactionFailed);
+
+            auto& peopleAccessor = peopleInformationAccessor();
+
+            for (const auto& [id, photoFaces]: faces)
+            {
+                for (const auto& [rect, fingerprint]: photoFaces)
+                {
+                    const PersonFingerprint::Id fid = peopleAccessor.store(PersonFingerprint(fingerprint));
+                    DbErrorOnFalse(fid.valid());
+
+                    const PersonInfo::Id pid = peopleAccessor.store(PersonInfo(Person::Id(), id, fid, rect));
+                    DbErrorOnFalse(pid.valid());
+                }
+
+                UpdateQueryData updateData(TAB_GENERAL_FLAGS);
+                updateData.setColumns("photo_id", "name", "value");
+                updateData.setValues(id, CommonGeneralFlags::FacesRecognized, 1);
+                updateData.addCondition("photo_id", QString::number(id));
+                updateData.addCondition("name", CommonGeneralFlags::FacesRecognized);
+
+                DbErrorOnFalse(updateOrInsert(updateData));
+            }
+
+            DbErrorOnFalse(transaction.commit(), StatusCodes::TransactionCommitFailed);
+
+            for (const auto& [id, photoFaces]: faces)
+                emit generalFlagChanged(id, CommonGeneralFlags::FacesRecognized, 1);
+        }
+        catch(const db_error& error)
+        {
+            m_logger->error(error.what());
+        }
+    }
+
+
     /**
      * \brief validate database consistency
      */
@@ -597,7 +885,82 @@ namespace Database
                         break;
                 }
 
-                case 5:             // current version, break updgrades chain
+                case 5:             // sha256 stored as raw digest instead of hex string
+                {
+                    // read all hex digests
+                    const QString read_sums = QString("SELECT photo_id, sha256 FROM %1")
+                                                .arg(TAB_SHA256SUMS);
+
+                    status = m_executor.exec(read_sums, &query);
+                    if (status == false)
+                        break;
+
+                    std::vector<std::pair<int, QByteArray>> sums;
+                    while(query.next())
+                        sums.emplace_back(query.value(0).toInt(), QByteArray::fromHex(query.value(1).toString().toLatin1()));
+
+                    // recreate TAB_SHA256SUMS
+                    status = m_executor.exec(QString("DROP TABLE %1").arg(TAB_SHA256SUMS), &query);
+                    if (status == false)
+                        break;
+
+                    auto tab_sha256sums = tables.find(TAB_SHA256SUMS);
+                    if (tab_sha256sums == tables.end())
+                        break;
+
+                    status = ensureTableExists(tab_sha256sums->second);
+                    if (status == false)
+                        break;
+
+                    // fill fresh instance of TAB_SHA256SUMS with binary digests
+                    const QString fill_sums = QString("INSERT INTO %1(photo_id, sha256) VALUES(:photo_id, :sha256)")
+                                                .arg(TAB_SHA256SUMS);
+
+                    status = m_executor.prepare(fill_sums, &query);
+                    if (status == false)
+                        break;
+
+                    for(const auto& [photo_id, sum]: sums)
+                    {
+                        query.bindValue(":photo_id", photo_id);
+                        query.bindValue(":sha256", sum);
+
+                        status = m_executor.exec(query);
+                        if (status == false)
+                            break;
+                    }
+
+                    if (status == false)
+                        break;
+                }
+
+                case 6:             // new flag: perceptual hash calculated
+                {
+                    const QString add_flag = QString("ALTER TABLE %1 ADD COLUMN %2 INT NOT NULL DEFAULT 0")
+                                                .arg(TAB_FLAGS)
+                                                .arg(FLAG_PHASH_LOADED);
+
+                    status = m_executor.exec(add_flag, &query);
+                    if (status == false)
+                        break;
+                }
+
+                case 7:             // new table for series detection cache (created by checkStructure())
+
+                case 8:             // new table with distinct tag values (created by checkStructure()), fill it with existing data
+                {
+                    const QString fill_values = QString("INSERT INTO %1(name, value, photos_count) SELECT name, value, COUNT(*) FROM %2 GROUP BY name, value")
+                                                    .arg(TAB_TAG_VALUES)
+                                                    .arg(TAB_TAGS);
+
+                    status = m_executor.exec(fill_values, &query);
+                    if (status == false)
+                        break;
+                }
+
+                case 9:             // new tables for series detection results (created by checkStructure())
+
+                case 10:            // current version, break updgrades chain
                     break;
 
                 default:
@@ -617,26 +980,6 @@ namespace Database
         return status;
     }
 
-    /**
-     * \brief get people details for given people ids
-     * \return vector of person details structure
-     */
-    std::vector<PersonInfo> ASqlBackend::listPeople(const std::vector<Photo::Id>& ids)
-    {
-        std::vector<PersonInfo> all_people;
-
-        for(const Photo::Id& id: ids)
-        {
-            const auto people = peopleInformationAccessor().listPeople(id);
-
-            for (const PersonInfo& person: people)
-                all_people.push_back(person);
-        }
-
-        return all_people;
-    }
-
-
     /**
      * \brief prepare sql statement for KEY creation
      */
@@ -780,6 +1123,10 @@ namespace Database
             const Tag::TagsList& tags = data.get<Photo::Field::Tags>();
 
             status = storeTags(data.getId(), tags);
+
+            // series detection depends on photo's timestamp only
+            if (status && Tag::timestamp(currentStateOfPhoto.tags) != Tag::timestamp(tags))
+                status = dropSeriesFeatures(data.getId());
         }
 
         if (status && data.has(Photo::Field::Geometry))
@@ -806,6 +1153,14 @@ namespace Database
             status = storeGroup(data.getId(), groupInfo);
         }
 
+        if (status && data.has(Photo::Field::PHash))
+        {
+            const Photo::PHashT& phash = data.get<Photo::Field::PHash>();
+
+            if (phash.valid())
+                status = storePHash(data.getId(), phash);
+        }
+
         photoChangeLogOperator().storeDifference(currentStateOfPhoto, data);
 
         return status;
@@ -837,13 +1192,50 @@ namespace Database
         UpdateQueryData data(TAB_SHA256SUMS);
         data.addCondition("photo_id", QString::number(photo_id));
         data.setColumns("photo_id", "sha256");
-        data.setValues(QString::number(photo_id), sha256.constData());
+        data.setValues(QString::number(photo_id), sha256);
 
         const bool status = updateOrInsert(data);
 
         return status;
     }
 
+    /**
+     * \brief store photo's perceptual hash
+     * \return false on error
+     */
+    bool ASqlBackend::storePHash(const Photo::Id& photo_id, const Photo::PHashT& phash) const
+    {
+        // BIGINT is signed, store hash's bits as they are
+        const qint64 hash = static_cast<qint64>(phash.value());
+
+        UpdateQueryData data(TAB_PHASHES);
+        data.addCondition("photo_id", QString::number(photo_id));
+        data.setColumns("photo_id", "hash");
+        data.setValues(QString::number(photo_id), hash);
+
+        const bool status = updateOrInsert(data);
+
+        return status;
+    }
+
+
+    /**
+     * \brief drop series detection data stored for photo
+     * \return false on error
+     */
+    bool ASqlBackend::dropSeriesFeatures(const Photo::Id& photo_id) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString dropQuery = QString("DELETE FROM %1 WHERE photo_id = %2")
+                                    .arg(TAB_SERIES_FEATURES)
+                                    .arg(photo_id);
+
+        return m_executor.exec(dropQuery, &query);
+    }
+
+
     /**
      * \brief store photo's tags in database
      * \return false on error
@@ -854,8 +1246,8 @@ namespace Database
         QSqlQuery query(db);
         bool status = true;
 
-        // gather ids for current set of tag for photo_id
-        const QString tagIdsQuery = QString("SELECT id FROM %1 WHERE photo_id=\"%2\"")
+        // gather ids and values for current set of tag for photo_id
+        const QString tagIdsQuery = QString("SELECT id, name, value FROM %1 WHERE photo_id=\"%2\"")
                                     .arg(TAB_TAGS)
                                     .arg(photo_id);
 
@@ -867,12 +1259,16 @@ namespace Database
             // read tag ids from query
             std::vector<int> currentIds;
 
+            // change of usage of each tag value (for TAB_TAG_VALUES)
+            std::map<std::pair<int, QString>, int> usageChange;
+
             while (query.next())
             {
                 const QVariant idRaw = query.value(0);
                 const int id = idRaw.toInt();
 
                 currentIds.push_back(id);
+                usageChange[ {query.value(1).toInt(), query.value(2).toString()} ]--;
             }
 
             // difference between current set in db and new set of tags
@@ -906,8 +1302,74 @@ namespace Database
                 const int tag_id = counter < currentIds.size()? currentIds[counter]: -1;  // try to override ids of tags already stored
 
                 status = store(value, photo_id, name, tag_id);
+                usageChange[ {name, value.rawValue()} ]++;
+            }
+
+            for (auto it = usageChange.begin(); status && it != usageChange.end(); ++it)
+                if (it->second != 0)
+                    status = updateTagValueUsage(it->first.first, it->first.second, it->second);
+        }
+
+        return status;
+    }
+
+
+    /**
+     * \brief update number of photos using given tag value
+     * \return false on error
+     */
+    bool ASqlBackend::updateTagValueUsage(int name, const QString& value, int change) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString updateQuery = QString("UPDATE %1 SET photos_count = photos_count + :change WHERE name = :name AND value = :value")
+                                        .arg(TAB_TAG_VALUES);
+
+        bool status = m_executor.prepare(updateQuery, &query);
+
+        if (status)
+        {
+            query.bindValue(":change", change);
+            query.bindValue(":name", name);
+            query.bindValue(":value", value);
+
+            status = m_executor.exec(query);
+        }
+
+        // value not known yet
+        if (status && query.numRowsAffected() == 0 && change > 0)
+        {
+            const QString insertQuery = QString("INSERT INTO %1(name, value, photos_count) VALUES(:name, :value, :change)")
+                                            .arg(TAB_TAG_VALUES);
+
+            status = m_executor.prepare(insertQuery, &query);
+
+            if (status)
+            {
+                query.bindValue(":change", change);
+                query.bindValue(":name", name);
+                query.bindValue(":value", value);
+
+                status = m_executor.exec(query);
             }
+        }
+
+        // value not used anymore
+        if (status && change < 0)
+        {
+            const QString deleteQuery = QString("DELETE FROM %1 WHERE name = :name AND value = :value AND photos_count <= 0")
+                                            .arg(TAB_TAG_VALUES);
 
+            status = m_executor.prepare(deleteQuery, &query);
+
+            if (status)
+            {
+                query.bindValue(":name", name);
+                query.bindValue(":value", value);
+
+                status = m_executor.exec(query);
+            }
         }
 
         return status;
@@ -930,13 +1392,14 @@ namespace Database
 
         UpdateQueryData queryInfo(TAB_FLAGS);
         queryInfo.addCondition("photo_id", QString::number(id));
-        queryInfo.setColumns("photo_id", "staging_area", "tags_loaded", "sha256_loaded", "thumbnail_loaded", FLAG_GEOM_LOADED);
+        queryInfo.setColumns("photo_id", "staging_area", "tags_loaded", "sha256_loaded", "thumbnail_loaded", FLAG_GEOM_LOADED, FLAG_PHASH_LOADED);
         queryInfo.setValues(QString::number(id),
                             get_flag(Photo::FlagsE::StagingArea),
                             get_flag(Photo::FlagsE::ExifLoaded),
                             get_flag(Photo::FlagsE::Sha256Loaded),
                             get_flag(Photo::FlagsE::ThumbnailLoaded),
-                            get_flag(Photo::FlagsE::GeometryLoaded)
+                            get_flag(Photo::FlagsE::GeometryLoaded),
+                            get_flag(Photo::FlagsE::PHashLoaded)
         );
 
         const bool status = updateOrInsert(queryInfo);
@@ -1114,7 +1577,35 @@ namespace Database
         {
             const QVariant variant = query.value(0);
 
-            result = variant.toString().toLatin1();
+            result = variant.toByteArray();
+        }
+
+        return result;
+    }
+
+
+    /**
+     * \brief read photo's perceptual hash
+     * \param id photo id
+     * \return photo's perceptual hash (invalid if not calculated yet)
+     */
+    Photo::PHashT ASqlBackend::getPHashFor(const Photo::Id& id) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString queryStr = QString("SELECT hash FROM %1 WHERE %1.photo_id = '%2'")
+                                 .arg(TAB_PHASHES)
+                                 .arg(id.value());
+
+        const bool status = m_executor.exec(queryStr, &query);
+
+        Photo::PHashT result;
+        if(status && query.next())
+        {
+            const QVariant variant = query.value(0);
+
+            result = static_cast<std::uint64_t>(variant.toLongLong());
         }
 
         return result;
@@ -1183,7 +1674,7 @@ namespace Database
 
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
-        QString queryStr = QString("SELECT staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded FROM %1 WHERE %1.photo_id = '%2'");
+        QString queryStr = QString("SELECT staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded, phash_loaded FROM %1 WHERE %1.photo_id = '%2'");
 
         queryStr = queryStr.arg(TAB_FLAGS);
         queryStr = queryStr.arg(id.value());
@@ -1206,6 +1697,9 @@ namespace Database
 
             variant = query.value(4);
             flags[Photo::FlagsE::GeometryLoaded] = variant.toInt();
+
+            variant = query.value(5);
+            flags[Photo::FlagsE::PHashLoaded] = variant.toInt();
         }
 
         return flags;
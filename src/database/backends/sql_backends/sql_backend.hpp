@@ -32,6 +32,7 @@
 #include "people_information_accessor.hpp"
 #include "photo_change_log_operator.hpp"
 #include "photo_operator.hpp"
+#include "series_cache_operator.hpp"
 #include "sql_backend_base_export.h"
 #include "sql_query_executor.hpp"
 #include "table_definition.hpp"
@@ -78,6 +79,7 @@ namespace Database
             PhotoOperator& photoOperator() override;
             PhotoChangeLogOperator& photoChangeLogOperator() override;
             IPeopleInformationAccessor& peopleInformationAccessor() override;
+            SeriesCacheOperator& seriesCacheOperator() override;
 
         protected:
             /**
@@ -127,6 +129,7 @@ namespace Database
             std::unique_ptr<GroupOperator> m_groupOperator;
             std::unique_ptr<PhotoOperator> m_photoOperator;
             std::unique_ptr<PhotoChangeLogOperator> m_photoChangeLogOperator;
+            std::unique_ptr<SeriesCacheOperator> m_seriesCacheOperator;
             lazy_ptr<IPeopleInformationAccessor, std::function<IPeopleInformationAccessor*()>> m_peopleInfoAccessor;
             mutable NestedTransaction m_tr_db;
             QString m_connectionName;
@@ -141,14 +144,19 @@ namespace Database
             bool update(const std::vector<Photo::DataDelta> &) override final;
 
             std::vector<TagValue>    listTagValues(const TagTypes &, const Filter &) override final;
+            std::vector<std::pair<TagValue, int>> countTagValues(const TagTypes &) override final;
 
             Photo::Data              getPhoto(const Photo::Id &) override final;
             Photo::DataDelta         getPhotoDelta(const Photo::Id &, const std::set<Photo::Field> & = {}) override final;
+            std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) override final;
             int                      getPhotosCount(const Filter &) override final;
+            DateHistogram            getDateHistogram(const Filter &, DateHistogram::Granularity) override final;
             void                     set(const Photo::Id &, const QString &, int) override final;
+            void                     set(const QString &, const std::map<Photo::Id, int> &) override final;
             std::optional<int>       get(const Photo::Id &, const QString &) override final;
 
             std::vector<Photo::Id> markStagedAsReviewed() override final;
+            void                   storeFaces(const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>> &) override final;
             //
 
             // general helpers
@@ -157,8 +165,6 @@ namespace Database
             bool updateOrInsert(const UpdateQueryData &) const;
 
             // helpers for sql operations
-            std::vector<PersonInfo> listPeople(const std::vector<Photo::Id> &);
-
             bool createKey(const Database::TableDefinition::KeyDefinition &, const QString &, QSqlQuery &) const;
 
             bool store(const TagValue& value, int photo_id, int name_id, int tag_id = -1) const;
@@ -169,13 +175,17 @@ namespace Database
             bool storeData(const Photo::DataDelta &);
             bool storeGeometryFor(const Photo::Id &, const QSize &) const;
             bool storeSha256(int photo_id, const Photo::Sha256sum &) const;
+            bool storePHash(const Photo::Id &, const Photo::PHashT &) const;
             bool storeTags(int photo_id, const Tag::TagsList &) const;
+            bool updateTagValueUsage(int name, const QString& value, int change) const;
             bool storeFlags(const Photo::Id &, const Photo::FlagValues &) const;
             bool storeGroup(const Photo::Id &, const GroupInfo &) const;
+            bool dropSeriesFeatures(const Photo::Id &) const;
 
             Tag::TagsList        getTagsFor(const Photo::Id &) const;
             QSize                getGeometryFor(const Photo::Id &) const;
             std::optional<Photo::Sha256sum> getSha256For(const Photo::Id &) const;
+            Photo::PHashT        getPHashFor(const Photo::Id &) const;
             GroupInfo            getGroupFor(const Photo::Id &) const;
             Photo::FlagValues    getFlagsFor(const Photo::Id &) const;
             QString getPathFor(const Photo::Id &) const;
@@ -73,6 +73,7 @@ namespace Database
             case Photo::FlagsE::Sha256Loaded:    result = FLAG_SHA256_LOADED; break;
             case Photo::FlagsE::ThumbnailLoaded: result = FLAG_THUMB_LOADED;  break;
             case Photo::FlagsE::GeometryLoaded:  result = FLAG_GEOM_LOADED;   break;
+            case Photo::FlagsE::PHashLoaded:     result = FLAG_PHASH_LOADED;  break;
         }
 
         return result;
@@ -218,10 +219,11 @@ namespace Database
     {
         assert(sha256.sha256.isEmpty() == false);
 
-        return QString("SELECT id FROM %1 JOIN (%2) ON (%2.photo_id = %1.id) WHERE %2.sha256 = '%3'")
+        // sha256 is stored as raw digest, compare with hex literal
+        return QString("SELECT id FROM %1 JOIN (%2) ON (%2.photo_id = %1.id) WHERE %2.sha256 = X'%3'")
                 .arg(TAB_PHOTOS)
                 .arg(TAB_SHA256SUMS)
-                .arg(sha256.sha256.constData());
+                .arg(sha256.sha256.toHex().constData());
     }
 
     QString SqlFilterQueryGenerator::visit(const FilterNotMatchingFilter& filter) const
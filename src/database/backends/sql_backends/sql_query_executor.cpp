@@ -79,10 +79,14 @@ namespace Database
         const BackendStatus status = query.exec()? StatusCodes::Ok: StatusCodes::QueryFailed;
         const auto end = std::chrono::steady_clock::now();
         const auto diff = end - start;
-        const auto diff_ms = std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
-        const QString logMessage = QString("%1 Execution time: %2ms").arg(query.lastQuery()).arg(diff_ms);
 
-        m_logger->trace(logMessage);
+        if (m_logger->isEnabled(ILogger::Severity::Trace))
+        {
+            const auto diff_ms = std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
+            const QString logMessage = QString("%1 Execution time: %2ms").arg(query.lastQuery()).arg(diff_ms);
+
+            m_logger->trace(logMessage);
+        }
 
         if (status == false)
         {
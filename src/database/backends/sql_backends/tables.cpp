@@ -10,7 +10,7 @@ namespace Database
         //check for proper sizes
         static_assert(sizeof(int) >= 4, "int is smaller than MySQL's equivalent");
 
-        const int db_version = 5;
+        const int db_version = 10;
 
         TableDefinition
         table_versionHistory(TAB_VER,
@@ -49,6 +49,21 @@ namespace Database
         );
 
 
+        //distinct values of tags with number of photos using them
+        TableDefinition
+        table_tag_values(TAB_TAG_VALUES,
+                         {
+                             { "id", "", ColDefinition::Purpose::ID },
+                             { "value", QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len) },
+                             { "name", "INTEGER NOT NULL"        },
+                             { "photos_count", "INTEGER NOT NULL"  },
+                         },
+                         {
+                             { "tv_name", "INDEX", "(name)" }     // value is too long to be a part of key in MySQL
+                         }
+        );
+
+
         TableDefinition
         table_thumbnails(TAB_THUMBS,
                          {
@@ -68,7 +83,7 @@ namespace Database
                          {
                              { "id", "", ColDefinition::Purpose::ID                      },
                              { "photo_id INTEGER NOT NULL", ""                           },
-                             { "sha256 CHAR(32) NOT NULL", ""                            },
+                             { "sha256 BINARY(32) NOT NULL", ""                          },   // raw digest
                              { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
                          },
                          {
@@ -94,6 +109,66 @@ namespace Database
         );
 
 
+        TableDefinition
+        table_phashes(TAB_PHASHES,
+                      {
+                          { "id", "", ColDefinition::Purpose::ID                      },
+                          { "photo_id INTEGER NOT NULL", ""                           },
+                          { "hash BIGINT NOT NULL", ""                                },   // 64bit perceptual hash
+                          { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                      },
+                      {
+                          { "ph_photo_id", "UNIQUE INDEX", "(photo_id)" },               //one hash per photo
+                      }
+        );
+
+
+        TableDefinition
+        table_series_features(TAB_SERIES_FEATURES,
+                              {
+                                  { "id", "", ColDefinition::Purpose::ID                      },
+                                  { "photo_id INTEGER NOT NULL", ""                           },
+                                  { "timestamp BIGINT NOT NULL", ""                           },   // ms since epoch
+                                  { "sequence_number INTEGER", ""                             },   // NULL when not available
+                                  { "exposure INTEGER", ""                                    },   // NULL when not available
+                                  { "image INTEGER NOT NULL", ""                              },
+                                  { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                              },
+                              {
+                                  { "sf_photo_id", "UNIQUE INDEX", "(photo_id)" },
+                              }
+        );
+
+
+        TableDefinition
+        table_series_windows(TAB_SERIES_WINDOWS,
+                             {
+                                 { "id", "", ColDefinition::Purpose::ID                      },
+                                 { "first_timestamp BIGINT NOT NULL", ""                     },   // ms since epoch
+                                 { "last_timestamp BIGINT NOT NULL", ""                      },   // ms since epoch
+                                 { "max_gap BIGINT NOT NULL", ""                             },   // ms
+                                 { "photos INTEGER NOT NULL", ""                             },
+                             }
+        );
+
+
+        TableDefinition
+        table_series_candidates(TAB_SERIES_CANDIDATES,
+                                {
+                                    { "id", "", ColDefinition::Purpose::ID                          },
+                                    { "window_id INTEGER NOT NULL", ""                              },
+                                    { "candidate INTEGER NOT NULL", ""                              },   // candidate's number within window
+                                    { "type INTEGER NOT NULL", ""                                   },
+                                    { "photo_id INTEGER NOT NULL", ""                               },
+                                    { "FOREIGN KEY(window_id) REFERENCES " TAB_SERIES_WINDOWS "(id)", "" },
+                                    { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", ""     }
+                                },
+                                {
+                                    { "sc_window_id", "INDEX", "(window_id)" },
+                                }
+        );
+
+
         //set of flags used internally
         TableDefinition
         table_flags(TAB_FLAGS,
@@ -105,6 +180,7 @@ namespace Database
                         { FLAG_SHA256_LOADED, "INT NOT NULL" },
                         { FLAG_THUMB_LOADED,  "INT NOT NULL" },
                         { FLAG_GEOM_LOADED,   "INT NOT NULL" },
+                        { FLAG_PHASH_LOADED,  "INT NOT NULL DEFAULT 0" },
                         { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
                     },
                     {
@@ -200,10 +276,15 @@ namespace Database
             { TAB_VER,                  table_versionHistory },
             { TAB_PHOTOS,               table_photos },
             { TAB_TAGS,                 table_tags },
+            { TAB_TAG_VALUES,           table_tag_values },
             { TAB_THUMBS,               table_thumbnails },
             { TAB_SHA256SUMS,           table_sha256sums },
             { TAB_FLAGS,                table_flags },
             { TAB_GEOMETRY,             table_geometry },
+            { TAB_PHASHES,              table_phashes },
+            { TAB_SERIES_FEATURES,      table_series_features },
+            { TAB_SERIES_WINDOWS,       table_series_windows },
+            { TAB_SERIES_CANDIDATES,    table_series_candidates },
             { TAB_GROUPS,               table_groups },
             { TAB_GROUPS_MEMBERS,       table_groups_members },
             { TAB_PEOPLE_NAMES,         table_people },
@@ -19,12 +19,18 @@
 #define TAB_FACES_FINGERPRINTS   "faces_fingerprints"
 #define TAB_GENERAL_FLAGS        "general_flags"
 #define TAB_PHOTOS_CHANGE_LOG    "photos_change_log"
+#define TAB_PHASHES              "phashes"
+#define TAB_SERIES_FEATURES      "series_features"
+#define TAB_SERIES_WINDOWS       "series_windows"
+#define TAB_SERIES_CANDIDATES    "series_candidates"
+#define TAB_TAG_VALUES           "tag_values"
 
 #define FLAG_STAGING_AREA  "staging_area"
 #define FLAG_TAGS_LOADED   "tags_loaded"
 #define FLAG_SHA256_LOADED "sha256_loaded"
 #define FLAG_THUMB_LOADED  "thumbnail_loaded"
 #define FLAG_GEOM_LOADED   "geometry_loaded"
+#define FLAG_PHASH_LOADED  "phash_loaded"
 
 namespace Database
 {
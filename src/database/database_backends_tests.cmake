@@ -22,6 +22,7 @@ addTestTarget(database_backends
                     backends/sql_backends/sql_filter_query_generator.cpp
                     backends/sql_backends/sql_query_executor.cpp
                     backends/sql_backends/query_structs.cpp
+                    backends/sql_backends/series_cache_operator.cpp
                     backends/sql_backends/sql_backend.cpp
                     backends/sql_backends/table_definition.cpp
                     backends/sql_backends/tables.cpp
@@ -33,8 +34,10 @@ addTestTarget(database_backends
                     unit_tests_for_backends/groups_tests.cpp
                     unit_tests_for_backends/people_tests.cpp
                     unit_tests_for_backends/photo_operator_tests.cpp
+                    unit_tests_for_backends/photos_index_tests.cpp
                     unit_tests_for_backends/photos_change_log_tests.cpp
                     unit_tests_for_backends/photos_tests.cpp
+                    unit_tests_for_backends/series_cache_tests.cpp
                     unit_tests_for_backends/tags_tests.cpp
 
                     # dependencies
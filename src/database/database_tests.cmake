@@ -8,8 +8,10 @@ addTestTarget(database
                     backends/sql_backends/generic_sql_query_constructor.cpp
                     backends/sql_backends/sql_filter_query_generator.cpp
                     backends/sql_backends/query_structs.cpp
+                    database_tools/implementation/duplicates_detector.cpp
                     database_tools/implementation/json_to_backend.cpp
                     database_tools/implementation/photo_info_updater.cpp
+                    database_tools/implementation/photos_analyzer.cpp
                     database_tools/implementation/series_detector.cpp
                     implementation/aphoto_change_log_operator.cpp
                     implementation/filter.cpp
@@ -18,12 +20,18 @@ addTestTarget(database
                     # memory backend linked
 
                     # tests:
+                    unit_tests/adaptive_batch_size_tests.cpp
+                    unit_tests/bitmap_tests.cpp
+                    unit_tests/bk_tree_tests.cpp
                     unit_tests/data_delta_tests.cpp
+                    unit_tests/date_histogram_tests.cpp
                     unit_tests/db_error_tests.cpp
+                    unit_tests/duplicates_detector_tests.cpp
                     unit_tests/generic_sql_query_constructor_tests.cpp
                     unit_tests/json_to_backend_tests.cpp
                     unit_tests/memory_backend_tests.cpp
                     unit_tests/photo_info_updater_tests.cpp
+                    unit_tests/photos_analyzer_tests.cpp
                     unit_tests/sql_filter_query_generator_tests.cpp
                     unit_tests/series_detector_tests.cpp
                     unit_tests/tag_info_collector_tests.cpp
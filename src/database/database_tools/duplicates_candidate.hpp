@@ -0,0 +1,19 @@
+
+#ifndef DUPLICATES_CANDIDATE_HPP_INCLUDED
+#define DUPLICATES_CANDIDATE_HPP_INCLUDED
+
+#include <database/photo_data.hpp>
+
+struct DuplicatesCandidate
+{
+    enum class Type
+    {
+        Exact,              // identical files (same sha256)
+        Similar,            // similar looking photos (perceptual hashes close to each other)
+    };
+
+    Type type;
+    std::vector<Photo::Data> members;       // photo with the highest resolution goes first
+};
+
+#endif // DUPLICATES_CANDIDATE_HPP_INCLUDED
@@ -0,0 +1,54 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DUPLICATESDETECTOR_HPP
+#define DUPLICATESDETECTOR_HPP
+
+#include <QPromise>
+
+#include <database/idatabase.hpp>
+#include <database/photo_data.hpp>
+#include <database_export.h>
+
+#include "duplicates_candidate.hpp"
+
+
+class DATABASE_EXPORT DuplicatesDetector
+{
+    public:
+        struct DATABASE_EXPORT Rules
+        {
+            int maxHashDistance;        // max number of different bits in perceptual hashes of similar photos
+
+            Rules(int maxHashDistance = 6);
+        };
+
+        DuplicatesDetector(Database::IDatabase &, const QPromise<std::vector<DuplicatesCandidate>> * = nullptr);
+
+        std::vector<DuplicatesCandidate> listCandidates(const Rules& = Rules()) const;
+
+    private:
+        Database::IDatabase& m_db;
+        const QPromise<std::vector<DuplicatesCandidate>>* m_promise;
+
+        std::vector<DuplicatesCandidate> analyze_photos(const std::vector<std::vector<Photo::Data>>& identical, const std::vector<Photo::Data>& hashed, const Rules &) const;
+        std::vector<DuplicatesCandidate> findExactDuplicates(const std::vector<std::vector<Photo::Data>>& identical) const;
+        std::vector<DuplicatesCandidate> findSimilar(const std::vector<Photo::Data> &, const Rules &) const;
+};
+
+#endif // DUPLICATESDETECTOR_HPP
@@ -0,0 +1,81 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ADAPTIVE_BATCH_SIZE_HPP_INCLUDED
+#define ADAPTIVE_BATCH_SIZE_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+
+/**
+ * \brief Batch size controller
+ *
+ * Adjusts size of batches so writing each of them takes about targetDuration.
+ * Too small batches waste time on transactions, too big ones block database thread for long.
+ * target() may be read from any thread, reportWrite() is expected to be called from one thread.
+ */
+class AdaptiveBatchSize
+{
+    public:
+        AdaptiveBatchSize(std::size_t initial, std::size_t min, std::size_t max, std::chrono::microseconds targetDuration)
+            : m_target(initial)
+            , m_min(min)
+            , m_max(max)
+            , m_targetDuration(targetDuration)
+        {
+
+        }
+
+        std::size_t target() const
+        {
+            return m_target;
+        }
+
+        void reportWrite(std::size_t batchSize, std::chrono::microseconds duration)
+        {
+            if (batchSize == 0)
+                return;
+
+            const std::size_t current = m_target;
+
+            // small batches (flushed because of latency limit) say little about throughput - use them only to shrink
+            const bool representative = batchSize * 2 >= current;
+            const double perItem = std::max(static_cast<double>(duration.count()) / batchSize, 1.0);
+            const std::size_t ideal = static_cast<std::size_t>(m_targetDuration.count() / perItem);
+
+            if (representative || ideal < current)
+            {
+                // smooth changes so single slow write does not ruin batching
+                const std::size_t next = (current * 3 + ideal) / 4;
+
+                m_target = std::clamp(next, m_min, m_max);
+            }
+        }
+
+    private:
+        std::atomic<std::size_t> m_target;
+        const std::size_t m_min;
+        const std::size_t m_max;
+        const std::chrono::microseconds m_targetDuration;
+};
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BITMAP_HPP_INCLUDED
+#define BITMAP_HPP_INCLUDED
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * \brief Fixed size set of bits
+ *
+ * Bits are packed into 64 bit words so logical operations on whole
+ * bitmaps process 64 items at once (and are easily vectorized by compiler).
+ */
+class Bitmap
+{
+    public:
+        explicit Bitmap(std::size_t size = 0, bool value = false)
+            : m_words((size + WordBits - 1) / WordBits, value? ~Word(0): Word(0))
+            , m_size(size)
+        {
+            clearTail();
+        }
+
+        /**
+         * \brief construct bitmap from predicate
+         * \param size number of bits
+         * \param predicate callable taking bit index and returning its value
+         */
+        template<typename Predicate>
+        static Bitmap fromPredicate(std::size_t size, Predicate&& predicate)
+        {
+            Bitmap bitmap(size);
+
+            for (std::size_t w = 0; w < bitmap.m_words.size(); w++)
+            {
+                const std::size_t first = w * WordBits;
+                const std::size_t bits = std::min(WordBits, size - first);
+                Word word = 0;
+
+                for (std::size_t b = 0; b < bits; b++)
+                    word |= static_cast<Word>(predicate(first + b)? 1: 0) << b;
+
+                bitmap.m_words[w] = word;
+            }
+
+            return bitmap;
+        }
+
+        void set(std::size_t idx, bool value = true)
+        {
+            const Word mask = Word(1) << (idx % WordBits);
+
+            if (value)
+                m_words[idx / WordBits] |= mask;
+            else
+                m_words[idx / WordBits] &= ~mask;
+        }
+
+        bool test(std::size_t idx) const
+        {
+            return (m_words[idx / WordBits] >> (idx % WordBits)) & 1;
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        /**
+         * \brief change number of bits
+         *
+         * Existing bits are preserved, new ones are cleared.
+         */
+        void resize(std::size_t size)
+        {
+            m_words.resize((size + WordBits - 1) / WordBits, Word(0));
+            m_size = size;
+
+            clearTail();
+        }
+
+        std::size_t count() const
+        {
+            std::size_t result = 0;
+
+            for (const Word word: m_words)
+                result += static_cast<std::size_t>(std::popcount(word));
+
+            return result;
+        }
+
+        Bitmap& operator&=(const Bitmap& other)
+        {
+            for (std::size_t w = 0; w < m_words.size(); w++)
+                m_words[w] &= other.m_words[w];
+
+            return *this;
+        }
+
+        Bitmap& operator|=(const Bitmap& other)
+        {
+            for (std::size_t w = 0; w < m_words.size(); w++)
+                m_words[w] |= other.m_words[w];
+
+            return *this;
+        }
+
+        /**
+         * \brief clear bits which are set in other bitmap
+         *
+         * Equivalent of `*this &= ~other` without building negation.
+         */
+        Bitmap& andNot(const Bitmap& other)
+        {
+            for (std::size_t w = 0; w < m_words.size(); w++)
+                m_words[w] &= ~other.m_words[w];
+
+            return *this;
+        }
+
+        Bitmap operator~() const
+        {
+            Bitmap result(*this);
+
+            for (Word& word: result.m_words)
+                word = ~word;
+
+            result.clearTail();
+
+            return result;
+        }
+
+        bool operator==(const Bitmap &) const = default;
+
+        /**
+         * \brief call function for each set bit
+         * \param f callable taking bit index
+         */
+        template<typename F>
+        void forEach(F&& f) const
+        {
+            for (std::size_t w = 0; w < m_words.size(); w++)
+            {
+                Word word = m_words[w];
+
+                while (word != 0)
+                {
+                    const std::size_t b = static_cast<std::size_t>(std::countr_zero(word));
+                    f(w * WordBits + b);
+
+                    word &= word - 1;       // clear lowest set bit
+                }
+            }
+        }
+
+    private:
+        typedef std::uint64_t Word;
+        static constexpr std::size_t WordBits = 64;
+
+        std::vector<Word> m_words;
+        std::size_t m_size;
+
+        // keep bits above size() cleared so count() and operator== may work on whole words
+        void clearTail()
+        {
+            const std::size_t tail = m_size % WordBits;
+
+            if (tail != 0)
+                m_words.back() &= (Word(1) << tail) - 1;
+        }
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BK_TREE_HPP_INCLUDED
+#define BK_TREE_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/**
+ * \brief Burkhard-Keller tree
+ *
+ * Metric tree allowing to find all values within given distance
+ * from queried value without comparing it against all stored values.
+ * \tparam T type of stored values
+ * \tparam Distance functor returning (integral) distance between two values.
+ *         Must satisfy metric's properties (triangle inequality especially).
+ */
+template<typename T, typename Distance>
+class BKTree
+{
+    public:
+        explicit BKTree(Distance distance = Distance())
+            : m_distance(distance)
+        {
+
+        }
+
+        /**
+         * \brief insert value to tree
+         * \return index of inserted value
+         */
+        std::size_t insert(const T& value)
+        {
+            const std::size_t index = m_nodes.size();
+            m_nodes.push_back( {value, {}} );
+
+            if (index > 0)
+            {
+                std::size_t current = 0;
+
+                for(;;)
+                {
+                    const int d = m_distance(m_nodes[current].value, value);
+                    auto& children = m_nodes[current].children;
+
+                    auto it = std::find_if(children.begin(), children.end(), [d](const auto& child)
+                    {
+                        return child.first == d;
+                    });
+
+                    if (it == children.end())
+                    {
+                        children.emplace_back(d, index);
+                        break;
+                    }
+                    else
+                        current = it->second;
+                }
+            }
+
+            return index;
+        }
+
+        /**
+         * \brief find values within given distance
+         * \param value reference value
+         * \param maxDistance maximal (inclusive) distance
+         * \return indices (as returned by insert()) of matching values
+         */
+        std::vector<std::size_t> find(const T& value, int maxDistance) const
+        {
+            std::vector<std::size_t> result;
+
+            if (m_nodes.empty())
+                return result;
+
+            std::vector<std::size_t> toVisit = { 0 };
+
+            while(toVisit.empty() == false)
+            {
+                const std::size_t current = toVisit.back();
+                toVisit.pop_back();
+
+                const Node& node = m_nodes[current];
+                const int d = m_distance(node.value, value);
+
+                if (d <= maxDistance)
+                    result.push_back(current);
+
+                // by triangle inequality only children in range <d - maxDistance, d + maxDistance> may contain matches
+                for(const auto& child: node.children)
+                    if (child.first >= d - maxDistance && child.first <= d + maxDistance)
+                        toVisit.push_back(child.second);
+            }
+
+            return result;
+        }
+
+        const T& value(std::size_t index) const
+        {
+            return m_nodes[index].value;
+        }
+
+        std::size_t size() const
+        {
+            return m_nodes.size();
+        }
+
+    private:
+        struct Node
+        {
+            T value;
+            std::vector<std::pair<int, std::size_t>> children;   // distance -> child index
+        };
+
+        std::vector<Node> m_nodes;
+        Distance m_distance;
+};
+
+#endif
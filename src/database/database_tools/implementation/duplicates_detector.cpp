@@ -0,0 +1,293 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <numeric>
+#include <set>
+
+#include <core/task_executor_utils.hpp>
+#include <ibackend.hpp>
+#include <iphoto_operator.hpp>
+
+#include "database_executor_traits.hpp"
+#include "../duplicates_detector.hpp"
+#include "bk_tree.hpp"
+
+
+namespace
+{
+    constexpr std::size_t FetchChunkSize = 1000;
+
+    class abort_exception: public std::exception {};
+
+    // photos required for detection
+    struct DetectionInput
+    {
+        std::vector<std::vector<Photo::Data>> identical;            // groups of photos with the same content
+        std::vector<Photo::Data> hashed;                            // photos with perceptual hash, one per content
+    };
+
+    // fetch photos in chunks: each chunk costs constant number of queries and keeps them reasonably short
+    std::vector<Photo::Data> fetchPhotos(Database::IBackend& backend, const std::vector<Photo::Id>& photos)
+    {
+        std::vector<Photo::Data> datas;
+        datas.reserve(photos.size());
+
+        for (std::size_t first = 0; first < photos.size(); first += FetchChunkSize)
+        {
+            const std::size_t last = std::min(photos.size(), first + FetchChunkSize);
+            const std::vector<Photo::Id> chunk(photos.begin() + first, photos.begin() + last);
+            const std::vector<Photo::Data> chunkData = backend.getPhotos(chunk);
+
+            datas.insert(datas.end(), chunkData.begin(), chunkData.end());
+        }
+
+        return datas;
+    }
+
+    struct HammingDistance
+    {
+        int operator()(std::uint64_t lhs, std::uint64_t rhs) const
+        {
+            return std::popcount(lhs ^ rhs);
+        }
+    };
+
+    // put photo with the highest resolution first (it is the best candidate to be kept)
+    void sortMembers(DuplicatesCandidate& candidate)
+    {
+        std::stable_sort(candidate.members.begin(), candidate.members.end(), [](const Photo::Data& lhs, const Photo::Data& rhs)
+        {
+            const qint64 lhs_area = static_cast<qint64>(lhs.geometry.width()) * lhs.geometry.height();
+            const qint64 rhs_area = static_cast<qint64>(rhs.geometry.width()) * rhs.geometry.height();
+
+            return lhs_area > rhs_area;
+        });
+    }
+}
+
+
+DuplicatesDetector::Rules::Rules(int maxHashDistance)
+    : maxHashDistance(maxHashDistance)
+{
+
+}
+
+
+DuplicatesDetector::DuplicatesDetector(Database::IDatabase& db, const QPromise<std::vector<DuplicatesCandidate>>* p)
+    : m_db(db)
+    , m_promise(p)
+{
+
+}
+
+
+std::vector<DuplicatesCandidate> DuplicatesDetector::listCandidates(const Rules& rules) const
+{
+    const DetectionInput input =
+        evaluate<DetectionInput(Database::IBackend &)>(m_db, [](Database::IBackend& backend)
+    {
+        DetectionInput input;
+
+        // do not look for duplicates among groups' members (representatives are generated from them)
+        const Database::FilterPhotosWithRole group_filter(Database::FilterPhotosWithRole::Role::Regular);
+
+        // identical photos are found with sha256 index, so only they need to be loaded
+        const std::vector<std::vector<Photo::Id>> duplicates = backend.photoOperator().findDuplicates(group_filter);
+
+        std::vector<Photo::Id> duplicatedIds;
+        std::set<Photo::Id> redundant;                      // photos with content represented by another photo
+
+        for (const auto& group: duplicates)
+        {
+            duplicatedIds.insert(duplicatedIds.end(), group.begin(), group.end());
+            redundant.insert(std::next(group.begin()), group.end());
+        }
+
+        std::map<Photo::Id, Photo::Data> duplicatedPhotos;
+
+        for (const Photo::Data& data: fetchPhotos(backend, duplicatedIds))
+            duplicatedPhotos.emplace(data.id, data);
+
+        for (const auto& group: duplicates)
+        {
+            std::vector<Photo::Data>& identical = input.identical.emplace_back();
+
+            for (const Photo::Id& id: group)
+            {
+                const auto it = duplicatedPhotos.find(id);
+
+                if (it != duplicatedPhotos.end())
+                    identical.push_back(it->second);
+            }
+        }
+
+        // similar photos are looked for among photos with perceptual hash, one per content
+        const Database::FilterPhotosWithFlags phash_filter({ { Photo::FlagsE::PHashLoaded, 1 } });
+
+        std::vector<Photo::Id> hashed = backend.photoOperator().getPhotos(Database::GroupFilter({group_filter, phash_filter}));
+        std::erase_if(hashed, [&redundant](const Photo::Id& id) { return redundant.contains(id); });
+
+        input.hashed = fetchPhotos(backend, hashed);
+
+        return input;
+    });
+
+    return analyze_photos(input.identical, input.hashed, rules);
+}
+
+
+std::vector<DuplicatesCandidate> DuplicatesDetector::analyze_photos(const std::vector<std::vector<Photo::Data>>& identical,
+                                                                    const std::vector<Photo::Data>& hashed,
+                                                                    const Rules& rules) const
+{
+    try
+    {
+        auto exact = findExactDuplicates(identical);
+        auto similar = findSimilar(hashed, rules);
+
+        std::vector<DuplicatesCandidate> candidates;
+        candidates.reserve(exact.size() + similar.size());
+
+        std::move(exact.begin(), exact.end(), std::back_inserter(candidates));
+        std::move(similar.begin(), similar.end(), std::back_inserter(candidates));
+
+        return candidates;
+    }
+    catch (const abort_exception &)
+    {
+        return {};
+    }
+}
+
+
+std::vector<DuplicatesCandidate> DuplicatesDetector::findExactDuplicates(const std::vector<std::vector<Photo::Data>>& identical) const
+{
+    std::vector<DuplicatesCandidate> results;
+
+    for (const auto& photos: identical)
+    {
+        if (m_promise && m_promise->isCanceled())
+            throw abort_exception();
+
+        // some members might have been removed in the meantime
+        if (photos.size() < 2)
+            continue;
+
+        DuplicatesCandidate candidate;
+        candidate.type = DuplicatesCandidate::Type::Exact;
+        candidate.members = photos;
+
+        sortMembers(candidate);
+        results.push_back(candidate);
+    }
+
+    return results;
+}
+
+
+std::vector<DuplicatesCandidate> DuplicatesDetector::findSimilar(const std::vector<Photo::Data>& photos, const Rules& rules) const
+{
+    // Index perceptual hashes in BK-tree so each lookup visits only a small part of collection
+    BKTree<std::uint64_t, HammingDistance> tree;
+    std::vector<std::size_t> treeToPhoto;
+
+    for (std::size_t idx = 0; idx < photos.size(); idx++)
+    {
+        const Photo::PHashT& phash = photos[idx].phash;
+
+        if (phash.valid())
+        {
+            tree.insert(phash.value());
+            treeToPhoto.push_back(idx);
+        }
+    }
+
+    // Photos are grouped around representatives (the best photos are taken first).
+    // A photo joins a group only when it is similar to all of its members, so whichever member
+    // is kept, all removed ones are similar to it (no chaining of A~B, B~C into A~C).
+    std::vector<std::size_t> order(tree.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(), [&photos, &treeToPhoto](std::size_t lhs, std::size_t rhs)
+    {
+        const QSize& lhs_size = photos[treeToPhoto[lhs]].geometry;
+        const QSize& rhs_size = photos[treeToPhoto[rhs]].geometry;
+
+        return static_cast<qint64>(lhs_size.width()) * lhs_size.height() > static_cast<qint64>(rhs_size.width()) * rhs_size.height();
+    });
+
+    const HammingDistance distance;
+    std::vector<bool> assigned(tree.size(), false);
+    std::vector<DuplicatesCandidate> results;
+
+    for (const std::size_t representative: order)
+    {
+        if (m_promise && m_promise->isCanceled())
+            throw abort_exception();
+
+        if (assigned[representative])
+            continue;
+
+        assigned[representative] = true;
+
+        auto neighbours = tree.find(tree.value(representative), rules.maxHashDistance);
+
+        // try the most similar ones first
+        std::sort(neighbours.begin(), neighbours.end(), [&tree, &distance, representative](std::size_t lhs, std::size_t rhs)
+        {
+            return std::make_pair(distance(tree.value(representative), tree.value(lhs)), lhs) <
+                   std::make_pair(distance(tree.value(representative), tree.value(rhs)), rhs);
+        });
+
+        std::vector<std::size_t> group = { representative };
+
+        for (const std::size_t neighbour: neighbours)
+        {
+            if (assigned[neighbour])
+                continue;
+
+            const bool similarToAll = std::all_of(group.begin(), group.end(), [&](std::size_t member)
+            {
+                return distance(tree.value(member), tree.value(neighbour)) <= rules.maxHashDistance;
+            });
+
+            if (similarToAll)
+            {
+                group.push_back(neighbour);
+                assigned[neighbour] = true;
+            }
+        }
+
+        if (group.size() > 1)
+        {
+            DuplicatesCandidate candidate;
+            candidate.type = DuplicatesCandidate::Type::Similar;
+
+            for (const std::size_t member: group)
+                candidate.members.push_back(photos[treeToPhoto[member]]);
+
+            sortMembers(candidate);
+            results.push_back(candidate);
+        }
+    }
+
+    return results;
+}
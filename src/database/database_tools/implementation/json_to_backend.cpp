@@ -65,7 +65,7 @@ namespace Database
         for(auto it = photo.constBegin(); it != photo.constEnd(); ++it)
         {
             if (it.key() == "checksum")
-                delta.insert<Photo::Field::Checksum>(it.value().toString().toUtf8());
+                delta.insert<Photo::Field::Checksum>(QByteArray::fromHex(it.value().toString().toLatin1()));     // checksums are kept as hex strings in json
             else if (it.key() == "flags")
             {
                 // TODO: implement
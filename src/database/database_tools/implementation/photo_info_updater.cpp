@@ -7,17 +7,18 @@
 #include <ranges>
 
 #include <QImage>
-#include <QFile>
 #include <QPixmap>
-#include <QCryptographicHash>
+#include <QVariant>
 
+#include <core/constants.hpp>
+#include <core/file_hash.hpp>
 #include <core/function_wrappers.hpp>
 #include <core/icore_factory_accessor.hpp>
 #include <core/iconfiguration.hpp>
-#include <core/iexif_reader.hpp>
 #include <core/ilogger_factory.hpp>
 #include <core/ilogger.hpp>
-#include <core/imedia_information.hpp>
+#include <core/image_tools.hpp>
+#include <core/media_types.hpp>
 #include <core/tag.hpp>
 #include <core/task_executor.hpp>
 
@@ -27,7 +28,9 @@
 
 struct UpdaterTask: ITaskExecutor::ITask
 {
-    UpdaterTask(PhotoInfoUpdater* updater): m_updater(updater)
+    UpdaterTask(PhotoInfoUpdater* updater, const Photo::Id& id):
+        m_updater(updater),
+        m_id(id)
     {
 
     }
@@ -37,31 +40,52 @@ struct UpdaterTask: ITaskExecutor::ITask
         m_updater->taskFinished(this);
     }
 
+    // results go straight to updater's cache (no gui thread involved), it sends them to db thread in batches
     void apply(const Photo::DataDelta& delta)
     {
-        invokeMethod(m_updater, &PhotoInfoUpdater::apply, delta);
+        m_updater->apply(delta);
     }
 
     void apply(const Photo::Id& id, const std::pair<QString, int>& generic_flag)
     {
-        invokeMethod(m_updater, &PhotoInfoUpdater::applyFlags, id, generic_flag);
+        m_updater->applyFlags(id, generic_flag);
     }
 
     UpdaterTask(const UpdaterTask &) = delete;
     UpdaterTask& operator=(const UpdaterTask &) = delete;
 
     PhotoInfoUpdater* m_updater;
+    const Photo::Id m_id;
 };
 
 
 namespace
 {
+    // Changes are written in batches which should take about WriteDuration to be stored
+    // (long db tasks block other clients). No change waits longer than MaxLatency.
+    constexpr std::chrono::milliseconds WriteDuration(50);
+    constexpr std::chrono::milliseconds MaxLatency(2000);
+    constexpr std::size_t InitialBatchSize = 100;
+    constexpr std::size_t MinBatchSize = 10;
+    constexpr std::size_t MaxBatchSize = 2000;
+
+    // hashing is I/O bound. Do not read too many files at once
+    // as spinning disks would spend all time on seeking.
+    constexpr int DefaultHashingTasks = 2;
+
+    int maxHashingTasks(IConfiguration& configuration)
+    {
+        const int configured = configuration.getEntry(PhotosAnalyzerConfigKeys::maxHashingTasks).toInt();
+
+        return configured > 0? configured: DefaultHashingTasks;
+    }
+
 
     struct Sha256Assigner: UpdaterTask
     {
         Sha256Assigner(PhotoInfoUpdater* updater,
                        const Photo::Data& photoInfo):
-            UpdaterTask(updater),
+            UpdaterTask(updater, photoInfo.id),
             m_photoInfo(photoInfo)
         {
         }
@@ -76,145 +100,160 @@ namespace
 
         virtual void perform() override
         {
-            QFile file(m_photoInfo.path);
-            bool status = file.open(QFile::ReadOnly);
-            assert(status);
-
-            QCryptographicHash hasher(QCryptographicHash::Sha256);
-            status = hasher.addData(&file);
-            assert(status);
+            const std::optional<QByteArray> hash = FileHash::sha256(m_photoInfo.path);
 
-            const QByteArray rawHash = hasher.result();
-            const QByteArray hexHash = rawHash.toHex();
-
-            assert(hexHash.isEmpty() == false);
+            if (hash.has_value())
+            {
+                assert(hash->isEmpty() == false);
 
-            Photo::DataDelta delta(m_photoInfo.id);
-            delta.insert<Photo::Field::Checksum>(hexHash);
-            delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::Sha256Loaded, 1}} );
+                Photo::DataDelta delta(m_photoInfo.id);
+                delta.insert<Photo::Field::Checksum>(*hash);
+                delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::Sha256Loaded, 1}} );
 
-            apply(delta);
+                apply(delta);
+            }
+            else
+                apply(m_photoInfo.id, {
+                    Database::CommonGeneralFlags::State,
+                    static_cast<int>(Database::CommonGeneralFlags::StateType::Broken)
+                });
         }
 
         Photo::Data m_photoInfo;
     };
 
 
-    struct GeometryAssigner: UpdaterTask
+    struct PHashAssigner: UpdaterTask
     {
-        GeometryAssigner(PhotoInfoUpdater* updater,
-                         IMediaInformation* photoInformation,
-                         const Photo::Data& photoInfo):
-            UpdaterTask(updater),
-            m_photoInfo(photoInfo),
-            m_mediaInformation(photoInformation)
+        PHashAssigner(PhotoInfoUpdater* updater,
+                      const Photo::Data& photoInfo):
+            UpdaterTask(updater, photoInfo.id),
+            m_photoInfo(photoInfo)
         {
         }
 
-        GeometryAssigner(const GeometryAssigner &) = delete;
-        GeometryAssigner& operator=(const GeometryAssigner &) = delete;
+        PHashAssigner(const PHashAssigner &) = delete;
+        PHashAssigner& operator=(const PHashAssigner &) = delete;
 
         virtual std::string name() const override
         {
-            return "Photo geometry setter";
+            return "Photo perceptual hash generation";
         }
 
         virtual void perform() override
         {
-            const std::optional<QSize> size = m_mediaInformation->size(m_photoInfo.path);
+            Photo::DataDelta delta(m_photoInfo.id);
 
-            if (size.has_value())
+            // perceptual hash is calculated for images only.
+            // For other files just mark hash as loaded so they won't be processed again.
+            if (MediaTypes::isImageFile(m_photoInfo.path))
             {
-                Photo::DataDelta delta(m_photoInfo.id);
-                delta.insert<Photo::Field::Geometry>(*size);
-                delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::GeometryLoaded, 1}} );
+                const QImage image = Image::loadForHashing(m_photoInfo.path);
 
-                apply(delta);
+                if (image.isNull() == false)
+                    delta.insert<Photo::Field::PHash>(Photo::PHashT(Image::dHash(image)));
             }
-            else
-            {
-                Photo::DataDelta delta(m_photoInfo.id);
 
-                apply(m_photoInfo.id, {
-                    Database::CommonGeneralFlags::State,
-                    static_cast<int>(Database::CommonGeneralFlags::StateType::Broken)
-                });
-            }
+            delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::PHashLoaded, 1}} );
+
+            apply(delta);
         }
 
         Photo::Data m_photoInfo;
-        IMediaInformation* m_mediaInformation;
     };
 
 
-    struct TagsCollector: UpdaterTask
+    // collects tags and geometry in one go so file is opened and parsed once
+    struct MetadataCollector: UpdaterTask
     {
-        TagsCollector(PhotoInfoUpdater* updater, IExifReaderFactory& exifReaderFactory, const Photo::Data& photoInfo):
-            UpdaterTask(updater),
+        MetadataCollector(PhotoInfoUpdater* updater, const MediaMetadataExtractor& extractor, const Photo::Data& photoInfo):
+            UpdaterTask(updater, photoInfo.id),
             m_photoInfo(photoInfo),
-            m_exifReaderFactory(exifReaderFactory)
+            m_extractor(extractor)
         {
         }
 
-        TagsCollector(const TagsCollector &) = delete;
-        TagsCollector& operator=(const TagsCollector &) = delete;
+        MetadataCollector(const MetadataCollector &) = delete;
+        MetadataCollector& operator=(const MetadataCollector &) = delete;
 
         virtual std::string name() const override
         {
-            return "Photo tags collection";
+            return "Photo metadata collection";
         }
 
         virtual void perform() override
         {
-            IExifReader& feeder = m_exifReaderFactory.get();
-
-            // collect data
-            const Tag::TagsList new_tags = feeder.getTagsFor(m_photoInfo.path);
-            const Tag::TagsList cur_tags = m_photoInfo.tags;
-            Photo::FlagValues cur_flags = m_photoInfo.flags;
+            const MediaMetadata metadata = m_extractor.extract(m_photoInfo.path);
 
-            // merge new_tags with cur_tags
-            Tag::TagsList tags = cur_tags;
+            Photo::DataDelta delta(m_photoInfo.id);
+            Photo::FlagValues flags = m_photoInfo.flags;
 
-            for (const auto& entry: new_tags)
+            if (needs(Photo::FlagsE::ExifLoaded))
             {
-                auto it = tags.find(entry.first);
+                // merge new tags with current ones
+                Tag::TagsList tags = m_photoInfo.tags;
+
+                for (const auto& entry: metadata.tags)
+                {
+                    auto it = tags.find(entry.first);
 
-                if (it == tags.end())   // no such tag yet?
-                    tags.insert(entry);
+                    if (it == tags.end())   // no such tag yet?
+                        tags.insert(entry);
+                }
+
+                flags[Photo::FlagsE::ExifLoaded] = 1;
+                delta.insert<Photo::Field::Tags>(tags);
             }
 
-            // update flags
-            Photo::FlagValues flags = cur_flags;
-            flags[Photo::FlagsE::ExifLoaded] = 1;
+            if (needs(Photo::FlagsE::GeometryLoaded))
+            {
+                if (metadata.size.has_value())
+                {
+                    flags[Photo::FlagsE::GeometryLoaded] = 1;
+                    delta.insert<Photo::Field::Geometry>(*metadata.size);
+                }
+                else
+                    apply(m_photoInfo.id, {
+                        Database::CommonGeneralFlags::State,
+                        static_cast<int>(Database::CommonGeneralFlags::StateType::Broken)
+                    });
+            }
 
-            // store new data
-            Photo::DataDelta delta(m_photoInfo.id);
-            delta.insert<Photo::Field::Tags>(tags);
-            delta.insert<Photo::Field::Flags>(flags);
+            if (flags != m_photoInfo.flags)
+            {
+                delta.insert<Photo::Field::Flags>(flags);
+                apply(delta);
+            }
+        }
 
-            apply(delta);
+        bool needs(Photo::FlagsE flag) const
+        {
+            auto it = m_photoInfo.flags.find(flag);
+
+            return it == m_photoInfo.flags.end() || it->second == 0;
         }
 
         Photo::Data m_photoInfo;
-        IExifReaderFactory& m_exifReaderFactory;
+        const MediaMetadataExtractor& m_extractor;
     };
 
 }
 
 
 PhotoInfoUpdater::PhotoInfoUpdater(ICoreFactoryAccessor* coreFactory, Database::IDatabase& db):
-    m_mediaInformation(coreFactory),
+    m_metadataExtractor(coreFactory),
+    m_batchSize(std::make_shared<AdaptiveBatchSize>(InitialBatchSize, MinBatchSize, MaxBatchSize, WriteDuration)),
     m_tasks(),
     m_tasksMutex(),
     m_finishedTask(),
-    m_threadId(std::this_thread::get_id()),
     m_logger(coreFactory->getLoggerFactory().get("PhotoInfoUpdater")),
     m_coreFactory(coreFactory),
     m_db(db),
-    m_tasksExecutor(coreFactory->getTaskExecutor())
+    m_tasksExecutor(coreFactory->getTaskExecutor()),
+    m_hashingQueue(&m_tasksExecutor, maxHashingTasks(coreFactory->getConfiguration()))
 {
     m_cacheFlushTimer.setSingleShot(true);
+    m_cacheFlushTimer.setInterval(MaxLatency);
 
     connect(&m_cacheFlushTimer, &QTimer::timeout, this, &PhotoInfoUpdater::flushCache);
 }
@@ -230,21 +269,21 @@ void PhotoInfoUpdater::updateSha256(const Photo::Data& photoInfo)
 {
     auto task = std::make_unique<Sha256Assigner>(this, photoInfo);
 
-    addTask(std::move(task));
+    addTask(std::move(task), m_hashingQueue);
 }
 
 
-void PhotoInfoUpdater::updateGeometry(const Photo::Data& photoInfo)
+void PhotoInfoUpdater::updatePHash(const Photo::Data& photoInfo)
 {
-    auto task = std::make_unique<GeometryAssigner>(this, &m_mediaInformation, photoInfo);
+    auto task = std::make_unique<PHashAssigner>(this, photoInfo);
 
     addTask(std::move(task));
 }
 
 
-void PhotoInfoUpdater::updateTags(const Photo::Data& photoInfo)
+void PhotoInfoUpdater::updateMetadata(const Photo::Data& photoInfo)
 {
-    auto task = std::make_unique<TagsCollector>(this, m_coreFactory->getExifReaderFactory(), photoInfo);
+    auto task = std::make_unique<MetadataCollector>(this, m_metadataExtractor, photoInfo);
 
     addTask(std::move(task));
 }
@@ -252,6 +291,8 @@ void PhotoInfoUpdater::updateTags(const Photo::Data& photoInfo)
 
 int PhotoInfoUpdater::tasksInProgress()
 {
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
+
     return static_cast<int>(m_tasks.size());
 }
 
@@ -270,45 +311,54 @@ void PhotoInfoUpdater::waitForActiveTasks()
 
 
 void PhotoInfoUpdater::addTask(std::unique_ptr<UpdaterTask> task)
+{
+    addTask(std::move(task), m_tasksExecutor);
+}
+
+
+void PhotoInfoUpdater::addTask(std::unique_ptr<UpdaterTask> task, ITaskExecutor& executor)
 {
     {
         std::lock_guard<std::mutex> lock(m_tasksMutex);
         m_tasks.insert(task.get());
     }
 
-    m_tasksExecutor.add(std::move(task));
+    executor.add(std::move(task));
 }
 
 
 void PhotoInfoUpdater::taskFinished(UpdaterTask* task)
 {
-    {
-        std::lock_guard<std::mutex> lock(m_tasksMutex);
-        m_tasks.erase(task);
-    }
+    // emit before task is unregistered: waitForActiveTasks() may return
+    // (and its caller may destroy us) as soon as m_tasks gets empty
+    emit photoProcessed(task->m_id);
 
-    m_finishedTask.notify_one();
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
+    m_tasks.erase(task);
+
+    // nothing more to come soon - store what we have
+    if (m_tasks.empty())
+        flushCache();
 
-    emit photoProcessed();
+    m_finishedTask.notify_one();
 }
 
 
 void PhotoInfoUpdater::apply(const Photo::DataDelta& delta)
 {
-    assert(m_threadId == std::this_thread::get_id());
-
-    m_touchedPhotos[delta.getId()] |= delta;
+    std::unique_lock<std::mutex> lock(m_cacheMutex);
 
-    // when cache has too many changes, let timer fire to flush cache
-    const bool runs = m_cacheFlushTimer.isActive();
-    const bool canKick = m_cacheFlushTimer.interval() - m_cacheFlushTimer.remainingTime() > 1000; // time since last kick > 1s?
-    const std::size_t count = m_touchedPhotos.size();
-
-    if (count < 500 && (runs == false || canKick))
+    if (m_touchedPhotos.empty())
     {
-        resetFlushTimer();
-        m_logger->debug(QString("Restarting flush timer. %1 photos waiting for flush").arg(count));
+        // latency is counted from the oldest change, timer is not restarted by further changes
+        m_oldestChange = std::chrono::steady_clock::now();
+        invokeMethod(this, &PhotoInfoUpdater::startFlushTimer);
     }
+
+    m_touchedPhotos[delta.getId()] |= delta;
+
+    if (m_touchedPhotos.size() >= m_batchSize->target())
+        flushCache(lock);
 }
 
 
@@ -321,24 +371,46 @@ void PhotoInfoUpdater::applyFlags(const Photo::Id& id, const std::pair<QString,
 }
 
 
+void PhotoInfoUpdater::startFlushTimer()
+{
+    // timer may be still running for changes which were flushed already - it will just flush earlier
+    if (m_cacheFlushTimer.isActive() == false)
+        m_cacheFlushTimer.start();
+}
+
+
 void PhotoInfoUpdater::flushCache()
 {
+    std::unique_lock<std::mutex> lock(m_cacheMutex);
+    flushCache(lock);
+}
+
+
+void PhotoInfoUpdater::flushCache(std::unique_lock<std::mutex>& lock)
+{
+    assert(lock.owns_lock());
+
     if (m_touchedPhotos.empty() == false)
     {
-        m_logger->debug(QString("Sending %1 photos to update").arg(m_touchedPhotos.size()));
+        const auto timeInQueue = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_oldestChange);
 
-        m_db.exec([delta = std::move(m_touchedPhotos)](Database::IBackend& db)
+        m_logger->debug(QString("Sending %1 photos to update. Oldest change waited %2ms. Current batch size target: %3")
+                        .arg(m_touchedPhotos.size())
+                        .arg(timeInQueue.count())
+                        .arg(m_batchSize->target()));
+
+        m_db.exec([delta = std::move(m_touchedPhotos), batchSize = m_batchSize](Database::IBackend& db)
         {
             const auto deltaValues = std::views::values(delta);
             const std::vector<Photo::DataDelta> vectorOfDeltas(deltaValues.begin(), deltaValues.end());
 
+            const auto start = std::chrono::steady_clock::now();
             db.update(vectorOfDeltas);
-        });
-    }
-}
+            const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
 
+            batchSize->reportWrite(vectorOfDeltas.size(), duration);
+        });
 
-void PhotoInfoUpdater::resetFlushTimer()
-{
-    m_cacheFlushTimer.start(5000);
+        m_touchedPhotos.clear();
+    }
 }
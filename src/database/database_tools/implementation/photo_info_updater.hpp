@@ -2,16 +2,20 @@
 #ifndef GUI_PHOTO_INFO_UPDATER_HPP
 #define GUI_PHOTO_INFO_UPDATER_HPP
 
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <QTimer>
 
 #include <core/exif_reader_factory.hpp>
 #include <core/itask_executor.hpp>
-#include <core/media_information.hpp>
+#include <core/media_metadata_extractor.hpp>
+#include <core/task_executor_utils.hpp>
 #include <database/iphoto_info.hpp>
 #include <database/idatabase.hpp>
 
+#include "adaptive_batch_size.hpp"
+
 struct ICoreFactoryAccessor;
 
 struct UpdaterTask;
@@ -30,8 +34,8 @@ class PhotoInfoUpdater final: public QObject
         PhotoInfoUpdater& operator=(const PhotoInfoUpdater &) = delete;
 
         void updateSha256(const Photo::Data &);
-        void updateGeometry(const Photo::Data &);
-        void updateTags(const Photo::Data &);
+        void updatePHash(const Photo::Data &);
+        void updateMetadata(const Photo::Data &);      // tags and geometry
 
         int tasksInProgress();
         void waitForActiveTasks();
@@ -40,27 +44,32 @@ class PhotoInfoUpdater final: public QObject
         friend struct UpdaterTask;
         typedef std::map<Photo::Id, Photo::DataDelta> TouchedPhotos;
 
-        MediaInformation m_mediaInformation;
-        TouchedPhotos m_touchedPhotos;
+        MediaMetadataExtractor m_metadataExtractor;
+        TouchedPhotos m_touchedPhotos;                      // guarded by m_cacheMutex
+        std::chrono::steady_clock::time_point m_oldestChange;
+        std::mutex m_cacheMutex;
+        std::shared_ptr<AdaptiveBatchSize> m_batchSize;
         QTimer m_cacheFlushTimer;
         std::set<UpdaterTask *> m_tasks;
         std::mutex m_tasksMutex;
         std::condition_variable m_finishedTask;
-        std::thread::id m_threadId;
         std::unique_ptr<ILogger> m_logger;
         ICoreFactoryAccessor* m_coreFactory;
         Database::IDatabase& m_db;
         ITaskExecutor& m_tasksExecutor;
+        TasksQueue m_hashingQueue;
 
         void addTask(std::unique_ptr<UpdaterTask>);
+        void addTask(std::unique_ptr<UpdaterTask>, ITaskExecutor &);
         void taskFinished(UpdaterTask *);
         void apply(const Photo::DataDelta &);
         void applyFlags(const Photo::Id &, const std::pair<QString, int>& generic_flag);
+        void startFlushTimer();
         void flushCache();
-        void resetFlushTimer();
+        void flushCache(std::unique_lock<std::mutex> &);
 
     signals:
-        void photoProcessed();
+        void photoProcessed(const Photo::Id &);       // emitted when one of photo's tasks is done
 };
 
 #endif
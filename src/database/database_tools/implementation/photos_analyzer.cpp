@@ -17,7 +17,10 @@
  *
  */
 
-#include <core/function_wrappers.hpp>
+#include <algorithm>
+#include <cassert>
+#include <set>
+
 #include <core/icore_factory_accessor.hpp>
 #include <core/itask_executor.hpp>
 #include <database/iphoto_operator.hpp>
@@ -27,21 +30,58 @@
 #include "../photos_analyzer.hpp"
 
 
+namespace
+{
+    // max number of photos fetched from database at once
+    constexpr std::size_t MaxBatchSize = 64;
+
+    // number of interrupted analyses after which photo is analyzed after all others
+    // (journal does not count beyond this value)
+    constexpr int MaxInterruptedAnalyses = 2;
+
+    bool isSet(const Photo::Data& photo, Photo::FlagsE flag)
+    {
+        auto it = photo.flags.find(flag);
+
+        return it != photo.flags.end() && it->second != 0;
+    }
+
+    // photo id -> number of interrupted analyses
+    std::map<Photo::Id, int> readJournal(Database::IBackend& backend)
+    {
+        std::map<Photo::Id, int> journal;
+
+        for (int attempts = 1; attempts <= MaxInterruptedAnalyses; attempts++)
+        {
+            const Database::FilterPhotosWithGeneralFlag filter(Database::CommonGeneralFlags::AnalysisAttempts, attempts);
+            const auto photos = backend.photoOperator().getPhotos(filter);
+
+            for (const Photo::Id& id: photos)
+                journal.emplace(id, attempts);
+        }
+
+        return journal;
+    }
+}
+
+
 PhotosAnalyzerImpl::PhotosAnalyzerImpl(ICoreFactoryAccessor* coreFactory, Database::IDatabase& database):
     m_updater(coreFactory, database),
-    m_timer(),
     m_database(database),
     m_tasksView(nullptr),
     m_viewTask(nullptr),
-    m_maxTasks(0),
-    m_workers(coreFactory->getTaskExecutor().heavyWorkers()),
-    m_loadingPhotos(false)
+    m_maxPending(0),
+    m_tasksInFlight(0),
+    m_dbTasks(1),                   // initial scan
+    m_highWatermark(std::max(coreFactory->getTaskExecutor().heavyWorkers(), 1) * 8),
+    m_lowWatermark(m_highWatermark / 2),
+    m_refreshPending(false),
+    m_fetching(false),
+    m_stopped(false)
 {
-    connect(&m_timer, &QTimer::timeout, this, &PhotosAnalyzerImpl::refreshView);
+    // called from worker threads, so next batch can be scheduled without waiting for event loop
     connect(&m_updater, &PhotoInfoUpdater::photoProcessed,
-            this, &PhotosAnalyzerImpl::processPhotos);
-
-    m_timer.start(500);
+            this, &PhotosAnalyzerImpl::taskFinished, Qt::DirectConnection);
 
     //check for not fully initialized photos in database
     //TODO: use independent updaters here (issue #102)
@@ -49,7 +89,7 @@ PhotosAnalyzerImpl::PhotosAnalyzerImpl(ICoreFactoryAccessor* coreFactory, Databa
     Database::FilterPhotosWithFlags flags_filter;
     flags_filter.mode = Database::FilterPhotosWithFlags::Mode::Or;
 
-    for (auto flag : { Photo::FlagsE::ExifLoaded, Photo::FlagsE::GeometryLoaded })
+    for (auto flag : { Photo::FlagsE::ExifLoaded, Photo::FlagsE::GeometryLoaded, Photo::FlagsE::Sha256Loaded, Photo::FlagsE::PHashLoaded })
         flags_filter.flags[flag] = 0;            //uninitialized
 
     // only normal photos
@@ -60,14 +100,27 @@ PhotosAnalyzerImpl::PhotosAnalyzerImpl(ICoreFactoryAccessor* coreFactory, Databa
 
     m_database.exec([this, filters](Database::IBackend& backend)
     {
-        auto photos = backend.photoOperator().getPhotos(filters);
+        bool stopped = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            stopped = m_stopped;
+        }
+
+        if (stopped == false)
+        {
+            const auto photos = backend.photoOperator().getPhotos(filters);
 
-        invokeMethod(this, &PhotosAnalyzerImpl::addPhotos, photos);
+            resume(backend, photos);
 
-        // as all uninitialized photos were found.
-        // start watching for any new photos added later.
-        m_backendConnection = connect(&backend, &Database::IBackend::photosAdded,
-                                      this, &PhotosAnalyzerImpl::addPhotos);
+            // as all uninitialized photos were found.
+            // start watching for any new photos added later.
+            m_backendConnection = connect(&backend, &Database::IBackend::photosAdded,
+                                          this, &PhotosAnalyzerImpl::addPhotos, Qt::DirectConnection);
+        }
+
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        dbTaskFinished(lock);
     });
 }
 
@@ -93,73 +146,332 @@ Database::IDatabase& PhotosAnalyzerImpl::getDatabase()
 }
 
 
+void PhotosAnalyzerImpl::resume(Database::IBackend& backend, const std::vector<Photo::Id>& photos)
+{
+    const std::map<Photo::Id, int> journal = readJournal(backend);
+
+    std::vector<std::pair<Photo::Id, int>> interrupted;
+    std::vector<std::pair<Photo::Id, int>> deferred;
+    std::vector<Photo::Id> remaining;
+    std::map<Photo::Id, int> closedEntries;
+
+    for (const Photo::Id& id: photos)
+    {
+        auto it = journal.find(id);
+
+        if (it == journal.end())
+            remaining.push_back(id);
+        else if (it->second >= MaxInterruptedAnalyses)
+        {
+            // analysis of this photo was interrupted many times (it may be crashing application).
+            // Do not let it hold back others, but do not give up on it either - crash might have been caused by something else.
+            deferred.push_back(*it);
+        }
+        else
+            interrupted.push_back(*it);
+    }
+
+    // stale entries (photo was analyzed or is not analyzed anymore)
+    const std::set<Photo::Id> pending(photos.begin(), photos.end());
+
+    for (const auto& [id, attempts]: journal)
+        if (pending.contains(id) == false)
+            closedEntries.emplace(id, 0);
+
+    if (closedEntries.empty() == false)
+        backend.set(Database::CommonGeneralFlags::AnalysisAttempts, closedEntries);
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_interruptedPhotos.insert(m_interruptedPhotos.end(), interrupted.begin(), interrupted.end());
+        m_deferredPhotos.insert(m_deferredPhotos.end(), deferred.begin(), deferred.end());
+    }
+
+    addPhotos(remaining);
+}
+
+
 void PhotosAnalyzerImpl::addPhotos(const std::vector<Photo::Id>& ids)
 {
-    m_photosToUpdate.insert(m_photosToUpdate.end(), ids.begin(), ids.end());
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    if (m_stopped == false)
+    {
+        m_photosToUpdate.insert(m_photosToUpdate.end(), ids.begin(), ids.end());
+        fetchNextBatch(lock);
+    }
+
+    requestRefresh();
+}
+
+
+void PhotosAnalyzerImpl::taskFinished(const Photo::Id& id)
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    assert(m_tasksInFlight > 0);
+    m_tasksInFlight--;
+
+    auto it = m_tasksPerPhoto.find(id);
+    assert(it != m_tasksPerPhoto.end());
+
+    if (--it->second == 0)
+    {
+        m_tasksPerPhoto.erase(it);
+        m_analyzedPhotos.push_back(id);
+    }
+
+    if (m_tasksInFlight < m_lowWatermark)
+        fetchNextBatch(lock);
 
-    processPhotos();
+    // no more batches to piggyback on
+    if (m_tasksInFlight == 0 && m_fetching == false)
+        closeJournalEntries(lock);
+
+    requestRefresh();
 }
 
 
-void PhotosAnalyzerImpl::processPhotos()
+void PhotosAnalyzerImpl::fetchNextBatch(std::unique_lock<std::mutex>& lock)
 {
-    if (m_loadingPhotos == false &&
-        m_photosToUpdate.empty() == false &&
-        m_updater.tasksInProgress() < m_workers * 2)
+    assert(lock.owns_lock());
+
+    if (m_stopped || m_fetching || m_tasksInFlight >= m_highWatermark)
+        return;
+
+    // photo id -> analysis attempt number
+    std::map<Photo::Id, int> batch;
+
+    // photos which were being analyzed during abnormal exit are processed in isolation
+    // so the one causing crash does not drag down others with it
+    auto isolated = [this, &batch](std::deque<std::pair<Photo::Id, int>>& queue)
     {
-        m_loadingPhotos = true;
+        if (m_tasksInFlight > 0)
+            return;
 
-        std::vector<Photo::Id> photosToProcess;
-        const int toProcess = std::min(m_photosToUpdate.size(), m_workers);
+        const auto& [id, attempts] = queue.front();
+        batch.emplace(id, std::min(attempts + 1, MaxInterruptedAnalyses));
+        queue.pop_front();
+    };
+
+    if (m_interruptedPhotos.empty() == false)
+        isolated(m_interruptedPhotos);
+    else if (m_photosToUpdate.empty() == false)
+    {
+        const std::size_t toProcess = std::min(m_photosToUpdate.size(), MaxBatchSize);
+
+        for (auto it = m_photosToUpdate.begin(); it != m_photosToUpdate.begin() + toProcess; ++it)
+            batch.emplace(*it, 1);
 
-        std::copy(m_photosToUpdate.begin(), m_photosToUpdate.begin() + toProcess, std::back_inserter(photosToProcess));
         m_photosToUpdate.erase(m_photosToUpdate.begin(), m_photosToUpdate.begin() + toProcess);
+    }
+    else if (m_deferredPhotos.empty() == false)
+        isolated(m_deferredPhotos);
+
+    if (batch.empty())
+        return;
+
+    std::vector<Photo::Id> analyzed;
+    analyzed.swap(m_analyzedPhotos);
+
+    m_fetching = true;
+    m_dbTasks++;
+    lock.unlock();
+
+    m_database.exec([batch, analyzed, this](Database::IBackend& backend)
+    {
+        processBatch(backend, batch, analyzed);
+    });
 
-        m_database.exec([photosToProcess, this](Database::IBackend& backend)
+    lock.lock();
+}
+
+
+void PhotosAnalyzerImpl::processBatch(Database::IBackend& backend, const std::map<Photo::Id, int>& batch, const std::vector<Photo::Id>& analyzed)
+{
+    // journal changes: entries of analyzed photos are closed, photos from batch get new entries
+    std::map<Photo::Id, int> journal;
+
+    for(const auto& id: analyzed)
+        journal[id] = 0;
+
+    // load whole batch at once
+    std::vector<Photo::Id> ids;
+    ids.reserve(batch.size());
+
+    for(const auto& [id, attempt]: batch)
+        ids.push_back(id);
+
+    std::vector<Photo::Data> photos;
+    photos.reserve(batch.size());
+
+    for(auto& photo: backend.getPhotos(ids))
+    {
+        if (requiredTasks(photo) > 0)
+            photos.push_back(std::move(photo));
+        else if (batch.at(photo.id) > 1)
+            journal[photo.id] = 0;                  // interrupted photo which turned out to be analyzed already
+    }
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    const bool stopped = m_stopped;
+
+    if (stopped == false)
+    {
+        // account tasks before they are started so counters never go below zero
+        for(const auto& photo: photos)
         {
-            std::vector<Photo::Data> photos;
-            photos.reserve(m_photosToUpdate.size());
+            const std::size_t tasks = requiredTasks(photo);
 
-            for(const auto& id: photosToProcess)
-                photos.push_back(backend.getPhoto(id));
+            m_tasksPerPhoto[photo.id] += tasks;
+            m_tasksInFlight += tasks;
 
-            invokeMethod(this, &PhotosAnalyzerImpl::updatePhotos, photos);
-        });
+            // journal photos before any work is done, so crash during analysis can be attributed to them
+            journal[photo.id] = batch.at(photo.id);
+        }
     }
+
+    lock.unlock();
+
+    if (journal.empty() == false)
+        backend.set(Database::CommonGeneralFlags::AnalysisAttempts, journal);
+
+    if (stopped == false)
+        for(const auto& photo: photos)
+            dispatch(photo);
+
+    lock.lock();
+
+    m_fetching = false;
+
+    if (m_tasksInFlight < m_lowWatermark)
+        fetchNextBatch(lock);
+
+    dbTaskFinished(lock);
+}
+
+
+std::size_t PhotosAnalyzerImpl::requiredTasks(const Photo::Data& photo) const
+{
+    std::size_t tasks = 0;
+
+    if (isSet(photo, Photo::FlagsE::GeometryLoaded) == false || isSet(photo, Photo::FlagsE::ExifLoaded) == false)
+        tasks++;
+
+    if (isSet(photo, Photo::FlagsE::Sha256Loaded) == false)
+        tasks++;
+
+    if (isSet(photo, Photo::FlagsE::PHashLoaded) == false)
+        tasks++;
+
+    return tasks;
+}
+
+
+void PhotosAnalyzerImpl::dispatch(const Photo::Data& photo)
+{
+    if (isSet(photo, Photo::FlagsE::GeometryLoaded) == false || isSet(photo, Photo::FlagsE::ExifLoaded) == false)
+        m_updater.updateMetadata(photo);
+
+    if (isSet(photo, Photo::FlagsE::Sha256Loaded) == false)
+        m_updater.updateSha256(photo);
+
+    if (isSet(photo, Photo::FlagsE::PHashLoaded) == false)
+        m_updater.updatePHash(photo);
 }
 
 
-void PhotosAnalyzerImpl::updatePhotos(const std::vector<Photo::Data>& photos)
+void PhotosAnalyzerImpl::closeJournalEntries(std::unique_lock<std::mutex>& lock)
 {
-    for(const auto& photo: photos)
+    assert(lock.owns_lock());
+
+    if (m_analyzedPhotos.empty())
+        return;
+
+    std::vector<Photo::Id> analyzed;
+    analyzed.swap(m_analyzedPhotos);
+
+    lock.unlock();
+
+    m_database.exec([analyzed](Database::IBackend& backend)
     {
-        if (photo.flags.at(Photo::FlagsE::GeometryLoaded) == 0)
-            m_updater.updateGeometry(photo);
+        std::map<Photo::Id, int> journal;
 
-        if (photo.flags.at(Photo::FlagsE::ExifLoaded) == 0)
-            m_updater.updateTags(photo);
-    }
+        for(const auto& id: analyzed)
+            journal.emplace(id, 0);
+
+        backend.set(Database::CommonGeneralFlags::AnalysisAttempts, journal);
+    });
 
-    m_loadingPhotos = false;
+    lock.lock();
+}
+
+
+void PhotosAnalyzerImpl::dbTaskFinished(std::unique_lock<std::mutex>& lock)
+{
+    assert(lock.owns_lock());
+    assert(m_dbTasks > 0);
+
+    // notify under lock, stop() may destroy analyzer as soon as it sees no db tasks
+    if (--m_dbTasks == 0)
+        m_dbTasksFinished.notify_all();
 }
 
 
 void PhotosAnalyzerImpl::stop()
 {
-    disconnect(m_backendConnection);
-    m_photosToUpdate.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopped = true;
+        m_photosToUpdate.clear();
+        m_interruptedPhotos.clear();
+        m_deferredPhotos.clear();
+        m_dbTasks++;
+    }
+
+    // connection was made in db thread and photosAdded is emitted there, so drop it there too
+    m_database.exec([this](Database::IBackend &)
+    {
+        disconnect(m_backendConnection);
+
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        dbTaskFinished(lock);
+    });
+
+    {
+        // wait for batches being fetched and dispatched
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_dbTasksFinished.wait(lock, [this]{ return m_dbTasks == 0; });
+    }
+
     m_updater.waitForActiveTasks();
+
+    // all started analyses are finished now
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    closeJournalEntries(lock);
 }
 
 
-void PhotosAnalyzerImpl::setupRefresher()
+void PhotosAnalyzerImpl::requestRefresh()
 {
-    if (m_updater.tasksInProgress() > 0 && m_viewTask == nullptr)         //there are tasks but no view task
+    // progress is updated in gui thread. Post only one request at a time.
+    // Always queue it, as this function is called with m_queueMutex locked
+    if (m_refreshPending.exchange(true) == false)
+        QMetaObject::invokeMethod(this, &PhotosAnalyzerImpl::refreshView, Qt::QueuedConnection);
+}
+
+
+void PhotosAnalyzerImpl::setupRefresher(std::size_t pending)
+{
+    if (m_tasksView == nullptr)
+        return;
+
+    if (pending > 0 && m_viewTask == nullptr)         //there are tasks but no view task
     {
-        m_maxTasks = 0;
+        m_maxPending = 0;
         m_viewTask = m_tasksView->add(tr("Loading photos data..."));
     }
-    else if (m_updater.tasksInProgress() == 0 && m_photosToUpdate.size() == 0 && m_viewTask != nullptr)
+    else if (pending == 0 && m_viewTask != nullptr)
     {
         m_viewTask->finished();
         m_viewTask = nullptr;
@@ -169,16 +481,26 @@ void PhotosAnalyzerImpl::setupRefresher()
 
 void PhotosAnalyzerImpl::refreshView()
 {
-    setupRefresher();
+    m_refreshPending = false;
+
+    std::size_t pending = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        // count photos, not tasks: each photo in progress may have a few tasks running
+        pending = m_photosToUpdate.size() + m_interruptedPhotos.size() + m_deferredPhotos.size() + m_tasksPerPhoto.size();
+    }
+
+    setupRefresher(pending);
 
     if (m_viewTask != nullptr)
     {
-        const int current_size = m_photosToUpdate.size() + m_updater.tasksInProgress();
-        m_maxTasks = std::max(m_maxTasks, current_size);
+        const int current_size = static_cast<int>(pending);
+        m_maxPending = std::max(m_maxPending, current_size);
 
         IProgressBar* progressBar = m_viewTask->getProgressBar();
-        progressBar->setMaximum(m_maxTasks);
-        progressBar->setValue(m_maxTasks - current_size);
+        progressBar->setMaximum(m_maxPending);
+        progressBar->setValue(m_maxPending - current_size);
     }
 }
 
@@ -21,12 +21,12 @@
 #define PHOTOSANALYZER_PRIVATE_HPP
 
 
-#include <thread>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <map>
 #include <mutex>
 
-#include <QTimer>
-
 #include <core/itasks_view.hpp>
 #include <core/iview_task.hpp>
 #include <database/idatabase.hpp>
@@ -34,6 +34,25 @@
 #include "photo_info_updater.hpp"
 
 
+/**
+ * Photos analysis pipeline:
+ *  1. ids of photos awaiting analysis are fetched from database in batches (on db thread)
+ *  2. for each photo required tasks (metadata, hashes) are sent directly to executor
+ *  3. results are collected and stored in bulk by PhotoInfoUpdater
+ *
+ * Number of tasks in flight is bounded. Next batch is fetched as soon as
+ * number of tasks drops below low watermark (no event loop involved).
+ *
+ * Analysis is journaled with AnalysisAttempts general flag: it is increased before photo's tasks are started
+ * and zeroed when all of them are done. Journal changes collected for a batch are written in one transaction. Results are stored by per photo flags, so after restart analysis
+ * continues with photos which were not finished. Photos with nonzero journal entry (their analysis was
+ * interrupted by crash or kill) are analyzed first, one at a time. After MaxInterruptedAnalyses
+ * they are analyzed (still one at a time) after all other photos, so one bad file cannot prevent import from finishing.
+ * Photos are marked as broken only when analysis itself reports a failure.
+ *
+ * Database tasks referring to analyzer (initial scan, batch fetch and dispatch) are counted,
+ * stop() waits for all of them before analyzer can be destroyed.
+ */
 class PhotosAnalyzerImpl: public QObject
 {
         Q_OBJECT
@@ -53,21 +72,38 @@ class PhotosAnalyzerImpl: public QObject
 
     private:
         PhotoInfoUpdater m_updater;
-        QTimer m_timer;
-        std::vector<Photo::Id> m_photosToUpdate;
+        std::mutex m_queueMutex;
+        std::condition_variable m_dbTasksFinished;
+        std::deque<Photo::Id> m_photosToUpdate;
+        std::deque<std::pair<Photo::Id, int>> m_interruptedPhotos;       // photo id and number of interrupted analyses
+        std::deque<std::pair<Photo::Id, int>> m_deferredPhotos;          // interrupted too many times, analyzed after all others
+        std::map<Photo::Id, std::size_t> m_tasksPerPhoto;
+        std::vector<Photo::Id> m_analyzedPhotos;
         QMetaObject::Connection m_backendConnection;
         Database::IDatabase& m_database;
         ITasksView* m_tasksView;
         IViewTask* m_viewTask;
-        int m_maxTasks;
-        const std::size_t m_workers;
-        bool m_loadingPhotos;
-
-        void setupRefresher();
+        int m_maxPending;
+        std::size_t m_tasksInFlight;
+        std::size_t m_dbTasks;
+        const std::size_t m_highWatermark;
+        const std::size_t m_lowWatermark;
+        std::atomic<bool> m_refreshPending;
+        bool m_fetching;
+        bool m_stopped;
+
+        void setupRefresher(std::size_t);
         void refreshView();
+        void requestRefresh();
+        void resume(Database::IBackend &, const std::vector<Photo::Id> &);
         void addPhotos(const std::vector<Photo::Id> &);
-        void processPhotos();
-        void updatePhotos(const std::vector<Photo::Data> &);
+        void taskFinished(const Photo::Id &);
+        void fetchNextBatch(std::unique_lock<std::mutex> &);
+        void processBatch(Database::IBackend &, const std::map<Photo::Id, int> &, const std::vector<Photo::Id> &);
+        void closeJournalEntries(std::unique_lock<std::mutex> &);
+        void dbTaskFinished(std::unique_lock<std::mutex> &);
+        std::size_t requiredTasks(const Photo::Data &) const;
+        void dispatch(const Photo::Data &);
 };
 
 #endif // PHOTOSANALYZER_PRIVATE_HPP
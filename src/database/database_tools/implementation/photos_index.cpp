@@ -0,0 +1,862 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+
+#include <magic_enum.hpp>
+
+#include <general_flags.hpp>
+#include <ibackend.hpp>
+#include <idatabase.hpp>
+#include <iphoto_operator.hpp>
+
+#include "../photos_index.hpp"
+#include "bitmap.hpp"
+
+
+namespace Database
+{
+    namespace
+    {
+        constexpr std::int32_t NoValue = std::numeric_limits<std::int32_t>::min();     // smaller than any value, just like NULL in SQL
+        constexpr std::size_t BuildStepSize = 500;
+        constexpr std::size_t MaxCachedPredicates = 32;
+        constexpr std::size_t FlagsCount = static_cast<std::size_t>(Photo::FlagsE::PHashLoaded) + 1;
+
+        std::int32_t dateValue(const QDate& date)
+        {
+            return date.isValid()? static_cast<std::int32_t>(date.toJulianDay()): NoValue;
+        }
+
+        std::int32_t timeValue(const QTime& time)
+        {
+            // backend stores time with seconds precision
+            return time.isValid()? time.msecsSinceStartOfDay() / 1000: NoValue;
+        }
+
+        template<typename T>
+        void removeRow(std::vector<T>& column, std::size_t row)
+        {
+            column[row] = column.back();
+            column.pop_back();
+        }
+
+        struct SortKey
+        {
+            const std::vector<std::int32_t>* column;        // nullptr for photo id
+            bool descending;
+        };
+
+        // photos matching simple predicate (like 'rating >= 3')
+        struct CachedPredicate
+        {
+            std::function<bool(std::size_t)> test;          // evaluates predicate for one row
+            Bitmap matching;
+            std::uint64_t lastUse;
+        };
+    }
+
+
+    struct PhotosIndex::Data
+    {
+        mutable std::mutex mutex;
+        std::deque<Photo::Id> pending;                      // photos to be indexed during build
+        std::unordered_map<Photo::Id, std::int32_t, Photo::IdHash> pendingStates;   // non default states of pending photos
+        bool ready = false;
+
+        // columns
+        std::vector<Photo::Id> ids;
+        std::vector<std::int32_t> dates;                    // julian day
+        std::vector<std::int32_t> times;                    // seconds since midnight
+        std::vector<std::int32_t> ratings;
+        std::vector<std::int32_t> categories;               // index in categoriesDictionary
+        std::array<std::vector<std::int32_t>, FlagsCount> flags;
+        std::vector<std::int32_t> states;                   // CommonGeneralFlags::State
+        std::vector<std::int32_t> roles;                    // GroupInfo::Role
+
+        std::unordered_map<Photo::Id, std::size_t, Photo::IdHash> rows;
+        std::vector<QString> categoriesDictionary;          // raw values of categories
+
+        // Results of simple predicates are cached and kept up to date with each row modification,
+        // so composite filters are just a few bitmap operations
+        mutable std::map<QString, CachedPredicate> predicates;
+        mutable std::uint64_t predicatesUses = 0;
+
+        /**
+         * \brief collect photos to be indexed
+         */
+        void prepare(IBackend& backend)
+        {
+            const auto photos = backend.photoOperator().getPhotos(EmptyFilter());
+
+            // photo's state is not part of its data, read all non default states at once
+            std::unordered_map<Photo::Id, std::int32_t, Photo::IdHash> photosStates;
+
+            for (const auto state: magic_enum::enum_values<CommonGeneralFlags::StateType>())
+                if (state != CommonGeneralFlags::StateType::Normal)
+                {
+                    const FilterPhotosWithGeneralFlag filter(CommonGeneralFlags::State, static_cast<int>(state));
+
+                    for (const Photo::Id& id: backend.photoOperator().getPhotos(filter))
+                        photosStates.emplace(id, static_cast<std::int32_t>(state));
+                }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.assign(photos.begin(), photos.end());
+            pendingStates = std::move(photosStates);
+        }
+
+        /**
+         * \brief index next part of pending photos
+         * \return true if there are still photos to be indexed
+         */
+        bool buildStep(IBackend& backend)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const std::size_t count = std::min(BuildStepSize, pending.size());
+            const std::vector<Photo::Id> step(pending.begin(), pending.begin() + count);
+            pending.erase(pending.begin(), pending.begin() + count);
+
+            store(backend.getPhotos(step));
+
+            ready = pending.empty();
+
+            if (ready)
+                pendingStates.clear();
+
+            return ready == false;
+        }
+
+        void store(const std::vector<Photo::Data>& photos)
+        {
+            for (const Photo::Data& photo: photos)
+                store(photo);
+        }
+
+        void store(const Photo::Data& photo)
+        {
+            // state is not part of photo's data, it is followed with generalFlagChanged notifications
+            std::int32_t state = 0;
+
+            if (auto row_it = rows.find(photo.id); row_it != rows.end())
+                state = states[row_it->second];
+            else if (auto state_it = pendingStates.find(photo.id); state_it != pendingStates.end())
+            {
+                state = state_it->second;
+                pendingStates.erase(state_it);
+            }
+
+            const std::size_t row = rowFor(photo.id);
+
+            dates[row] = NoValue;
+            times[row] = NoValue;
+            ratings[row] = NoValue;
+            categories[row] = NoValue;
+
+            for (const auto& [type, value]: photo.tags)
+                switch (type)
+                {
+                    case TagTypes::Date:
+                        if (value.type() == Tag::ValueType::Date)
+                            dates[row] = dateValue(value.getDate());
+                        break;
+
+                    case TagTypes::Time:
+                        if (value.type() == Tag::ValueType::Time)
+                            times[row] = timeValue(value.getTime());
+                        break;
+
+                    case TagTypes::Rating:
+                        if (value.type() == Tag::ValueType::Int)
+                            ratings[row] = value.get<int>();
+                        break;
+
+                    case TagTypes::Category:
+                        categories[row] = storeCategory(value.rawValue());
+                        break;
+
+                    default:
+                        break;
+                }
+
+            for (auto& column: flags)
+                column[row] = 0;
+
+            for (const auto& [flag, value]: photo.flags)
+                flags[static_cast<std::size_t>(flag)][row] = value;
+
+            roles[row] = photo.groupInfo.role;
+            states[row] = state;
+
+            refreshPredicates(row);
+        }
+
+        // ids of photos which are already indexed
+        std::vector<Photo::Id> indexed(const std::set<Photo::Id>& ids) const
+        {
+            std::vector<Photo::Id> result;
+
+            for (const Photo::Id& id: ids)
+                if (rows.contains(id))
+                    result.push_back(id);
+
+            return result;
+        }
+
+        void remove(const Photo::Id& id)
+        {
+            std::erase(pending, id);
+
+            auto it = rows.find(id);
+
+            if (it == rows.end())
+                return;
+
+            const std::size_t row = it->second;
+            rows.erase(it);
+
+            // fill gap with last row
+            removeRow(ids, row);
+            removeRow(dates, row);
+            removeRow(times, row);
+            removeRow(ratings, row);
+            removeRow(categories, row);
+            removeRow(states, row);
+            removeRow(roles, row);
+
+            for (auto& column: flags)
+                removeRow(column, row);
+
+            for (auto& [key, predicate]: predicates)
+            {
+                Bitmap& matching = predicate.matching;
+
+                matching.set(row, matching.test(ids.size()));
+                matching.resize(ids.size());
+            }
+
+            if (row < ids.size())
+                rows[ids[row]] = row;
+        }
+
+        void setFlag(const Photo::Id& id, Photo::FlagsE flag, int value)
+        {
+            auto it = rows.find(id);
+
+            if (it != rows.end())
+            {
+                flags[static_cast<std::size_t>(flag)][it->second] = value;
+                refreshPredicates(it->second);
+            }
+        }
+
+        void setState(const Photo::Id& id, int value)
+        {
+            auto it = rows.find(id);
+
+            if (it != rows.end())
+            {
+                states[it->second] = value;
+                refreshPredicates(it->second);
+            }
+            else if (ready == false)
+                pendingStates[id] = value;                  // photo will be indexed later
+        }
+
+        std::size_t rowFor(const Photo::Id& id)
+        {
+            auto [it, inserted] = rows.emplace(id, ids.size());
+
+            if (inserted)
+            {
+                ids.push_back(id);
+                dates.push_back(NoValue);
+                times.push_back(NoValue);
+                ratings.push_back(NoValue);
+                categories.push_back(NoValue);
+                states.push_back(0);
+                roles.push_back(GroupInfo::None);
+
+                for (auto& column: flags)
+                    column.push_back(0);
+
+                for (auto& [key, predicate]: predicates)
+                    predicate.matching.resize(ids.size());
+            }
+
+            return it->second;
+        }
+
+        void refreshPredicates(std::size_t row)
+        {
+            for (auto& [key, predicate]: predicates)
+                predicate.matching.set(row, predicate.test(row));
+        }
+
+        // for unknown category returns code which is not used by any photo
+        std::int32_t categoryCode(const QString& raw) const
+        {
+            const auto it = std::find(categoriesDictionary.begin(), categoriesDictionary.end(), raw);
+
+            return static_cast<std::int32_t>(std::distance(categoriesDictionary.begin(), it));
+        }
+
+        std::int32_t storeCategory(const QString& raw)
+        {
+            const std::int32_t code = categoryCode(raw);
+
+            if (static_cast<std::size_t>(code) == categoriesDictionary.size())
+                categoriesDictionary.push_back(raw);
+
+            return code;
+        }
+
+        // filters
+
+        std::optional<Bitmap> evaluate(const Filter& filter) const
+        {
+            return std::visit([this](const auto& f) { return this->evaluate(f); }, filter);
+        }
+
+        std::optional<Bitmap> evaluate(const EmptyFilter &) const
+        {
+            return Bitmap(ids.size(), true);
+        }
+
+        std::optional<Bitmap> evaluate(const GroupFilter& groupFilter) const
+        {
+            Bitmap result(ids.size(), true);
+
+            for (const Filter& filter: groupFilter.filters)
+            {
+                // use 'and not' for negated filters instead of building negation
+                const FilterNotMatchingFilter* negated = std::get_if<FilterNotMatchingFilter>(&filter);
+                const auto matching = negated? evaluate(*negated->filter): evaluate(filter);
+
+                if (matching.has_value() == false)
+                    return {};
+
+                if (negated)
+                    result.andNot(*matching);
+                else
+                    result &= *matching;
+            }
+
+            return result;
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithTag& filter) const
+        {
+            const std::vector<std::int32_t>* column = nullptr;
+
+            switch (filter.tagType)
+            {
+                case TagTypes::Date:     column = &dates;      break;
+                case TagTypes::Time:     column = &times;      break;
+                case TagTypes::Rating:   column = &ratings;    break;
+                case TagTypes::Category: column = &categories; break;
+                default: return {};
+            }
+
+            if (filter.tagValue.type() == Tag::ValueType::Empty)
+                return cached(QString("tag %1 exists").arg(filter.tagType), *column, [](std::int32_t v) { return v != NoValue; });
+
+            const std::optional<std::int32_t> value = encode(filter.tagType, filter.tagValue);
+
+            if (value.has_value() == false)
+                return {};
+
+            // categories have no meaningful order
+            if (filter.tagType == TagTypes::Category && filter.valueMode != FilterPhotosWithTag::ValueMode::Equal)
+                return {};
+
+            // backend compares ratings as text when empty values are included
+            if (filter.tagType == TagTypes::Rating && filter.includeEmpty)
+                return {};
+
+            // Missing values are treated by backend as empty strings when includeEmpty is set.
+            // As NoValue is smaller than any other value, comparisons below give the same results.
+            const bool includeEmpty = filter.includeEmpty;
+            const std::int32_t ref = *value;
+            const QString key = QString("tag %1 mode %2 empty %3 value %4")
+                                    .arg(filter.tagType)
+                                    .arg(static_cast<int>(filter.valueMode))
+                                    .arg(includeEmpty)
+                                    .arg(ref);
+
+            switch (filter.valueMode)
+            {
+                case FilterPhotosWithTag::ValueMode::Equal:
+                    return cached(key, *column, [ref](std::int32_t v) { return v == ref; });
+
+                case FilterPhotosWithTag::ValueMode::Less:
+                    return cached(key, *column, [ref, includeEmpty](std::int32_t v) { return (includeEmpty || v != NoValue) && v < ref; });
+
+                case FilterPhotosWithTag::ValueMode::LessOrEqual:
+                    return cached(key, *column, [ref, includeEmpty](std::int32_t v) { return (includeEmpty || v != NoValue) && v <= ref; });
+
+                case FilterPhotosWithTag::ValueMode::Greater:
+                    return cached(key, *column, [ref](std::int32_t v) { return v > ref; });
+
+                case FilterPhotosWithTag::ValueMode::GreaterOrEqual:
+                    return cached(key, *column, [ref](std::int32_t v) { return v >= ref; });
+            }
+
+            return {};
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithFlags& filter) const
+        {
+            const bool all = filter.mode == FilterPhotosWithFlags::Mode::And;
+            Bitmap result(ids.size(), all);
+
+            for (const auto& [flag, value]: filter.flags)
+            {
+                const int expected = value;
+                const QString key = QString("flag %1 value %2").arg(static_cast<int>(flag)).arg(expected);
+                const Bitmap& matching = cached(key, flags[static_cast<std::size_t>(flag)], [expected](std::int32_t v) { return v == expected; });
+
+                if (all)
+                    result &= matching;
+                else
+                    result |= matching;
+            }
+
+            return result;
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithSha256 &) const
+        {
+            return {};
+        }
+
+        std::optional<Bitmap> evaluate(const FilterNotMatchingFilter& filter) const
+        {
+            const auto matching = evaluate(*filter.filter);
+
+            return matching.has_value()? std::optional<Bitmap>(~*matching): std::nullopt;
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithId& filter) const
+        {
+            Bitmap result(ids.size());
+
+            auto it = rows.find(filter.filter);
+
+            if (it != rows.end())
+                result.set(it->second);
+
+            return result;
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosMatchingExpression &) const
+        {
+            return {};
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithPath &) const
+        {
+            return {};
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithRole& filter) const
+        {
+            std::int32_t role = GroupInfo::None;
+
+            switch (filter.m_role)
+            {
+                case FilterPhotosWithRole::Role::Regular:             role = GroupInfo::None;           break;
+                case FilterPhotosWithRole::Role::GroupRepresentative: role = GroupInfo::Representative; break;
+                case FilterPhotosWithRole::Role::GroupMember:         role = GroupInfo::Member;         break;
+            }
+
+            return cached(QString("role %1").arg(role), roles, [role](std::int32_t v) { return v == role; });
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithPerson &) const
+        {
+            // people assignments are not announced by backend's signals
+            return {};
+        }
+
+        std::optional<Bitmap> evaluate(const FilterPhotosWithGeneralFlag& filter) const
+        {
+            if (filter.name != CommonGeneralFlags::State)
+                return {};
+
+            const int expected = filter.value;
+
+            return cached(QString("state %1").arg(expected), states, [expected](std::int32_t v) { return v == expected; });
+        }
+
+        /**
+         * \brief photos matching predicate on column
+         *
+         * Result is calculated with full column scan on first use and then cached.
+         */
+        template<typename Predicate>
+        const Bitmap& cached(const QString& key, const std::vector<std::int32_t>& column, Predicate predicate) const
+        {
+            auto it = predicates.find(key);
+
+            if (it == predicates.end())
+            {
+                if (predicates.size() >= MaxCachedPredicates)
+                {
+                    const auto lru = std::min_element(predicates.begin(), predicates.end(), [](const auto& lhs, const auto& rhs)
+                    {
+                        return lhs.second.lastUse < rhs.second.lastUse;
+                    });
+
+                    predicates.erase(lru);
+                }
+
+                const std::vector<std::int32_t>* values = &column;
+                auto test = [values, predicate](std::size_t row) { return predicate((*values)[row]); };
+
+                const std::int32_t* data = column.data();
+                Bitmap matching = Bitmap::fromPredicate(column.size(), [data, &predicate](std::size_t i) { return predicate(data[i]); });
+
+                it = predicates.emplace(key, CachedPredicate{test, std::move(matching), 0}).first;
+            }
+
+            it->second.lastUse = ++predicatesUses;
+
+            return it->second.matching;
+        }
+
+        std::optional<std::int32_t> encode(TagTypes type, const TagValue& value) const
+        {
+            const QString raw = value.rawValue();
+            std::optional<std::int32_t> result;
+
+            switch (type)
+            {
+                case TagTypes::Date:
+                {
+                    const QDate date = TagValue::fromRaw(raw, Tag::ValueType::Date).getDate();
+
+                    if (date.isValid())
+                        result = dateValue(date);
+
+                    break;
+                }
+
+                case TagTypes::Time:
+                {
+                    const QTime time = TagValue::fromRaw(raw, Tag::ValueType::Time).getTime();
+
+                    if (time.isValid())
+                        result = timeValue(time);
+
+                    break;
+                }
+
+                case TagTypes::Rating:
+                {
+                    bool ok = false;
+                    const int rating = raw.toInt(&ok);
+
+                    if (ok)
+                        result = rating;
+
+                    break;
+                }
+
+                case TagTypes::Category:
+                    result = categoryCode(raw);
+                    break;
+
+                default:
+                    break;
+            }
+
+            return result;
+        }
+
+        // actions
+
+        bool sortKeys(const Action& action, std::vector<SortKey>& keys) const
+        {
+            bool supported = true;
+
+            if (auto sort_action = std::get_if<Actions::SortByTag>(&action))
+            {
+                const bool descending = sort_action->sort_order == Qt::DescendingOrder;
+
+                // other tags are sorted by backend as text
+                if (sort_action->tag == TagTypes::Date)
+                    keys.push_back( {&dates, descending} );
+                else if (sort_action->tag == TagTypes::Time)
+                    keys.push_back( {&times, descending} );
+                else
+                    supported = false;
+            }
+            else if (auto sort_action = std::get_if<Actions::SortByTimestamp>(&action))
+            {
+                const bool descending = sort_action->sort_order == Qt::DescendingOrder;
+
+                keys.push_back( {&dates, descending} );
+                keys.push_back( {&times, descending} );
+            }
+            else if (std::get_if<Actions::SortByID>(&action))
+                keys.push_back( {nullptr, false} );
+            else if (auto group_action = std::get_if<Actions::GroupAction>(&action))
+            {
+                for (const auto& sub_action: group_action->actions)
+                    supported = supported && sortKeys(sub_action, keys);
+            }
+            else
+                supported = false;
+
+            return supported;
+        }
+
+        std::vector<Photo::Id> sorted(const Bitmap& matching, const std::vector<SortKey>& keys) const
+        {
+            std::vector<std::size_t> result_rows;
+            result_rows.reserve(matching.count());
+
+            matching.forEach([&result_rows](std::size_t row)
+            {
+                result_rows.push_back(row);
+            });
+
+            auto value = [this](const SortKey& key, std::size_t row)
+            {
+                return key.column? (*key.column)[row]: ids[row].value();
+            };
+
+            std::sort(result_rows.begin(), result_rows.end(), [&](std::size_t lhs, std::size_t rhs)
+            {
+                for (const SortKey& key: keys)
+                {
+                    const std::int32_t lhs_value = value(key, lhs);
+                    const std::int32_t rhs_value = value(key, rhs);
+
+                    if (lhs_value != rhs_value)
+                        return key.descending? lhs_value > rhs_value: lhs_value < rhs_value;
+                }
+
+                // keep order of equal items stable
+                return ids[lhs] < ids[rhs];
+            });
+
+            std::vector<Photo::Id> result;
+            result.reserve(result_rows.size());
+
+            for (const std::size_t row: result_rows)
+                result.push_back(ids[row]);
+
+            return result;
+        }
+    };
+
+
+    PhotosIndex::PhotosIndex()
+        : m_data(std::make_shared<Data>())
+    {
+
+    }
+
+
+    PhotosIndex::~PhotosIndex()
+    {
+        detach();
+    }
+
+
+    void PhotosIndex::set(IDatabase* db)
+    {
+        detach();
+
+        if (db != nullptr)
+        {
+            attach(db->backend());
+
+            std::weak_ptr<Data> data = m_data.load();
+
+            db->exec([db, data](IBackend& backend)
+            {
+                if (auto d = data.lock())
+                {
+                    d->prepare(backend);
+
+                    scheduleBuildStep(db, data);
+                }
+            });
+        }
+    }
+
+
+    void PhotosIndex::set(IBackend& backend)
+    {
+        detach();
+        attach(backend);
+
+        const std::shared_ptr<Data> data = m_data.load();
+
+        data->prepare(backend);
+
+        while(data->buildStep(backend));
+    }
+
+
+    std::optional<std::vector<Photo::Id>> PhotosIndex::onPhotos(const Filter& filter, const Action& action) const
+    {
+        // keep data alive even if index is reattached meanwhile
+        const std::shared_ptr<const Data> data = m_data.load();
+        std::lock_guard<std::mutex> lock(data->mutex);
+
+        if (data->ready == false)
+            return {};
+
+        std::vector<SortKey> keys;
+
+        if (data->sortKeys(action, keys) == false)
+            return {};
+
+        const std::optional<Bitmap> matching = data->evaluate(filter);
+
+        if (matching.has_value() == false)
+            return {};
+
+        return data->sorted(*matching, keys);
+    }
+
+
+    bool PhotosIndex::isReady() const
+    {
+        const std::shared_ptr<const Data> data = m_data.load();
+        std::lock_guard<std::mutex> lock(data->mutex);
+
+        return data->ready;
+    }
+
+
+    void PhotosIndex::attach(IBackend& backend)
+    {
+        // all notifications come from backend's thread, where index can access backend directly
+        std::weak_ptr<Data> data = m_data.load();
+
+        m_connections.push_back(
+            QObject::connect(&backend, &IBackend::photosAdded, [data, &backend](const std::vector<Photo::Id>& ids)
+            {
+                if (auto d = data.lock())
+                {
+                    const std::vector<Photo::Data> photos = backend.getPhotos(ids);
+
+                    std::lock_guard<std::mutex> lock(d->mutex);
+                    d->store(photos);
+                }
+            })
+        );
+
+        m_connections.push_back(
+            QObject::connect(&backend, &IBackend::photosModified, [data, &backend](const std::set<Photo::Id>& ids)
+            {
+                if (auto d = data.lock())
+                {
+                    std::lock_guard<std::mutex> lock(d->mutex);
+
+                    // photos which are not indexed yet will be read during build.
+                    // Read all modified photos at once, cost of notification handling does not grow with number of queries
+                    const std::vector<Photo::Id> indexed = d->indexed(ids);
+
+                    if (indexed.empty() == false)
+                        d->store(backend.getPhotos(indexed));
+                }
+            })
+        );
+
+        m_connections.push_back(
+            QObject::connect(&backend, &IBackend::photosRemoved, [data](const std::vector<Photo::Id>& ids)
+            {
+                if (auto d = data.lock())
+                {
+                    std::lock_guard<std::mutex> lock(d->mutex);
+
+                    for (const Photo::Id& id: ids)
+                        d->remove(id);
+                }
+            })
+        );
+
+        m_connections.push_back(
+            QObject::connect(&backend, &IBackend::photosMarkedAsReviewed, [data](const std::vector<Photo::Id>& ids)
+            {
+                if (auto d = data.lock())
+                {
+                    std::lock_guard<std::mutex> lock(d->mutex);
+
+                    for (const Photo::Id& id: ids)
+                        d->setFlag(id, Photo::FlagsE::StagingArea, 0);
+                }
+            })
+        );
+
+        m_connections.push_back(
+            QObject::connect(&backend, &IBackend::generalFlagChanged, [data](const Photo::Id& id, const QString& name, int value)
+            {
+                if (name != CommonGeneralFlags::State)
+                    return;
+
+                if (auto d = data.lock())
+                {
+                    std::lock_guard<std::mutex> lock(d->mutex);
+                    d->setState(id, value);
+                }
+            })
+        );
+    }
+
+
+    void PhotosIndex::detach()
+    {
+        for (const auto& connection: m_connections)
+            QObject::disconnect(connection);
+
+        m_connections.clear();
+
+        // drop old data, so any pending build step will work on orphaned data
+        m_data.store(std::make_shared<Data>());
+    }
+
+
+    void PhotosIndex::scheduleBuildStep(IDatabase* db, std::weak_ptr<Data> data)
+    {
+        // build index in small steps so other database tasks are not blocked for long
+        db->exec([db, data](IBackend& backend)
+        {
+            if (auto d = data.lock())
+                if (d->buildStep(backend))
+                    scheduleBuildStep(db, data);
+        });
+    }
+}
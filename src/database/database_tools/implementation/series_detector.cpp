@@ -17,6 +17,10 @@
  */
 
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
 #include <unordered_set>
 #include <QDateTime>
 
@@ -26,6 +30,7 @@
 #include <core/tags_utils.hpp>
 #include <ibackend.hpp>
 #include <iphoto_operator.hpp>
+#include <iseries_cache_operator.hpp>
 
 #include "database_executor_traits.hpp"
 #include "../series_detector.hpp"
@@ -33,6 +38,12 @@
 
 namespace
 {
+    using Database::SeriesFeatures;
+    using Database::SeriesWindow;
+
+    // range of photos [first, last) which can be analyzed independently
+    typedef std::pair<std::size_t, std::size_t> Chunk;
+
     template<Group::Type>
     class GroupValidator;
 
@@ -49,15 +60,14 @@ namespace
     class GroupValidator<Group::Type::Animation>
     {
     public:
-        GroupValidator(IExifReader& exif, const SeriesDetector::Rules &)
-            : m_exifReader(exif)
+        GroupValidator(const SeriesDetector::Rules &)
         {
 
         }
 
-        void setCurrentPhoto(const Photo::Data& d)
+        void setCurrentPhoto(const SeriesFeatures& f)
         {
-            m_sequence = m_exifReader.get(d.path, IExifReader::TagType::SequenceNumber);
+            m_sequence = f.sequenceNumber;
         }
 
         bool canBePartOfGroup()
@@ -66,8 +76,7 @@ namespace
 
             if (has_exif_data)
             {
-                const int s = std::any_cast<int>(m_sequence.value());
-                auto s_it = m_sequence_numbers.find(s);
+                auto s_it = m_sequence_numbers.find(*m_sequence);
 
                 return s_it == m_sequence_numbers.end();
             }
@@ -79,15 +88,11 @@ namespace
         {
             assert(m_sequence);
 
-            const int s = std::any_cast<int>(m_sequence.value());
-
-            m_sequence_numbers.insert(s);
+            m_sequence_numbers.insert(*m_sequence);
         }
 
-        std::optional<std::any> m_sequence;
-
+        std::optional<int> m_sequence;
         std::unordered_set<int> m_sequence_numbers;
-        IExifReader& m_exifReader;
     };
 
     template<>
@@ -96,16 +101,16 @@ namespace
         typedef GroupValidator<Group::Type::Animation> Base;
 
     public:
-        GroupValidator(IExifReader& exif, const SeriesDetector::Rules& r)
-            : Base(exif, r)
+        GroupValidator(const SeriesDetector::Rules& r)
+            : Base(r)
         {
 
         }
 
-        void setCurrentPhoto(const Photo::Data& d)
+        void setCurrentPhoto(const SeriesFeatures& f)
         {
-            Base::setCurrentPhoto(d);
-            m_exposure = m_exifReader.get(d.path, IExifReader::TagType::Exposure);
+            Base::setCurrentPhoto(f);
+            m_exposure = f.exposure;
         }
 
         bool canBePartOfGroup()
@@ -114,9 +119,7 @@ namespace
 
             if (has_exif_data)
             {
-                const int e = readExposure(m_exposure.value());
-
-                auto e_it = m_exposures.find(e);
+                auto e_it = m_exposures.find(*m_exposure);
 
                 return e_it == m_exposures.end();
             }
@@ -130,11 +133,10 @@ namespace
 
             Base::accept();
 
-            const int e = readExposure(m_exposure.value());
-            m_exposures.insert(e);
+            m_exposures.insert(*m_exposure);
         }
 
-        std::optional<std::any> m_exposure;
+        std::optional<int> m_exposure;
         std::unordered_set<int> m_exposures;
     };
 
@@ -142,16 +144,16 @@ namespace
     class GroupValidator<Group::Type::Generic>
     {
     public:
-        GroupValidator(IExifReader &, const SeriesDetector::Rules& r)
+        GroupValidator(const SeriesDetector::Rules& r)
             : m_prev_stamp(0)
             , m_rules(r)
         {
 
         }
 
-        void setCurrentPhoto(const Photo::Data& d)
+        void setCurrentPhoto(const SeriesFeatures& f)
         {
-            m_current_stamp = Tag::timestamp(d.tags);
+            m_current_stamp = f.timestamp;
         }
 
         bool canBePartOfGroup()
@@ -172,16 +174,16 @@ namespace
     class SeriesExtractor
     {
     public:
-        SeriesExtractor(IExifReader& exifReader,
-                        const std::deque<Photo::Data>& photos,
+        SeriesExtractor(const std::vector<SeriesFeatures>& features,
+                        const Chunk& chunk,
                         const SeriesDetector::Rules& r,
                         const QPromise<std::vector<GroupCandidate>>* p)
-            : m_exifReader(exifReader)
-            , m_rules(r)
-            , m_photos(photos)
+            : m_rules(r)
+            , m_features(features)
             , m_promise(p)
         {
-
+            for (std::size_t i = chunk.first; i < chunk.second; i++)
+                m_remaining.push_back(i);
         }
 
         template<Group::Type type>
@@ -189,7 +191,7 @@ namespace
         {
             std::vector<GroupCandidate> results;
 
-            for (auto it = m_photos.begin(); it != m_photos.end();)
+            for (auto it = m_remaining.begin(); it != m_remaining.end();)
             {
                 if (m_promise && m_promise->isCanceled())
                     throw abort_exception();
@@ -197,17 +199,18 @@ namespace
                 GroupCandidate group;
                 group.type = type;
 
-                GroupValidator<type> validator(m_exifReader, m_rules);
+                GroupValidator<type> validator(m_rules);
 
-                for (auto it2 = it; it2 != m_photos.end(); ++it2)
+                for (auto it2 = it; it2 != m_remaining.end(); ++it2)
                 {
-                    const Photo::Data& data = *it2;
-
-                    validator.setCurrentPhoto(data);
+                    validator.setCurrentPhoto(m_features[*it2]);
 
                     if (validator.canBePartOfGroup())
                     {
-                        group.members.push_back(data);
+                        Photo::Data member;                         // details are filled later
+                        member.id = m_features[*it2].id;
+
+                        group.members.push_back(member);
                         validator.accept();
                     }
                     else
@@ -224,7 +227,7 @@ namespace
                     auto first = it;
                     auto last = first + members;
 
-                    it = m_photos.erase(first, last);
+                    it = m_remaining.erase(first, last);
                 }
                 else
                     ++it;
@@ -234,11 +237,92 @@ namespace
         }
 
     private:
-        IExifReader& m_exifReader;
         const SeriesDetector::Rules& m_rules;
-        std::deque<Photo::Data> m_photos;
+        const std::vector<SeriesFeatures>& m_features;
+        std::deque<std::size_t> m_remaining;
         const QPromise<std::vector<GroupCandidate>>* m_promise;
     };
+
+    struct ChunkGroups
+    {
+        std::vector<GroupCandidate> hdrs;
+        std::vector<GroupCandidate> animations;
+        std::vector<GroupCandidate> generics;
+    };
+
+    // No series spans a time gap longer than manualSeriesMaxGap, so photos separated by such gaps
+    // can be analyzed independently.
+    std::vector<Chunk> splitByTime(const std::vector<SeriesFeatures>& features, const SeriesDetector::Rules& rules)
+    {
+        std::vector<Chunk> chunks;
+
+        std::size_t first = 0;
+        for (std::size_t i = 1; i <= features.size(); i++)
+            if (i == features.size() || features[i].timestamp - features[i - 1].timestamp > rules.manualSeriesMaxGap)
+            {
+                chunks.emplace_back(first, i);
+                first = i;
+            }
+
+        return chunks;
+    }
+
+
+    // read exif data of photos in parallel
+    std::vector<SeriesFeatures> readFeatures(ITaskExecutor& executor,
+                                             IExifReaderFactory& exifReaderFactory,
+                                             const QPromise<std::vector<GroupCandidate>>* promise,
+                                             const std::vector<Photo::Data>& photos)
+    {
+        std::vector<SeriesFeatures> features(photos.size());
+
+        parallelFor(executor, photos.size(), [&](std::size_t i)
+        {
+            if (promise && promise->isCanceled())
+                return;
+
+            const Photo::Data& photo = photos[i];
+            SeriesFeatures& feature = features[i];
+
+            feature.id = photo.id;
+            feature.timestamp = Tag::timestamp(photo.tags);
+            feature.image = MediaTypes::isImageFile(Photo::getPath(photo));
+
+            if (feature.image)
+            {
+                // reader bound to current thread
+                IExifReader& exifReader = exifReaderFactory.get();
+
+                const auto sequence = exifReader.get(photo.path, IExifReader::TagType::SequenceNumber);
+                const auto exposure = exifReader.get(photo.path, IExifReader::TagType::Exposure);
+
+                if (sequence)
+                    feature.sequenceNumber = std::any_cast<int>(*sequence);
+
+                if (exposure)
+                    feature.exposure = readExposure(*exposure);
+            }
+        }, "SeriesDetector: exif prefetch");
+
+        return features;
+    }
+
+    // state of database required for detection
+    struct DetectionInput
+    {
+        std::vector<Photo::Id> photos;                              // photos to analyze, sorted by time
+        std::map<Photo::Id, SeriesFeatures> storedFeatures;         // features stored during previous detections
+        std::vector<Photo::Data> unknownPhotos;                     // photos without stored features
+        std::vector<SeriesWindow> storedWindows;                    // results of previous detections
+    };
+
+    // first and last timestamp, max gap, number of photos
+    using WindowKey = std::tuple<qint64, qint64, qint64, std::size_t>;
+
+    WindowKey windowKey(const SeriesWindow& window)
+    {
+        return { window.first.count(), window.last.count(), window.maxGap.count(), window.photos };
+    }
 }
 
 
@@ -249,10 +333,14 @@ SeriesDetector::Rules::Rules(std::chrono::milliseconds manualSeriesMaxGap)
 }
 
 
-SeriesDetector::SeriesDetector(Database::IDatabase& db, IExifReader& exif, const QPromise<std::vector<GroupCandidate>>* p)
+SeriesDetector::SeriesDetector(Database::IDatabase& db,
+                               IExifReaderFactory& exif,
+                               ITaskExecutor& executor,
+                               const QPromise<std::vector<GroupCandidate>>* p)
     : m_db(db)
     , m_promise(p)
-    , m_exifReader(exif)
+    , m_exifReaderFactory(exif)
+    , m_executor(executor)
 {
 
 }
@@ -260,55 +348,244 @@ SeriesDetector::SeriesDetector(Database::IDatabase& db, IExifReader& exif, const
 
 std::vector<GroupCandidate> SeriesDetector::listCandidates(const Rules& rules) const
 {
-    const std::deque<Photo::Data> datas =
-        evaluate<std::deque<Photo::Data>(Database::IBackend &)>(m_db, [this, &rules, &datas](Database::IBackend& backend)
+    const DetectionInput input =
+        evaluate<DetectionInput(Database::IBackend &)>(m_db, [](Database::IBackend& backend)
     {
-        std::vector<GroupCandidate> result;
+        DetectionInput input;
 
         // find photos which are not part of any group
         Database::FilterPhotosWithRole group_filter(Database::FilterPhotosWithRole::Role::Regular);
 
-        const auto photos = backend.photoOperator().onPhotos( {group_filter}, Database::Actions::SortByTimestamp() );
+        input.photos = backend.photoOperator().onPhotos( {group_filter}, Database::Actions::SortByTimestamp() );
 
-        std::deque<Photo::Data> datas;
-        for (const Photo::Id& id: photos)
-        {
-            const Photo::Data data = backend.getPhoto(id);
-            datas.push_back(data);
-        }
+        for (const SeriesFeatures& features: backend.seriesCacheOperator().listFeatures())
+            input.storedFeatures.emplace(features.id, features);
+
+        // load details only of photos which were not analyzed before
+        std::vector<Photo::Id> unknown;
+
+        for (const Photo::Id& id: input.photos)
+            if (input.storedFeatures.contains(id) == false)
+                unknown.push_back(id);
 
-        return datas;
+        input.unknownPhotos = backend.getPhotos(unknown);
+        input.storedWindows = backend.seriesCacheOperator().listWindows();
+
+        return input;
     });
 
-    return analyze_photos(datas, rules);
-}
+    // exif data is read only for new (or modified) photos
+    const std::vector<SeriesFeatures> newFeatures = readFeatures(m_executor, m_exifReaderFactory, m_promise, input.unknownPhotos);
 
+    if (m_promise && m_promise->isCanceled())
+        return {};
 
-std::vector<GroupCandidate> SeriesDetector::analyze_photos(const std::deque<Photo::Data>& photos, const Rules& rules) const
-{
-    std::deque<Photo::Data> suitablePhotos;
+    std::map<Photo::Id, const SeriesFeatures*> allFeatures;
 
-    std::copy_if(photos.begin(), photos.end(), std::back_inserter(suitablePhotos), [](const auto& photo) {
-        return MediaTypes::isImageFile(Photo::getPath(photo));
-    });
+    for (const auto& [id, features]: input.storedFeatures)
+        allFeatures.emplace(id, &features);
+
+    for (const auto& features: newFeatures)
+        allFeatures.emplace(features.id, &features);
+
+    // only images are considered
+    std::vector<SeriesFeatures> features;
+    features.reserve(input.photos.size());
+
+    for (const Photo::Id& id: input.photos)
+    {
+        const SeriesFeatures& f = *allFeatures.at(id);
+
+        if (f.image)
+            features.push_back(f);
+    }
+
+    // Windows which were analyzed before and did not change since then are not analyzed again.
+    // Window is unchanged when it has the same boundaries and size and all its photos were known during previous detection.
+    // Features of photos which left detection (removed, grouped) are dropped below, so they are not considered known when they come back.
+    std::map<WindowKey, const SeriesWindow*> storedWindows;
+
+    for (const SeriesWindow& window: input.storedWindows)
+        storedWindows.emplace(windowKey(window), &window);
+
+    const std::vector<Chunk> chunks = splitByTime(features, rules);
+
+    std::vector<SeriesWindow> windows(chunks.size());
+    std::vector<std::size_t> toAnalyze;
+    std::set<int> validWindows;
 
-    try
+    for (std::size_t c = 0; c < chunks.size(); c++)
     {
-        SeriesExtractor extractor(m_exifReader, suitablePhotos, rules, m_promise);
+        const auto& [first, last] = chunks[c];
 
-        auto hdrs = extractor.extract<Group::Type::HDR>();
-        auto animations = extractor.extract<Group::Type::Animation>();
-        auto generics = extractor.extract<Group::Type::Generic>();
+        // there are no series of one photo
+        if (last - first < 2)
+            continue;
 
-        std::vector<GroupCandidate> sequences;
-        std::copy(hdrs.begin(), hdrs.end(), std::back_inserter(sequences));
-        std::copy(animations.begin(), animations.end(), std::back_inserter(sequences));
-        std::copy(generics.begin(), generics.end(), std::back_inserter(sequences));
+        SeriesWindow& window = windows[c];
+        window.first = features[first].timestamp;
+        window.last = features[last - 1].timestamp;
+        window.maxGap = rules.manualSeriesMaxGap;
+        window.photos = last - first;
 
-        return sequences;
+        const bool known = std::all_of(features.begin() + first, features.begin() + last, [&input](const SeriesFeatures& f)
+        {
+            return input.storedFeatures.contains(f.id);
+        });
+
+        const auto it = known? storedWindows.find(windowKey(window)): storedWindows.end();
+
+        if (it == storedWindows.end())
+            toAnalyze.push_back(c);
+        else
+        {
+            window = *it->second;
+            validWindows.insert(window.id);
+        }
+    }
+
+    std::vector<Chunk> chunksToAnalyze;
+    chunksToAnalyze.reserve(toAnalyze.size());
+
+    for (const std::size_t c: toAnalyze)
+        chunksToAnalyze.push_back(chunks[c]);
+
+    const std::vector<std::vector<GroupCandidate>> found = analyze_photos(features, chunksToAnalyze, rules);
+    const bool canceled = m_promise && m_promise->isCanceled();
+
+    std::vector<SeriesWindow> newWindows;
+    newWindows.reserve(toAnalyze.size());
+
+    for (std::size_t i = 0; canceled == false && i < toAnalyze.size(); i++)
+    {
+        SeriesWindow& window = windows[toAnalyze[i]];
+
+        for (const GroupCandidate& candidate: found[i])
+        {
+            SeriesWindow::Candidate& c = window.candidates.emplace_back();
+            c.type = candidate.type;
+
+            for (const Photo::Data& member: candidate.members)
+                c.members.push_back(member.id);
+        }
+
+        newWindows.push_back(window);
+    }
+
+    // update stored data. Windows which are no longer valid are dropped, new ones are stored
+    std::vector<int> obsoleteWindows;
+
+    for (const SeriesWindow& window: input.storedWindows)
+        if (validWindows.contains(window.id) == false)
+            obsoleteWindows.push_back(window.id);
+
+    const std::set<Photo::Id> photos(input.photos.begin(), input.photos.end());
+    std::vector<Photo::Id> leftPhotos;
+
+    for (const auto& [id, f]: input.storedFeatures)
+        if (photos.contains(id) == false)
+            leftPhotos.push_back(id);
+
+    if (newFeatures.empty() == false || leftPhotos.empty() == false || obsoleteWindows.empty() == false || newWindows.empty() == false)
+        m_db.exec([newFeatures, leftPhotos, obsoleteWindows, newWindows](Database::IBackend& backend)
+        {
+            Database::ISeriesCacheOperator& cache = backend.seriesCacheOperator();
+
+            cache.store(newFeatures);
+            cache.dropFeatures(leftPhotos);
+            cache.replaceWindows(obsoleteWindows, newWindows);
+        });
+
+    // features are stored even when detection was canceled, but there are no results to return
+    if (canceled)
+        return {};
+
+    // keep order of results: hdrs first, then animations and generic series at the end
+    std::vector<GroupCandidate> candidates;
+
+    for (const Group::Type type: { Group::Type::HDR, Group::Type::Animation, Group::Type::Generic })
+        for (const SeriesWindow& window: windows)
+            for (const SeriesWindow::Candidate& c: window.candidates)
+                if (c.type == type)
+                {
+                    GroupCandidate& candidate = candidates.emplace_back();
+                    candidate.type = c.type;
+
+                    for (const Photo::Id& id: c.members)
+                    {
+                        Photo::Data member;                         // details are filled below
+                        member.id = id;
+
+                        candidate.members.push_back(member);
+                    }
+                }
+
+    // fill candidates with photos' details. Reuse the ones loaded already.
+    std::map<Photo::Id, Photo::Data> loaded;
+
+    for (const Photo::Data& data: input.unknownPhotos)
+        loaded.emplace(data.id, data);
+
+    std::vector<Photo::Id> toLoad;
+
+    for (const GroupCandidate& candidate: candidates)
+        for (const Photo::Data& member: candidate.members)
+            if (loaded.contains(member.id) == false)
+                toLoad.push_back(member.id);
+
+    if (toLoad.empty() == false)
+    {
+        const std::vector<Photo::Data> datas =
+            evaluate<std::vector<Photo::Data>(Database::IBackend &)>(m_db, [&toLoad](Database::IBackend& backend)
+        {
+            return backend.getPhotos(toLoad);
+        });
+
+        for (const Photo::Data& data: datas)
+            loaded.emplace(data.id, data);
     }
-    catch (const abort_exception &)
+
+    for (GroupCandidate& candidate: candidates)
+        for (Photo::Data& member: candidate.members)
+            member = loaded.at(member.id);
+
+    return candidates;
+}
+
+
+std::vector<std::vector<GroupCandidate>> SeriesDetector::analyze_photos(const std::vector<Database::SeriesFeatures>& features,
+                                                                        const std::vector<std::pair<std::size_t, std::size_t>>& chunks,
+                                                                        const Rules& rules) const
+{
+    std::vector<ChunkGroups> groups(chunks.size());
+
+    parallelFor(m_executor, chunks.size(), [&](std::size_t c)
     {
+        try
+        {
+            SeriesExtractor extractor(features, chunks[c], rules, m_promise);
+
+            groups[c].hdrs = extractor.extract<Group::Type::HDR>();
+            groups[c].animations = extractor.extract<Group::Type::Animation>();
+            groups[c].generics = extractor.extract<Group::Type::Generic>();
+        }
+        catch (const abort_exception &)
+        {
+            // cancellation is checked below
+        }
+    }, "SeriesDetector: groups detection");
+
+    if (m_promise && m_promise->isCanceled())
         return {};
+
+    std::vector<std::vector<GroupCandidate>> sequences(chunks.size());
+
+    for (std::size_t c = 0; c < chunks.size(); c++)
+    {
+        std::move(groups[c].hdrs.begin(), groups[c].hdrs.end(), std::back_inserter(sequences[c]));
+        std::move(groups[c].animations.begin(), groups[c].animations.end(), std::back_inserter(sequences[c]));
+        std::move(groups[c].generics.begin(), groups[c].generics.end(), std::back_inserter(sequences[c]));
     }
+
+    return sequences;
 }
@@ -63,6 +63,13 @@ void TagInfoCollector::gotTagValues(const TagTypes& tagType, const std::vector<T
 {
     std::unique_lock<std::mutex> lock(m_tags_mutex);
     m_tags[tagType] = values;
+
+    std::unordered_set<QString>& known = m_knownValues[tagType];
+    known.clear();
+
+    for(const TagValue& value: values)
+        known.insert(value.rawValue());
+
     lock.unlock();
 
     emit setOfValuesChanged(tagType);
@@ -84,11 +91,10 @@ void TagInfoCollector::photoModified(const IPhotoInfo::Ptr& photoInfo)
         const TagTypes& tagType = tag.first;
         const TagValue& tagValue = tag.second;
 
-        std::vector<TagValue>& values = m_tags[tagType];
-        auto found = std::find(values.begin(), values.end(), tagValue);
+        const bool inserted = m_knownValues[tagType].insert(tagValue.rawValue()).second;
 
-        if (found == values.end())
-            values.emplace_back(tagValue);
+        if (inserted)
+            m_tags[tagType].emplace_back(tagValue);
     }
 
     lock.unlock();
@@ -0,0 +1,107 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PHOTOS_INDEX_HPP_INCLUDED
+#define PHOTOS_INDEX_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <QObject>
+
+#include <database/actions.hpp>
+#include <database/filter.hpp>
+
+#include "database_export.h"
+
+
+namespace Database
+{
+    struct IBackend;
+    struct IDatabase;
+
+    /**
+     * \brief In-memory, columnar index of photos' metadata
+     *
+     * Index keeps properties most commonly used for filtering and sorting
+     * (date, time, rating, category, flags, state and group role) of all photos in compact arrays.
+     * Filters are evaluated as bitmaps, so no database queries are necessary.
+     * Results of simple predicates (like 'rating >= 3') are cached and updated with each change,
+     * so composite filters are resolved with a few bitmap operations.
+     *
+     * When attached to database, index is built in background and then kept up to date
+     * with backend's notifications. Filters and actions index cannot handle
+     * (like search expressions) are meant to be evaluated by backend.
+     *
+     * Index may be attached (in owner's thread) while it is queried (in database's thread).
+     */
+    class DATABASE_EXPORT PhotosIndex
+    {
+        public:
+            PhotosIndex();
+            PhotosIndex(const PhotosIndex &) = delete;
+            ~PhotosIndex();
+
+            PhotosIndex& operator=(const PhotosIndex &) = delete;
+
+            /**
+             * \brief attach index to database
+             *
+             * Index is built in database's thread in small steps, so other database tasks are not blocked.
+             */
+            void set(IDatabase *);
+
+            /**
+             * \brief attach index to backend
+             *
+             * Index is built immediately.
+             * Meant to be called from backend's thread.
+             */
+            void set(IBackend &);
+
+            /**
+             * \brief find photos matching filter
+             * \param filter filter to be evaluated
+             * \param action sort action to be applied on results
+             * \return ids of matching photos in order defined by action or
+             *         std::nullopt if index is not built yet or filter or action cannot be evaluated with index.
+             */
+            std::optional<std::vector<Photo::Id>> onPhotos(const Filter& filter, const Action& action) const;
+
+            /**
+             * \brief check if index was built
+             */
+            bool isReady() const;
+
+        private:
+            struct Data;
+
+            std::atomic<std::shared_ptr<Data>> m_data;
+            std::vector<QMetaObject::Connection> m_connections;
+
+            void attach(IBackend &);
+            void detach();
+
+            static void scheduleBuildStep(IDatabase *, std::weak_ptr<Data>);
+    };
+}
+
+#endif
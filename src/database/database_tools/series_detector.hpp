@@ -20,19 +20,22 @@
 #define SERIESDETECTOR_HPP
 
 #include <chrono>
-#include <deque>
+#include <utility>
+#include <vector>
 #include <QPromise>
 
 #include <core/ilogger.hpp>
 #include <database/group.hpp>
 #include <database/idatabase.hpp>
+#include <database/iseries_cache_operator.hpp>
 #include <database/photo_data.hpp>
 #include <database_export.h>
 
 #include "series_candidate.hpp"
 
 
-struct IExifReader;
+struct IExifReaderFactory;
+struct ITaskExecutor;
 
 
 class DATABASE_EXPORT SeriesDetector
@@ -45,16 +48,28 @@ class DATABASE_EXPORT SeriesDetector
             Rules(std::chrono::milliseconds manualSeriesMaxGap = std::chrono::seconds(10));
         };
 
-        SeriesDetector(Database::IDatabase &, IExifReader &, const QPromise<std::vector<GroupCandidate>> * = nullptr);
+        /**
+         * \brief constructor
+         * \param db database to analyze
+         * \param exif source of exif readers. Exif data is read in parallel, so reader for each thread is required
+         * \param executor executor for parallel work. Detector itself may be run as executor's task.
+         * \param promise optional promise used for cancellation
+         */
+        SeriesDetector(Database::IDatabase &, IExifReaderFactory &, ITaskExecutor &, const QPromise<std::vector<GroupCandidate>> * = nullptr);
 
         std::vector<GroupCandidate> listCandidates(const Rules& = Rules()) const;
 
     private:
         Database::IDatabase& m_db;
         const QPromise<std::vector<GroupCandidate>>* m_promise;
-        IExifReader& m_exifReader;
+        IExifReaderFactory& m_exifReaderFactory;
+        ITaskExecutor& m_executor;
 
-        std::vector<GroupCandidate> analyze_photos(const std::deque<Photo::Data> &, const Rules &) const;
+        // analyzes given ranges of photos independently.
+        // Returns candidates (with members' ids only) for each range
+        std::vector<std::vector<GroupCandidate>> analyze_photos(const std::vector<Database::SeriesFeatures> &,
+                                                                const std::vector<std::pair<std::size_t, std::size_t>> &,
+                                                                const Rules &) const;
 };
 
 #endif // SERIESDETECTOR_HPP
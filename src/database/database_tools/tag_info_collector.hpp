@@ -21,6 +21,7 @@
 #define TAGINFOCOLLECTOR_HPP
 
 #include <mutex>
+#include <unordered_set>
 
 #include <database/database_tools/signal_mapper.hpp>
 
@@ -49,6 +50,7 @@ class DATABASE_EXPORT TagInfoCollector: public ITagInfoCollector
     private:
         Database::SignalMapper m_mapper;
         mutable std::map<TagTypes, std::vector<TagValue>> m_tags;
+        std::map<TagTypes, std::unordered_set<QString>> m_knownValues;     // raw values from m_tags for fast lookups
         mutable std::mutex m_tags_mutex;
         Database::IDatabase* m_database;
         int m_observerId;
@@ -0,0 +1,98 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DATE_HISTOGRAM_HPP_INCLUDED
+#define DATE_HISTOGRAM_HPP_INCLUDED
+
+#include <map>
+#include <QDate>
+
+
+namespace Database
+{
+    /**
+     * \brief Number of photos taken in each period of time
+     *
+     * Photos without date are counted under invalid QDate.
+     */
+    struct DateHistogram
+    {
+        enum class Granularity
+        {
+            Day,
+            Month,
+            Year,
+        };
+
+        explicit DateHistogram(Granularity g = Granularity::Day)
+            : granularity(g)
+        {
+
+        }
+
+        /// first day of period (day, month or year) \a date belongs to
+        static QDate periodOf(const QDate& date, Granularity g)
+        {
+            if (date.isValid() == false)
+                return QDate();
+
+            switch (g)
+            {
+                case Granularity::Day:   return date;
+                case Granularity::Month: return QDate(date.year(), date.month(), 1);
+                case Granularity::Year:  return QDate(date.year(), 1, 1);
+            }
+
+            return date;
+        }
+
+        /// add \a count photos taken at \a date
+        void add(const QDate& date, int count = 1)
+        {
+            if (count != 0)
+                photos[periodOf(date, granularity)] += count;
+        }
+
+        /// histogram with the same data but with coarser granularity
+        DateHistogram regroup(Granularity g) const
+        {
+            DateHistogram result(g);
+
+            for(const auto& [period, count]: photos)
+                result.add(period, count);
+
+            return result;
+        }
+
+        int total() const
+        {
+            int sum = 0;
+
+            for(const auto& [period, count]: photos)
+                sum += count;
+
+            return sum;
+        }
+
+        Granularity granularity;
+        std::map<QDate, int> photos;        // first day of period -> number of photos
+    };
+}
+
+#endif
@@ -13,6 +13,13 @@ namespace Database::CommonGeneralFlags
         Broken      = 1,                    // 1 - one or more photo parameters could not be determined (dimension, thumbnail etc)
         Missing     = 2,                    // 2 - photo file is missing
     };
+
+    const QString AnalysisAttempts("analysis_attempts");    // number of started but not finished analyses of photo.
+                                                            // 0 (or nonexistent) - photo is not being analyzed.
+                                                            // Nonzero value at startup means analysis was interrupted by abnormal exit.
+
+    const QString FacesRecognized("faces_recognized");      // 0 (or nonexistent) - faces on photo were not looked for yet.
+                                                            // 1 - faces were located and their fingerprints stored.
 }
 
 #endif // GENERAL_FLAGS_HPP_INCLUDED
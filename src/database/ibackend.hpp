@@ -20,6 +20,7 @@
 #ifndef IBACKEND_HPP
 #define IBACKEND_HPP
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -48,6 +49,7 @@ public:
 #include <core/tag.hpp>
 
 #include "database_status.hpp"
+#include "date_histogram.hpp"
 #include "filter.hpp"
 #include "group.hpp"
 #include "person_data.hpp"
@@ -68,6 +70,7 @@ namespace Database
     struct IGroupOperator;
     struct IPhotoChangeLogOperator;
     struct IPhotoOperator;
+    struct ISeriesCacheOperator;
     struct ProjectInfo;
 
     // for internal usage
@@ -135,13 +138,22 @@ namespace Database
         virtual std::vector<TagValue>    listTagValues(const TagTypes &,
                                                        const Filter &) = 0;
 
+        /// list all values of tag with number of photos using each of them
+        virtual std::vector<std::pair<TagValue, int>> countTagValues(const TagTypes &) = 0;
+
         /// get particular photo
         virtual Photo::Data              getPhoto(const Photo::Id &) = 0;
         virtual Photo::DataDelta         getPhotoDelta(const Photo::Id &, const std::set<Photo::Field> & = {}) = 0;
 
+        /// get many photos at once (in order of provided ids). Nonexistent photos are skipped
+        virtual std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) = 0;
+
         /// Count photos matching filter
         virtual int                      getPhotosCount(const Filter &) = 0;
 
+        /// Count photos matching filter in each day, month or year (depending on granularity)
+        virtual DateHistogram            getDateHistogram(const Filter &, DateHistogram::Granularity) = 0;
+
         /**
          * \brief set flag for photo to given value
          * \arg id id of photo
@@ -152,6 +164,15 @@ namespace Database
          */
         virtual void                     set(const Photo::Id& id, const QString& name, int value) = 0;
 
+        /**
+         * \brief set flag for many photos at once
+         * \arg name flag name
+         * \arg values flag value for each photo
+         *
+         * Method sets flag with given values on photos. All values are stored in one transaction.
+         */
+        virtual void                     set(const QString& name, const std::map<Photo::Id, int>& values) = 0;
+
         /**
          * \brief get flag value
          * \arg id id of photo
@@ -176,6 +197,16 @@ namespace Database
          */
         virtual std::vector<Photo::Id> markStagedAsReviewed() = 0;
 
+        /**
+         * \brief store results of faces analysis
+         * \arg faces faces (location and fingerprint) found on each photo
+         *
+         * Method stores faces with their fingerprints and marks photos with   \n
+         * FacesRecognized flag (also those with no faces found).              \n
+         * All changes are stored in one transaction.
+         */
+        virtual void storeFaces(const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>>& faces) = 0;
+
         // write extra data
         //virtual bool setThumbnail(const Photo::Id &, const QByteArray &) = 0;                  // set thumbnail for photo
 
@@ -208,6 +239,12 @@ namespace Database
 
         virtual IPeopleInformationAccessor& peopleInformationAccessor() = 0;
 
+        /**
+         * \brief get series detection cache operator
+         * \return series cache operator
+         */
+        virtual ISeriesCacheOperator& seriesCacheOperator() = 0;
+
     signals:
         /// emited after new photos were added to database
         void photosAdded(const std::vector<Photo::Id> &);
@@ -221,6 +258,9 @@ namespace Database
         ///< emited when done with photos marking
         void photosMarkedAsReviewed(const std::vector<Photo::Id> &);
 
+        ///< emited when general flag of photo was set
+        void generalFlagChanged(const Photo::Id &, const QString& name, int value);
+
     private:
         Q_OBJECT
     };
@@ -46,6 +46,9 @@ namespace Photo
         if (delta.has(Photo::Field::Path))
             path = delta.get<Photo::Field::Path>();
 
+        if (delta.has(Photo::Field::PHash))
+            phash = delta.get<Photo::Field::PHash>();
+
         return *this;
     }
 
@@ -129,6 +132,7 @@ namespace Photo
         insert<Photo::Field::Flags>(data.flags);
         insert<Photo::Field::GroupInfo>(data.groupInfo);
         insert<Photo::Field::Path>(data.path);
+        insert<Photo::Field::PHash>(data.phash);
 
         return *this;
     }
@@ -49,7 +49,7 @@ IPhotoInfo::Ptr PhotoInfoCache::find(const Photo::Id& id) const
     {
         result = it->second.lock();
 
-        if (result.get() == nullptr)
+        if (result.get() == nullptr && m_logger->isEnabled(ILogger::Severity::Debug))
         {
             const QString msg = QString("Photo with id %1 was recently used but has no clients at this moment.").arg(id);
             m_logger->debug(msg);
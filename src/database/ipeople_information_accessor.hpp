@@ -18,6 +18,9 @@ namespace Database
             /// list people on photo
             virtual std::vector<PersonInfo>  listPeople(const Photo::Id &) = 0;
 
+            /// list people on many photos at once
+            virtual std::vector<PersonInfo>  listPeople(const std::vector<Photo::Id> &) = 0;
+
             /**
             * \brief get person details
             * \arg id person id
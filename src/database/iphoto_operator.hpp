@@ -19,6 +19,9 @@ namespace Database
 
         /// find all photos matching filters
         virtual std::vector<Photo::Id> getPhotos(const Filter &) = 0;
+
+        /// find groups of photos (matching filters) with identical content (the same sha256 sum)
+        virtual std::vector<std::vector<Photo::Id>> findDuplicates(const Filter &) = 0;
     };
 }
 
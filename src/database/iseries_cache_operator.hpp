@@ -0,0 +1,85 @@
+#ifndef ISERIES_CACHE_OPERATOR_HPP
+#define ISERIES_CACHE_OPERATOR_HPP
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include "group.hpp"
+#include "photo_types.hpp"
+
+namespace Database
+{
+    /**
+     * \brief photo properties used by series detection
+     *
+     * Collecting them requires reading exif data which is slow,
+     * so they are stored in database for later detections.
+     */
+    struct SeriesFeatures
+    {
+        Photo::Id id;
+        std::chrono::milliseconds timestamp = std::chrono::milliseconds(0);
+        std::optional<int> sequenceNumber;
+        std::optional<int> exposure;                    // centi-exposure (1/100 EV)
+        bool image = false;                             // only images are considered during detection
+
+        bool operator==(const SeriesFeatures &) const = default;
+    };
+
+    /**
+     * \brief series detection results for range of photos
+     *
+     * Window is a range of photos (sorted by time) separated from other photos
+     * by a gap longer than max gap used for detection, so it was analyzed independently of them.
+     * Window is identified by timestamps of its first and last photo and number of photos.
+     * When any of them changes, window needs to be analyzed again.
+     */
+    struct SeriesWindow
+    {
+        struct Candidate
+        {
+            Group::Type type = Group::Type::Invalid;
+            std::vector<Photo::Id> members;
+
+            bool operator==(const Candidate &) const = default;
+        };
+
+        int id = 0;                                     // assigned by backend
+        std::chrono::milliseconds first = std::chrono::milliseconds(0);
+        std::chrono::milliseconds last = std::chrono::milliseconds(0);
+        std::chrono::milliseconds maxGap = std::chrono::milliseconds(0);
+        std::size_t photos = 0;
+        std::vector<Candidate> candidates;
+
+        bool operator==(const SeriesWindow &) const = default;
+    };
+
+    /**
+     * \brief storage for series detection's data
+     *
+     * Stored features of photo are dropped by backend when photo's tags are modified
+     * (timestamp may change) or when photo is removed.
+     */
+    struct ISeriesCacheOperator
+    {
+        virtual ~ISeriesCacheOperator() = default;
+
+        /// list features of all photos which have them stored
+        virtual std::vector<SeriesFeatures> listFeatures() = 0;
+
+        /// store (or replace) features of photos
+        virtual bool store(const std::vector<SeriesFeatures> &) = 0;
+
+        /// drop features of photos
+        virtual bool dropFeatures(const std::vector<Photo::Id> &) = 0;
+
+        /// list windows analyzed during previous detections
+        virtual std::vector<SeriesWindow> listWindows() = 0;
+
+        /// drop windows with given ids and store new ones (their ids are ignored)
+        virtual bool replaceWindows(const std::vector<int>& obsolete, const std::vector<SeriesWindow>& windows) = 0;
+    };
+}
+
+#endif
@@ -43,6 +43,7 @@ namespace Photo
         QString              path;
         QSize                geometry;
         GroupInfo            groupInfo;
+        Photo::PHashT        phash;
 
         Data() = default;
         Data(const Data &) = default;
@@ -66,6 +67,7 @@ namespace Photo
         Path,
         Geometry,
         GroupInfo,
+        PHash,
     };
 
     template<Field>
@@ -107,6 +109,12 @@ namespace Photo
         typedef GroupInfo Storage;
     };
 
+    template<>
+    struct DeltaTypes<Field::PHash>
+    {
+        typedef Photo::PHashT Storage;
+    };
+
     class DATABASE_EXPORT DataDelta
     {
         public:
@@ -158,7 +166,8 @@ namespace Photo
                                  DeltaTypes<Field::Flags>::Storage,
                                  DeltaTypes<Field::Path>::Storage,
                                  DeltaTypes<Field::Geometry>::Storage,
-                                 DeltaTypes<Field::GroupInfo>::Storage> Storage;
+                                 DeltaTypes<Field::GroupInfo>::Storage,
+                                 DeltaTypes<Field::PHash>::Storage> Storage;
 
             Photo::Id                m_id;
             std::map<Field, Storage> m_data;
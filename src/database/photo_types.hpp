@@ -2,6 +2,7 @@
 #ifndef PHOTO_TYPES_HPP
 #define PHOTO_TYPES_HPP
 
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <string>
@@ -20,6 +21,7 @@ namespace Photo
     typedef QByteArray Sha256sum;
 
     using Id = Id<int, struct photo_tag>;
+    using PHashT = ::Id<std::uint64_t, struct phash_tag>;     // perceptual hash
 
     enum class FlagsE
     {
@@ -28,6 +30,7 @@ namespace Photo
         Sha256Loaded,
         ThumbnailLoaded,
         GeometryLoaded,
+        PHashLoaded,
     };
     Q_ENUM_NS(FlagsE)
 
@@ -0,0 +1,50 @@
+#include <gmock/gmock.h>
+
+#include "database_tools/implementation/adaptive_batch_size.hpp"
+
+
+using namespace std::chrono_literals;
+
+
+TEST(AdaptiveBatchSizeTest, growsWhenWritesAreFast)
+{
+    AdaptiveBatchSize batchSize(100, 10, 1000, 50ms);
+
+    for (int i = 0; i < 20; i++)
+        batchSize.reportWrite(batchSize.target(), 1ms);
+
+    EXPECT_EQ(batchSize.target(), 1000);
+}
+
+
+TEST(AdaptiveBatchSizeTest, shrinksWhenWritesAreSlow)
+{
+    AdaptiveBatchSize batchSize(100, 10, 1000, 50ms);
+
+    for (int i = 0; i < 20; i++)
+        batchSize.reportWrite(batchSize.target(), 500ms);
+
+    EXPECT_EQ(batchSize.target(), 10);
+}
+
+
+TEST(AdaptiveBatchSizeTest, convergesToTargetDuration)
+{
+    AdaptiveBatchSize batchSize(100, 10, 1000, 50ms);
+
+    // each item takes 200us to write - 250 items fit in 50ms
+    for (int i = 0; i < 50; i++)
+        batchSize.reportWrite(batchSize.target(), std::chrono::microseconds(batchSize.target() * 200));
+
+    EXPECT_NEAR(static_cast<double>(batchSize.target()), 250.0, 5.0);
+}
+
+
+TEST(AdaptiveBatchSizeTest, smallBatchesDoNotCauseGrowth)
+{
+    AdaptiveBatchSize batchSize(100, 10, 1000, 50ms);
+
+    batchSize.reportWrite(5, 1ms);
+
+    EXPECT_EQ(batchSize.target(), 100);
+}
@@ -0,0 +1,108 @@
+
+#include <gmock/gmock.h>
+
+#include "database_tools/implementation/bitmap.hpp"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+
+namespace
+{
+    std::vector<std::size_t> setBits(const Bitmap& bitmap)
+    {
+        std::vector<std::size_t> bits;
+        bitmap.forEach([&bits](std::size_t idx) { bits.push_back(idx); });
+
+        return bits;
+    }
+}
+
+
+TEST(BitmapTest, emptyBitmap)
+{
+    const Bitmap bitmap(130);
+
+    EXPECT_EQ(bitmap.size(), 130);
+    EXPECT_EQ(bitmap.count(), 0);
+    EXPECT_THAT(setBits(bitmap), IsEmpty());
+}
+
+
+TEST(BitmapTest, fullBitmap)
+{
+    const Bitmap bitmap(130, true);
+
+    EXPECT_EQ(bitmap.count(), 130);
+    EXPECT_EQ(bitmap, ~Bitmap(130));
+}
+
+
+TEST(BitmapTest, settingBits)
+{
+    Bitmap bitmap(200);
+    bitmap.set(0);
+    bitmap.set(63);
+    bitmap.set(64);
+    bitmap.set(199);
+    bitmap.set(150);
+    bitmap.set(150, false);
+
+    EXPECT_TRUE(bitmap.test(63));
+    EXPECT_FALSE(bitmap.test(62));
+    EXPECT_THAT(setBits(bitmap), ElementsAre(0, 63, 64, 199));
+}
+
+
+TEST(BitmapTest, constructionFromPredicate)
+{
+    const Bitmap bitmap = Bitmap::fromPredicate(100, [](std::size_t idx) { return idx % 30 == 0; });
+
+    EXPECT_THAT(setBits(bitmap), ElementsAre(0, 30, 60, 90));
+}
+
+
+TEST(BitmapTest, logicalOperations)
+{
+    const Bitmap even = Bitmap::fromPredicate(70, [](std::size_t idx) { return idx % 2 == 0; });
+    const Bitmap byThree = Bitmap::fromPredicate(70, [](std::size_t idx) { return idx % 3 == 0; });
+
+    Bitmap both = even;
+    both &= byThree;
+
+    Bitmap any = even;
+    any |= byThree;
+
+    EXPECT_EQ(both, Bitmap::fromPredicate(70, [](std::size_t idx) { return idx % 6 == 0; }));
+    EXPECT_EQ(any, Bitmap::fromPredicate(70, [](std::size_t idx) { return idx % 2 == 0 || idx % 3 == 0; }));
+    EXPECT_EQ((~even).count(), 35);
+}
+
+
+TEST(BitmapTest, andNot)
+{
+    Bitmap all(70, true);
+    const Bitmap even = Bitmap::fromPredicate(70, [](std::size_t idx) { return idx % 2 == 0; });
+
+    all.andNot(even);
+
+    EXPECT_EQ(all, ~even);
+}
+
+
+TEST(BitmapTest, resizing)
+{
+    Bitmap bitmap(10, true);
+
+    bitmap.resize(100);
+    EXPECT_EQ(bitmap.count(), 10);
+
+    bitmap.set(99);
+    bitmap.resize(64);
+    EXPECT_EQ(bitmap.count(), 10);
+    EXPECT_FALSE(bitmap.test(63));
+
+    bitmap.resize(5);
+    EXPECT_EQ(bitmap.count(), 5);
+    EXPECT_EQ(bitmap, Bitmap(5, true));
+}
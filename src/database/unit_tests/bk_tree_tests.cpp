@@ -0,0 +1,63 @@
+
+#include <bit>
+#include <random>
+
+#include <gmock/gmock.h>
+
+#include "database_tools/implementation/bk_tree.hpp"
+
+using testing::IsEmpty;
+using testing::UnorderedElementsAreArray;
+
+
+namespace
+{
+    struct Hamming
+    {
+        int operator()(std::uint64_t lhs, std::uint64_t rhs) const
+        {
+            return std::popcount(lhs ^ rhs);
+        }
+    };
+}
+
+
+TEST(BKTreeTest, emptyTree)
+{
+    BKTree<std::uint64_t, Hamming> tree;
+
+    EXPECT_THAT(tree.find(0, 64), IsEmpty());
+}
+
+
+TEST(BKTreeTest, findsSameResultsAsLinearSearch)
+{
+    BKTree<std::uint64_t, Hamming> tree;
+    std::vector<std::uint64_t> values;
+
+    std::mt19937_64 gen(1234);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        const std::uint64_t value = gen();
+
+        values.push_back(value);
+        tree.insert(value);
+
+        // add some close values
+        values.push_back(value ^ 0b101);
+        tree.insert(value ^ 0b101);
+    }
+
+    for (const int distance: {0, 2, 5, 20})
+        for (std::size_t i = 0; i < values.size(); i += 97)
+        {
+            std::vector<std::size_t> expected;
+
+            for (std::size_t j = 0; j < values.size(); j++)
+                if (Hamming()(values[i], values[j]) <= distance)
+                    expected.push_back(j);
+
+            EXPECT_THAT(tree.find(values[i], distance), UnorderedElementsAreArray(expected));
+        }
+}
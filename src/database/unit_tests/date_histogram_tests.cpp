@@ -0,0 +1,46 @@
+#include <gmock/gmock.h>
+
+#include "date_histogram.hpp"
+
+using testing::ElementsAre;
+using testing::Pair;
+
+
+TEST(DateHistogramTest, periodOf)
+{
+    const QDate date(2021, 7, 15);
+
+    EXPECT_EQ(Database::DateHistogram::periodOf(date, Database::DateHistogram::Granularity::Day), date);
+    EXPECT_EQ(Database::DateHistogram::periodOf(date, Database::DateHistogram::Granularity::Month), QDate(2021, 7, 1));
+    EXPECT_EQ(Database::DateHistogram::periodOf(date, Database::DateHistogram::Granularity::Year), QDate(2021, 1, 1));
+    EXPECT_FALSE(Database::DateHistogram::periodOf(QDate(), Database::DateHistogram::Granularity::Year).isValid());
+}
+
+
+TEST(DateHistogramTest, photosAreGroupedByPeriod)
+{
+    Database::DateHistogram histogram(Database::DateHistogram::Granularity::Month);
+
+    histogram.add(QDate(2021, 7, 15));
+    histogram.add(QDate(2021, 7, 20), 2);
+    histogram.add(QDate(2021, 8, 1));
+    histogram.add(QDate(), 4);
+
+    EXPECT_THAT(histogram.photos, ElementsAre(Pair(QDate(), 4), Pair(QDate(2021, 7, 1), 3), Pair(QDate(2021, 8, 1), 1)));
+    EXPECT_EQ(histogram.total(), 8);
+}
+
+
+TEST(DateHistogramTest, regrouping)
+{
+    Database::DateHistogram histogram;
+
+    histogram.add(QDate(2020, 12, 31), 2);
+    histogram.add(QDate(2021, 1, 1));
+    histogram.add(QDate(2021, 5, 5), 3);
+
+    const Database::DateHistogram years = histogram.regroup(Database::DateHistogram::Granularity::Year);
+
+    EXPECT_EQ(years.granularity, Database::DateHistogram::Granularity::Year);
+    EXPECT_THAT(years.photos, ElementsAre(Pair(QDate(2020, 1, 1), 2), Pair(QDate(2021, 1, 1), 4)));
+}
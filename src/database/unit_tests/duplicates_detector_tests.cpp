@@ -0,0 +1,185 @@
+
+#include <unit_tests_utils/mock_backend.hpp>
+#include <unit_tests_utils/mock_photo_operator.hpp>
+
+#include "database_tools/duplicates_detector.hpp"
+#include "unit_tests_utils/mock_database.hpp"
+
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+using testing::UnorderedElementsAre;
+
+
+namespace
+{
+    std::vector<Photo::Id> ids(const DuplicatesCandidate& candidate)
+    {
+        std::vector<Photo::Id> result;
+
+        for (const auto& member: candidate.members)
+            result.push_back(member.id);
+
+        return result;
+    }
+}
+
+
+class DuplicatesDetectorTest: public testing::Test
+{
+    public:
+        NiceMock<MockDatabase> db;
+        NiceMock<MockBackend> backend;
+        NiceMock<PhotoOperatorMock> photoOperator;
+        std::map<Photo::Id, Photo::DataDelta> photos;
+
+        DuplicatesDetectorTest()
+        {
+            ON_CALL(db, execute(_)).WillByDefault(Invoke([this](const auto& task)
+            {
+                task->run(backend);
+            }));
+
+            ON_CALL(backend, photoOperator()).WillByDefault(ReturnRef(photoOperator));
+            ON_CALL(photoOperator, getPhotos(_)).WillByDefault(Invoke([this](const Database::Filter &)
+            {
+                std::vector<Photo::Id> result;
+
+                for (const auto& photo: photos)
+                    result.push_back(photo.first);
+
+                return result;
+            }));
+
+            ON_CALL(photoOperator, findDuplicates(_)).WillByDefault(Invoke([this](const Database::Filter &)
+            {
+                std::map<Photo::Sha256sum, std::vector<Photo::Id>> photosBySha256;
+
+                for (const auto& [id, photo]: photos)
+                    photosBySha256[photo.get<Photo::Field::Checksum>()].push_back(id);
+
+                std::vector<std::vector<Photo::Id>> result;
+
+                for (const auto& [sha256, ids]: photosBySha256)
+                    if (ids.size() > 1)
+                        result.push_back(ids);
+
+                return result;
+            }));
+
+            ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke([this](const std::vector<Photo::Id>& ids)
+            {
+                std::vector<Photo::Data> result;
+
+                for (const Photo::Id& id: ids)
+                    result.push_back(Photo::Data().apply(photos.at(id)));
+
+                return result;
+            }));
+        }
+
+        void addPhoto(int id, const QByteArray& sha256, std::optional<std::uint64_t> phash)
+        {
+            Photo::DataDelta delta(Photo::Id(id));
+            delta.insert<Photo::Field::Path>(QString("%1.jpeg").arg(id));
+            delta.insert<Photo::Field::Checksum>(sha256);
+
+            if (phash)
+                delta.insert<Photo::Field::PHash>(Photo::PHashT(*phash));
+
+            photos.emplace(Photo::Id(id), delta);
+        }
+};
+
+
+TEST_F(DuplicatesDetectorTest, emptyCollection)
+{
+    DuplicatesDetector detector(db);
+
+    EXPECT_TRUE(detector.listCandidates().empty());
+}
+
+
+TEST_F(DuplicatesDetectorTest, exactDuplicates)
+{
+    addPhoto(1, "aaa", {});
+    addPhoto(2, "bbb", {});
+    addPhoto(3, "aaa", {});
+    addPhoto(4, "ccc", {});
+    addPhoto(5, "aaa", {});
+
+    DuplicatesDetector detector(db);
+    const auto candidates = detector.listCandidates();
+
+    ASSERT_EQ(candidates.size(), 1);
+    EXPECT_EQ(candidates[0].type, DuplicatesCandidate::Type::Exact);
+    EXPECT_THAT(ids(candidates[0]), UnorderedElementsAre(Photo::Id(1), Photo::Id(3), Photo::Id(5)));
+}
+
+
+TEST_F(DuplicatesDetectorTest, similarPhotos)
+{
+    addPhoto(1, "aaa", 0xff00ff00ff00ff00);
+    addPhoto(2, "bbb", 0xff00ff00ff00ff03);       // 2 bits of difference
+    addPhoto(3, "ccc", 0x00ff00ff00ff00ff);       // completely different
+    addPhoto(4, "ddd", 0xff00ff00ff00ff01);       // 1 bit of difference to photo #1 and #2
+
+    DuplicatesDetector detector(db);
+    const auto candidates = detector.listCandidates(DuplicatesDetector::Rules(2));
+
+    ASSERT_EQ(candidates.size(), 1);
+    EXPECT_EQ(candidates[0].type, DuplicatesCandidate::Type::Similar);
+    EXPECT_THAT(ids(candidates[0]), UnorderedElementsAre(Photo::Id(1), Photo::Id(2), Photo::Id(4)));
+}
+
+
+TEST_F(DuplicatesDetectorTest, similarityIsNotChained)
+{
+    addPhoto(1, "aaa", 0xff00ff00ff00ff00);
+    addPhoto(2, "bbb", 0xff00ff00ff00ff03);       // 2 bits of difference to photo #1
+    addPhoto(3, "ccc", 0xff00ff00ff00ff0f);       // 2 bits of difference to photo #2, 4 bits to photo #1
+
+    DuplicatesDetector detector(db);
+    const auto candidates = detector.listCandidates(DuplicatesDetector::Rules(2));
+
+    ASSERT_EQ(candidates.size(), 1);
+    EXPECT_EQ(candidates[0].type, DuplicatesCandidate::Type::Similar);
+    EXPECT_THAT(ids(candidates[0]), UnorderedElementsAre(Photo::Id(1), Photo::Id(2)));
+}
+
+
+TEST_F(DuplicatesDetectorTest, exactDuplicatesAreNotReportedAsSimilar)
+{
+    addPhoto(1, "aaa", 0x1234);
+    addPhoto(2, "aaa", 0x1234);
+
+    DuplicatesDetector detector(db);
+    const auto candidates = detector.listCandidates();
+
+    ASSERT_EQ(candidates.size(), 1);
+    EXPECT_EQ(candidates[0].type, DuplicatesCandidate::Type::Exact);
+}
+
+
+TEST_F(DuplicatesDetectorTest, onlyDuplicatesAndHashedPhotosAreLoaded)
+{
+    addPhoto(1, "aaa", {});
+    addPhoto(2, "aaa", {});
+    addPhoto(3, "bbb", {});
+    addPhoto(4, "ccc", {});
+
+    // no photo has perceptual hash
+    ON_CALL(photoOperator, getPhotos(_)).WillByDefault(Return(std::vector<Photo::Id>()));
+
+    // only identical photos are loaded
+    EXPECT_CALL(backend, getPhotos(UnorderedElementsAre(Photo::Id(1), Photo::Id(2)))).Times(1);
+
+    DuplicatesDetector detector(db);
+    const auto candidates = detector.listCandidates();
+
+    ASSERT_EQ(candidates.size(), 1);
+    EXPECT_EQ(candidates[0].type, DuplicatesCandidate::Type::Exact);
+}
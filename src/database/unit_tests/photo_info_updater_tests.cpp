@@ -1,6 +1,9 @@
 
 #include <gmock/gmock.h>
 
+#include <QCryptographicHash>
+#include <QTemporaryFile>
+
 #include "database_tools/implementation/photo_info_updater.hpp"
 #include "unit_tests_utils/empty_logger.hpp"
 #include "unit_tests_utils/fake_task_executor.hpp"
@@ -26,7 +29,7 @@ TEST(PhotoInfoUpdaterTest, exifUpdate)
     FakeTaskExecutor taskExecutor;
     NiceMock<MockBackend> backend;
     NiceMock<ExifReaderFactoryMock> exifFactoryMock;
-    NiceMock<MockExifReader> exifReader;
+    auto readers = ObjectsPool<IExifReader>::create([]{ return std::make_unique<NiceMock<MockExifReader>>(); }, 1, std::chrono::seconds(1));
     NiceMock<ILoggerFactoryMock> loggerFactoryMock;
     NiceMock<IConfigurationMock> configurationMock;
     NiceMock<ICoreFactoryAccessorMock> coreFactory;
@@ -36,7 +39,10 @@ TEST(PhotoInfoUpdaterTest, exifUpdate)
     ON_CALL(coreFactory, getConfiguration).WillByDefault(ReturnRef(configurationMock));
     ON_CALL(coreFactory, getLoggerFactory).WillByDefault(ReturnRef(loggerFactoryMock));
     ON_CALL(coreFactory, getTaskExecutor).WillByDefault(ReturnRef(taskExecutor));
-    ON_CALL(exifFactoryMock, get).WillByDefault(ReturnRef(exifReader));
+    ON_CALL(exifFactoryMock, checkout).WillByDefault(Invoke([&readers]
+    {
+        return readers->checkout();
+    }));
     ON_CALL(loggerFactoryMock, get(An<const QString &>())).WillByDefault(Invoke([](const auto &)
     {
         return std::make_unique<EmptyLogger>();
@@ -64,5 +70,53 @@ TEST(PhotoInfoUpdaterTest, exifUpdate)
     EXPECT_CALL(backend, update(expectedUpdate));
 
     PhotoInfoUpdater updater(&coreFactory, db);
-    updater.updateTags(photo);
+    updater.updateMetadata(photo);
+}
+
+
+TEST(PhotoInfoUpdaterTest, sha256Update)
+{
+    FakeTaskExecutor taskExecutor;
+    NiceMock<MockBackend> backend;
+    NiceMock<ExifReaderFactoryMock> exifFactoryMock;
+    NiceMock<ILoggerFactoryMock> loggerFactoryMock;
+    NiceMock<IConfigurationMock> configurationMock;
+    NiceMock<ICoreFactoryAccessorMock> coreFactory;
+    NiceMock<MockDatabase> db;
+
+    ON_CALL(coreFactory, getExifReaderFactory).WillByDefault(ReturnRef(exifFactoryMock));
+    ON_CALL(coreFactory, getConfiguration).WillByDefault(ReturnRef(configurationMock));
+    ON_CALL(coreFactory, getLoggerFactory).WillByDefault(ReturnRef(loggerFactoryMock));
+    ON_CALL(coreFactory, getTaskExecutor).WillByDefault(ReturnRef(taskExecutor));
+    ON_CALL(loggerFactoryMock, get(An<const QString &>())).WillByDefault(Invoke([](const auto &)
+    {
+        return std::make_unique<EmptyLogger>();
+    }));
+
+    ON_CALL(db, execute).WillByDefault(Invoke([&backend](std::unique_ptr<Database::IDatabase::ITask>&& task)
+    {
+        task->run(backend);
+    }));
+
+    // file to be hashed
+    const QByteArray content(10 * 1024 * 1024, 'x');
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write(content);
+    file.close();
+
+    Photo::Data photo;
+    photo.id = Photo::Id(123);
+    photo.path = file.fileName();
+
+    // expect raw (binary) digest to be stored
+    Photo::DataDelta photoDelta(photo.id);
+    photoDelta.insert<Photo::Field::Checksum>(QCryptographicHash::hash(content, QCryptographicHash::Sha256));
+    photoDelta.insert<Photo::Field::Flags>( {{Photo::FlagsE::Sha256Loaded, 1}} );
+
+    const std::vector<Photo::DataDelta> expectedUpdate{photoDelta};
+    EXPECT_CALL(backend, update(expectedUpdate));
+
+    PhotoInfoUpdater updater(&coreFactory, db);
+    updater.updateSha256(photo);
 }
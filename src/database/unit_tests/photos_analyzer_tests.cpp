@@ -0,0 +1,189 @@
+#include <gmock/gmock.h>
+
+#include <QImage>
+#include <QTemporaryDir>
+
+#include "backends/memory_backend/memory_backend.hpp"
+#include "database_tools/photos_analyzer.hpp"
+#include "general_flags.hpp"
+#include "unit_tests_utils/empty_logger.hpp"
+#include "unit_tests_utils/fake_task_executor.hpp"
+#include "unit_tests_utils/mock_core_factory_accessor.hpp"
+#include "unit_tests_utils/mock_configuration.hpp"
+#include "unit_tests_utils/mock_database.hpp"
+#include "unit_tests_utils/mock_exif_reader_factory.hpp"
+#include "unit_tests_utils/mock_exif_reader.hpp"
+#include "unit_tests_utils/mock_logger_factory.hpp"
+
+
+using testing::_;
+using testing::An;
+using testing::Invoke;
+using testing::ReturnRef;
+using testing::NiceMock;
+
+
+class PhotosAnalyzerTest: public testing::Test
+{
+    public:
+        FakeTaskExecutor taskExecutor;
+        Database::MemoryBackend backend;
+        NiceMock<ExifReaderFactoryMock> exifFactoryMock;
+        std::shared_ptr<ObjectsPool<IExifReader>> readers;
+        NiceMock<ILoggerFactoryMock> loggerFactoryMock;
+        NiceMock<IConfigurationMock> configurationMock;
+        NiceMock<ICoreFactoryAccessorMock> coreFactory;
+        NiceMock<MockDatabase> db;
+        QTemporaryDir dir;
+
+        PhotosAnalyzerTest()
+            : readers(ObjectsPool<IExifReader>::create([]{ return std::make_unique<NiceMock<MockExifReader>>(); }, 1, std::chrono::seconds(1)))
+        {
+            ON_CALL(coreFactory, getExifReaderFactory).WillByDefault(ReturnRef(exifFactoryMock));
+            ON_CALL(coreFactory, getConfiguration).WillByDefault(ReturnRef(configurationMock));
+            ON_CALL(coreFactory, getLoggerFactory).WillByDefault(ReturnRef(loggerFactoryMock));
+            ON_CALL(coreFactory, getTaskExecutor).WillByDefault(ReturnRef(taskExecutor));
+            ON_CALL(exifFactoryMock, checkout).WillByDefault(Invoke([this]
+            {
+                return readers->checkout();
+            }));
+            ON_CALL(loggerFactoryMock, get(An<const QString &>())).WillByDefault(Invoke([](const auto &)
+            {
+                return std::make_unique<EmptyLogger>();
+            }));
+
+            ON_CALL(db, execute).WillByDefault(Invoke([this](std::unique_ptr<Database::IDatabase::ITask>&& task)
+            {
+                task->run(backend);
+            }));
+
+            ON_CALL(db, backend).WillByDefault(ReturnRef(backend));
+        }
+
+        // add real (tiny) images, so analysis has something to work with
+        std::vector<Photo::Id> addPhotos(int count)
+        {
+            std::vector<Photo::DataDelta> photos;
+
+            for (int i = 0; i < count; i++)
+            {
+                const QString path = dir.filePath(QString("photo_%1_%2.png").arg(backend.getPhotosCount({})).arg(i));
+
+                QImage image(16, 16, QImage::Format_RGB32);
+                image.fill(qRgb(i * 10, 100, 200));
+                image.save(path);
+
+                Photo::DataDelta delta;
+                delta.insert<Photo::Field::Path>(path);
+                photos.push_back(delta);
+            }
+
+            backend.addPhotos(photos);
+
+            std::vector<Photo::Id> ids;
+            for (const auto& photo: photos)
+                ids.push_back(photo.getId());
+
+            return ids;
+        }
+
+        bool analyzed(const Photo::Id& id)
+        {
+            const Photo::Data photo = backend.getPhoto(id);
+
+            for (auto flag: { Photo::FlagsE::ExifLoaded, Photo::FlagsE::GeometryLoaded, Photo::FlagsE::Sha256Loaded, Photo::FlagsE::PHashLoaded })
+            {
+                const auto it = photo.flags.find(flag);
+
+                if (it == photo.flags.end() || it->second == 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        int journalEntry(const Photo::Id& id)
+        {
+            return backend.get(id, Database::CommonGeneralFlags::AnalysisAttempts).value_or(0);
+        }
+
+        int state(const Photo::Id& id)
+        {
+            return backend.get(id, Database::CommonGeneralFlags::State).value_or(0);
+        }
+};
+
+
+TEST_F(PhotosAnalyzerTest, allPhotosAreAnalyzed)
+{
+    ASSERT_TRUE(dir.isValid());
+
+    const auto ids = addPhotos(3);
+
+    PhotosAnalyzer analyzer(&coreFactory, db);
+
+    // photos added while analyzer works
+    const auto newIds = addPhotos(2);
+
+    analyzer.stop();
+
+    for (const auto& id: ids)
+    {
+        EXPECT_TRUE(analyzed(id));
+        EXPECT_EQ(journalEntry(id), 0);
+    }
+
+    for (const auto& id: newIds)
+    {
+        EXPECT_TRUE(analyzed(id));
+        EXPECT_EQ(journalEntry(id), 0);
+    }
+}
+
+
+TEST_F(PhotosAnalyzerTest, interruptedAnalysesAreResumed)
+{
+    ASSERT_TRUE(dir.isValid());
+
+    const auto ids = addPhotos(3);
+
+    // analysis of first photo was interrupted once, second one was interrupted many times
+    backend.set(ids[0], Database::CommonGeneralFlags::AnalysisAttempts, 1);
+    backend.set(ids[1], Database::CommonGeneralFlags::AnalysisAttempts, 2);
+
+    PhotosAnalyzer analyzer(&coreFactory, db);
+    analyzer.stop();
+
+    // photos are not given up on
+    for (const auto& id: ids)
+    {
+        EXPECT_TRUE(analyzed(id));
+        EXPECT_EQ(journalEntry(id), 0);
+        EXPECT_EQ(state(id), static_cast<int>(Database::CommonGeneralFlags::StateType::Normal));
+    }
+}
+
+
+TEST_F(PhotosAnalyzerTest, staleJournalEntriesAreClosed)
+{
+    ASSERT_TRUE(dir.isValid());
+
+    const auto ids = addPhotos(1);
+
+    // photo was analyzed but application was killed before journal entry was closed
+    Photo::DataDelta delta(ids[0]);
+    delta.insert<Photo::Field::Flags>({
+        {Photo::FlagsE::ExifLoaded, 1},
+        {Photo::FlagsE::GeometryLoaded, 1},
+        {Photo::FlagsE::Sha256Loaded, 1},
+        {Photo::FlagsE::PHashLoaded, 1},
+    });
+
+    backend.update({delta});
+    backend.set(ids[0], Database::CommonGeneralFlags::AnalysisAttempts, 1);
+
+    PhotosAnalyzer analyzer(&coreFactory, db);
+    analyzer.stop();
+
+    EXPECT_EQ(journalEntry(ids[0]), 0);
+}
@@ -1,12 +1,16 @@
 
+#include <map>
 #include <random>
 
 #include <QDate>
 #include <QTime>
 
+#include <unit_tests_utils/fake_task_executor.hpp>
 #include <unit_tests_utils/mock_backend.hpp>
 #include <unit_tests_utils/mock_exif_reader.hpp>
+#include <unit_tests_utils/mock_exif_reader_factory.hpp>
 #include <unit_tests_utils/mock_photo_operator.hpp>
+#include <unit_tests_utils/mock_series_cache_operator.hpp>
 
 #include "backends/memory_backend/memory_backend.hpp"
 #include "database_tools/json_to_backend.hpp"
@@ -15,6 +19,8 @@
 #include "unit_tests_utils/mock_database.hpp"
 
 
+using testing::ElementsAre;
+using testing::Field;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
@@ -27,6 +33,9 @@ class SeriesDetectorTest: public testing::Test
     public:
         NiceMock<MockDatabase> db;
         NiceMock<MockBackend> backend;
+        NiceMock<ExifReaderFactoryMock> exifFactory;
+        NiceMock<SeriesCacheOperatorMock> seriesCache;
+        FakeTaskExecutor executor;
 
         SeriesDetectorTest()
         {
@@ -34,6 +43,26 @@ class SeriesDetectorTest: public testing::Test
             {
                 task->run(backend);
             }));
+
+            ON_CALL(backend, seriesCacheOperator()).WillByDefault(ReturnRef(seriesCache));
+
+            // photos are mocked one by one
+            ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke([this](const std::vector<Photo::Id>& ids)
+            {
+                std::vector<Photo::Data> photos;
+
+                for (const Photo::Id& id: ids)
+                    photos.push_back(backend.getPhoto(id));
+
+                return photos;
+            }));
+        }
+
+        IExifReaderFactory& factoryFor(IExifReader& exif)
+        {
+            ON_CALL(exifFactory, get()).WillByDefault(ReturnRef(exif));
+
+            return exifFactory;
         }
 };
 
@@ -43,7 +72,7 @@ TEST_F(SeriesDetectorTest, constructor)
     EXPECT_NO_THROW({
         MockExifReader exif;
 
-        SeriesDetector sd(db, exif);
+        SeriesDetector sd(db, factoryFor(exif), executor);
     });
 }
 
@@ -93,7 +122,7 @@ TEST_F(SeriesDetectorTest, animationDetectionScenario1)
         return result;
     }));
 
-    const SeriesDetector sd(db, exif);
+    const SeriesDetector sd(db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 
     ASSERT_EQ(groupCanditates.size(), 2);
@@ -149,7 +178,7 @@ TEST_F(SeriesDetectorTest, animationDetectionScenario2)
         return result;
     }));
 
-    const SeriesDetector sd(db, exif);
+    const SeriesDetector sd(db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 
     ASSERT_EQ(groupCanditates.size(), 2);
@@ -208,7 +237,7 @@ TEST_F(SeriesDetectorTest, animationDetectionScenario3)
 
     ON_CALL(exif, get(_, IExifReader::TagType::Exposure)).WillByDefault(Return(-1.f));
 
-    const SeriesDetector sd(db, exif);
+    const SeriesDetector sd(db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 
     ASSERT_EQ(groupCanditates.size(), 2);
@@ -290,7 +319,7 @@ TEST_F(SeriesDetectorTest, HDRDetectionScenario1)
         return result;
     }));
 
-    const SeriesDetector sd(db, exif);
+    const SeriesDetector sd(db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 
     ASSERT_EQ(groupCanditates.size(), 2);
@@ -301,6 +330,51 @@ TEST_F(SeriesDetectorTest, HDRDetectionScenario1)
 }
 
 
+TEST_F(SeriesDetectorTest, animationIsNotFormedAcrossLongTimeGap)
+{
+    NiceMock<MockExifReader> exif;
+    NiceMock<PhotoOperatorMock> photoOperator;
+
+    ON_CALL(backend, photoOperator()).WillByDefault(ReturnRef(photoOperator));
+
+    // Mock 4 photos with unique sequence numbers.
+    // First two and last two are separated by an hour.
+    std::vector<Photo::Id> all_photos =
+    {
+        Photo::Id(1), Photo::Id(2), Photo::Id(3), Photo::Id(4)
+    };
+
+    ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
+    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    {
+        Photo::Data data;
+        data.id = id;
+        data.path = QString("path: %1.jpeg").arg(id);        // add id to path so exif mock can use it for data mocking
+        data.tags.emplace(TagTypes::Date, QDate::fromString("2000.12.01", "yyyy.MM.dd"));
+        data.tags.emplace(TagTypes::Time, QTime::fromString(QString("1%1.00.%2").arg( (id - 1) / 2 + 2).arg(id), "hh.mm.s"));
+
+        return data;
+    }));
+
+    ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([](const QString& path, IExifReader::TagType) -> std::optional<std::any>
+    {
+        QString id_str = path.split(" ").back();
+        id_str.remove(".jpeg");
+
+        return std::any(id_str.toInt());                  // id:1 -> 1, id:2 -> 2, ...
+    }));
+
+    const SeriesDetector sd(db, factoryFor(exif), executor);
+    const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
+
+    ASSERT_EQ(groupCanditates.size(), 2);
+    EXPECT_EQ(groupCanditates.front().members.size(), 2);
+    EXPECT_EQ(groupCanditates.back().members.size(), 2);
+    EXPECT_EQ(groupCanditates.front().type, Group::Type::Animation);
+    EXPECT_EQ(groupCanditates.back().type, Group::Type::Animation);
+}
+
+
 TEST_F(SeriesDetectorTest, PhotosTakenOneByOne)
 {
     NiceMock<MockExifReader> exif;
@@ -316,7 +390,7 @@ TEST_F(SeriesDetectorTest, PhotosTakenOneByOne)
         task->run(mem_backend);
     }));
 
-    const SeriesDetector sd(mem_db, exif);
+    const SeriesDetector sd(mem_db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 
     ASSERT_EQ(groupCanditates.size(), 2);
@@ -353,6 +427,141 @@ TEST_F(SeriesDetectorTest, Complexity)
         return data;
     }));
 
-    const SeriesDetector sd(db, exif);
+    const SeriesDetector sd(db, factoryFor(exif), executor);
     const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
 }
+
+
+TEST_F(SeriesDetectorTest, storedFeaturesAreUsedInsteadOfExif)
+{
+    NiceMock<MockExifReader> exif;
+    NiceMock<PhotoOperatorMock> photoOperator;
+
+    ON_CALL(backend, photoOperator()).WillByDefault(ReturnRef(photoOperator));
+
+    // 4 photos. First three were analyzed before (animation), fourth one is new
+    const std::vector<Photo::Id> all_photos =
+    {
+        Photo::Id(1), Photo::Id(2), Photo::Id(3), Photo::Id(4)
+    };
+
+    ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
+
+    std::vector<Database::SeriesFeatures> stored;
+    for (int i = 1; i <= 3; i++)
+    {
+        Database::SeriesFeatures features;
+        features.id = Photo::Id(i);
+        features.timestamp = std::chrono::seconds(i);
+        features.sequenceNumber = i;
+        features.image = true;
+
+        stored.push_back(features);
+    }
+
+    ON_CALL(seriesCache, listFeatures()).WillByDefault(Return(stored));
+
+    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    {
+        Photo::Data data;
+        data.id = id;
+        data.path = QString("path: %1.jpeg").arg(id);
+        data.tags.emplace(TagTypes::Date, QDate::fromString("2000.12.01", "yyyy.MM.dd"));
+        data.tags.emplace(TagTypes::Time, QTime::fromString("15.00.00", "hh.mm.ss"));
+
+        return data;
+    }));
+
+    // exif is read for new photo only
+    EXPECT_CALL(exif, get(QString("path: 4.jpeg"), _)).Times(2);
+    EXPECT_CALL(exif, get(QString("path: 1.jpeg"), _)).Times(0);
+    EXPECT_CALL(exif, get(QString("path: 2.jpeg"), _)).Times(0);
+    EXPECT_CALL(exif, get(QString("path: 3.jpeg"), _)).Times(0);
+
+    // and its features are stored
+    EXPECT_CALL(seriesCache, store(ElementsAre(Field(&Database::SeriesFeatures::id, Photo::Id(4))))).WillOnce(Return(true));
+
+    const SeriesDetector sd(db, factoryFor(exif), executor);
+    const std::vector<GroupCandidate> groupCanditates = sd.listCandidates();
+
+    ASSERT_EQ(groupCanditates.size(), 1);
+    ASSERT_EQ(groupCanditates.front().members.size(), 3);
+    EXPECT_EQ(groupCanditates.front().type, Group::Type::Animation);
+    EXPECT_EQ(groupCanditates.front().members[0].path, "path: 1.jpeg");    // details are loaded for members
+}
+
+
+TEST_F(SeriesDetectorTest, onlyWindowsTouchedByNewPhotosAreAnalyzed)
+{
+    NiceMock<MockExifReader> exif;
+    Database::MemoryBackend mem_backend;
+    Database::JsonToBackend jsonReader(mem_backend);
+
+    jsonReader.append(SeriesDB::db);
+
+    NiceMock<MockDatabase> mem_db;
+
+    ON_CALL(mem_db, execute(_)).WillByDefault(Invoke([&mem_backend](const auto& task)
+    {
+        task->run(mem_backend);
+    }));
+
+    auto storedWindows = [&mem_backend]()
+    {
+        std::map<int, std::size_t> windows;             // window id -> number of photos
+
+        for (const auto& window: mem_backend.seriesCacheOperator().listWindows())
+            windows.emplace(window.id, window.photos);
+
+        return windows;
+    };
+
+    const SeriesDetector sd(mem_db, factoryFor(exif), executor);
+    const std::vector<GroupCandidate> firstRun = sd.listCandidates();
+
+    ASSERT_EQ(firstRun.size(), 2);
+
+    // two windows with series were stored: 6 and 5 photos long
+    const auto firstRunWindows = storedWindows();
+    ASSERT_EQ(firstRunWindows.size(), 2);
+
+    const int firstWindow = firstRunWindows.begin()->second == 6? firstRunWindows.begin()->first: firstRunWindows.rbegin()->first;
+    const int secondWindow = firstRunWindows.begin()->second == 5? firstRunWindows.begin()->first: firstRunWindows.rbegin()->first;
+    ASSERT_NE(firstWindow, secondWindow);
+
+    // nothing changed - nothing is analyzed again
+    EXPECT_CALL(exif, get(_, _)).Times(0);
+
+    const std::vector<GroupCandidate> secondRun = sd.listCandidates();
+
+    ASSERT_EQ(secondRun.size(), 2);
+    EXPECT_EQ(secondRun.front().members, firstRun.front().members);
+    EXPECT_EQ(secondRun.back().members, firstRun.back().members);
+    EXPECT_EQ(storedWindows(), firstRunWindows);
+
+    testing::Mock::VerifyAndClearExpectations(&exif);
+
+    // new photo extends second series
+    Tag::TagsList tags;
+    tags.emplace(TagTypes::Date, QDate(2001, 1, 1));
+    tags.emplace(TagTypes::Time, QTime(10, 0, 40));
+
+    Photo::DataDelta newPhoto;
+    newPhoto.insert<Photo::Field::Path>(QString("/some/path13.jpeg"));
+    newPhoto.insert<Photo::Field::Tags>(tags);
+
+    std::vector<Photo::DataDelta> newPhotos = {newPhoto};
+    mem_backend.addPhotos(newPhotos);
+
+    const std::vector<GroupCandidate> thirdRun = sd.listCandidates();
+
+    ASSERT_EQ(thirdRun.size(), 2);
+    EXPECT_EQ(thirdRun.front().members.size(), 6);
+    EXPECT_EQ(thirdRun.back().members.size(), 6);
+
+    // first window was reused, second one was analyzed again
+    const auto thirdRunWindows = storedWindows();
+    ASSERT_EQ(thirdRunWindows.size(), 2);
+    EXPECT_TRUE(thirdRunWindows.contains(firstWindow));
+    EXPECT_FALSE(thirdRunWindows.contains(secondWindow));
+}
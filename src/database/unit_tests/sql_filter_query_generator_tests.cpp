@@ -175,13 +175,13 @@ TEST(SqlFilterQueryGeneratorTest, HandlesSha256Filter)
     Database::SqlFilterQueryGenerator generator;
     Database::FilterPhotosWithSha256 filter;
 
-    filter.sha256 = "1234567890";
+    filter.sha256 = QByteArray::fromHex("1234567890");
 
     const QString query = generator.generate(filter);
 
     EXPECT_EQ("SELECT id FROM photos "
               "JOIN (sha256sums) ON (sha256sums.photo_id = photos.id) "
-              "WHERE sha256sums.sha256 = '1234567890'", query);
+              "WHERE sha256sums.sha256 = X'1234567890'", query);
 }
 
 
@@ -205,7 +205,7 @@ TEST(SqlFilterQueryGeneratorTest, HandlesSimpleMergesWell)
 
     // sha256
     Database::FilterPhotosWithSha256 sha_filter;
-    sha_filter.sha256 = "1234567890";
+    sha_filter.sha256 = QByteArray::fromHex("1234567890");
     filters.push_back(sha_filter);
 
     //tag
@@ -225,7 +225,7 @@ TEST(SqlFilterQueryGeneratorTest, HandlesSimpleMergesWell)
         "WHERE id IN "
         "("
             "SELECT id FROM photos JOIN (sha256sums) ON (sha256sums.photo_id = photos.id) "
-            "WHERE sha256sums.sha256 = '1234567890'"
+            "WHERE sha256sums.sha256 = X'1234567890'"
         ") "
         "AND id IN "
         "("
@@ -51,3 +51,26 @@ TYPED_TEST(GeneralFlagsTest, invalidName)
     EXPECT_FALSE(this->m_backend->get(ids[0], "test2").has_value());
     EXPECT_FALSE(this->m_backend->get(ids[0], "test1").has_value());
 }
+
+
+TYPED_TEST(GeneralFlagsTest, bulkSet)
+{
+    Photo::DataDelta pd1, pd2, pd3;
+    pd1.insert<Photo::Field::Path>("photo1.jpeg");
+    pd2.insert<Photo::Field::Path>("photo2.jpeg");
+    pd3.insert<Photo::Field::Path>("photo3.jpeg");
+
+    std::vector<Photo::DataDelta> photos = { pd1, pd2, pd3 };
+    this->m_backend->addPhotos(photos);
+
+    const Photo::Id id1 = photos[0].getId();
+    const Photo::Id id2 = photos[1].getId();
+    const Photo::Id id3 = photos[2].getId();
+
+    this->m_backend->set(id1, "test1", 5);
+    this->m_backend->set("test1", { {id1, 1}, {id2, 2} });
+
+    EXPECT_EQ(this->m_backend->get(id1, "test1"), 1);       // updated
+    EXPECT_EQ(this->m_backend->get(id2, "test1"), 2);       // introduced
+    EXPECT_FALSE(this->m_backend->get(id3, "test1").has_value());
+}
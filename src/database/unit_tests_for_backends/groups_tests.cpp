@@ -80,3 +80,34 @@ TYPED_TEST(GroupsTest, groupRemoval)
     // expect all photos to be modified
     ASSERT_EQ(modified_photos.size(), 3);
 }
+
+
+TYPED_TEST(GroupsTest, groupInfoInBulkRead)
+{
+    Photo::DataDelta pd1, pd2, pd3;
+    pd1.insert<Photo::Field::Path>("photo1.jpeg");
+    pd2.insert<Photo::Field::Path>("photo2.jpeg");
+    pd3.insert<Photo::Field::Path>("photo3.jpeg");
+
+    std::vector<Photo::DataDelta> photos = { pd1, pd2, pd3 };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const Photo::Id& id1 = photos[0].getId();
+    const Group::Id& gid = this->m_backend->groupOperator().addGroup(id1, Group::Type::Animation);
+
+    pd2.clear();
+    pd2.setId(photos[1].getId());
+    pd2.insert<Photo::Field::GroupInfo>(GroupInfo(gid, GroupInfo::Member));
+
+    this->m_backend->update( {pd2} );
+
+    const auto datas = this->m_backend->getPhotos( {photos[0].getId(), photos[1].getId(), photos[2].getId()} );
+    ASSERT_EQ(datas.size(), 3);
+
+    EXPECT_EQ(datas[0].groupInfo, GroupInfo(gid, GroupInfo::Representative));
+    EXPECT_EQ(datas[1].groupInfo, GroupInfo(gid, GroupInfo::Member));
+    EXPECT_EQ(datas[2].groupInfo, GroupInfo());
+
+    for (const auto& data: datas)
+        EXPECT_EQ(data, this->m_backend->getPhoto(data.id));
+}
@@ -1,4 +1,8 @@
 
+#include "database_tools/json_to_backend.hpp"
+#include "general_flags.hpp"
+#include "unit_tests_utils/sample_db.json.hpp"
+
 #include "common.hpp"
 
 
@@ -75,6 +79,42 @@ TYPED_TEST(PeopleTest, massivePersonIntroduction)
 }
 
 
+TYPED_TEST(PeopleTest, storingFacesOfManyPhotos)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db1);
+
+    const auto ids = this->m_backend->photoOperator().getPhotos({});
+    ASSERT_EQ(ids.size(), 3);
+
+    const QRect face1(10, 20, 30, 40);
+    const QRect face2(100, 20, 30, 40);
+    const Person::Fingerprint fingerprint = {0.5, 0.25, 0.125};
+
+    // two faces on first photo, none on second one. Third photo is not touched
+    this->m_backend->storeFaces({
+        { ids[0], { {face1, fingerprint}, {face2, fingerprint} } },
+        { ids[1], {} },
+    });
+
+    const auto people = this->m_backend->peopleInformationAccessor().listPeople(std::vector<Photo::Id>{ids[0], ids[1], ids[2]});
+    ASSERT_EQ(people.size(), 2);
+
+    std::set<std::pair<int, int>> locations;
+    for (const PersonInfo& person: people)
+    {
+        EXPECT_EQ(person.ph_id, ids[0]);
+        locations.emplace(person.rect.x(), person.rect.y());
+    }
+
+    EXPECT_EQ(locations, (std::set<std::pair<int, int>>{ {10, 20}, {100, 20} }));
+
+    EXPECT_EQ(this->m_backend->get(ids[0], Database::CommonGeneralFlags::FacesRecognized), 1);
+    EXPECT_EQ(this->m_backend->get(ids[1], Database::CommonGeneralFlags::FacesRecognized), 1);
+    EXPECT_FALSE(this->m_backend->get(ids[2], Database::CommonGeneralFlags::FacesRecognized).has_value());
+}
+
+
 /*
 TYPED_TEST(PeopleTest, simpleAssignmentToPhoto)
 {
@@ -0,0 +1,147 @@
+
+#include <QColor>
+
+#include "database_tools/json_to_backend.hpp"
+#include "database_tools/photos_index.hpp"
+#include "general_flags.hpp"
+#include "igroup_operator.hpp"
+#include "iphoto_operator.hpp"
+#include "unit_tests_utils/sample_db2.json.hpp"
+
+#include "common.hpp"
+
+
+using Database::FilterPhotosWithTag;
+
+// Index is compared against SQL backend which is the reference implementation of filters
+struct PhotosIndexTest: DatabaseTest<Database::SQLiteBackend>
+{
+    PhotosIndexTest()
+    {
+        Database::JsonToBackend converter(*m_backend);
+        converter.append(SampleDB::db2);
+
+        m_photos = m_backend->photoOperator().getPhotos({});
+    }
+
+    void setTag(std::size_t photo, TagTypes type, const TagValue& value)
+    {
+        Photo::Data data = m_backend->getPhoto(m_photos[photo]);
+        data.tags[type] = value;
+
+        Photo::DataDelta delta(data.id);
+        delta.insert<Photo::Field::Tags>(data.tags);
+        m_backend->update( {delta} );
+    }
+
+    void expectSameResults(const Database::PhotosIndex& index) const
+    {
+        const Database::Actions::GroupAction sort({
+            Database::Actions::SortByTimestamp(),
+            Database::Actions::SortByID()
+        });
+
+        const std::vector<Database::Filter> filters = {
+            Database::EmptyFilter(),
+            FilterPhotosWithTag(TagTypes::Date, QDate(2001, 1, 2)),
+            FilterPhotosWithTag(TagTypes::Date, QDate(2001, 1, 2), FilterPhotosWithTag::ValueMode::GreaterOrEqual, true),
+            FilterPhotosWithTag(TagTypes::Date, QDate(2001, 1, 3), FilterPhotosWithTag::ValueMode::LessOrEqual, true),
+            FilterPhotosWithTag(TagTypes::Date, QDate(2001, 1, 3), FilterPhotosWithTag::ValueMode::Less),
+            FilterPhotosWithTag(TagTypes::Time, QTime(11, 0), FilterPhotosWithTag::ValueMode::Greater),
+            FilterPhotosWithTag(TagTypes::Rating, 3, FilterPhotosWithTag::ValueMode::GreaterOrEqual),
+            FilterPhotosWithTag(TagTypes::Rating, 4, FilterPhotosWithTag::ValueMode::LessOrEqual),
+            FilterPhotosWithTag(TagTypes::Rating),
+            FilterPhotosWithTag(TagTypes::Category, QColor(Qt::red)),
+            Database::FilterPhotosWithFlags({ {Photo::FlagsE::StagingArea, 1} }),
+            Database::FilterPhotosWithGeneralFlag(Database::CommonGeneralFlags::State, 0),
+            Database::FilterPhotosWithRole(Database::FilterPhotosWithRole::Role::Regular),
+            Database::FilterPhotosWithRole(Database::FilterPhotosWithRole::Role::GroupRepresentative),
+            Database::FilterNotMatchingFilter(Database::FilterPhotosWithRole(Database::FilterPhotosWithRole::Role::GroupMember)),
+            Database::GroupFilter({
+                FilterPhotosWithTag(TagTypes::Date, QDate(2001, 1, 2), FilterPhotosWithTag::ValueMode::GreaterOrEqual, true),
+                Database::FilterPhotosWithGeneralFlag(Database::CommonGeneralFlags::State, 0),
+                Database::FilterNotMatchingFilter(Database::FilterPhotosWithRole(Database::FilterPhotosWithRole::Role::GroupMember))
+            })
+        };
+
+        for (const auto& filter: filters)
+        {
+            const auto indexed = index.onPhotos(filter, sort);
+
+            ASSERT_TRUE(indexed.has_value());
+            EXPECT_EQ(*indexed, m_backend->photoOperator().onPhotos(filter, sort));
+        }
+    }
+
+    std::vector<Photo::Id> m_photos;
+};
+
+
+TEST_F(PhotosIndexTest, notReadyBeforeBuild)
+{
+    const Database::PhotosIndex index;
+
+    EXPECT_FALSE(index.isReady());
+    EXPECT_FALSE(index.onPhotos(Database::EmptyFilter(), Database::Actions::SortByID()).has_value());
+}
+
+
+TEST_F(PhotosIndexTest, unsupportedFiltersAreRejected)
+{
+    Database::PhotosIndex index;
+    index.set(*m_backend);
+
+    ASSERT_TRUE(index.isReady());
+
+    const SearchExpressionEvaluator::Expression expression = SearchExpressionEvaluator(",").evaluate("Event1");
+
+    EXPECT_FALSE(index.onPhotos(Database::FilterPhotosMatchingExpression(expression), Database::Actions::SortByID()).has_value());
+    EXPECT_FALSE(index.onPhotos(Database::FilterPhotosWithTag(TagTypes::Event, QString("Event1")), Database::Actions::SortByID()).has_value());
+    EXPECT_FALSE(index.onPhotos(Database::EmptyFilter(), Database::Actions::SortByTag(TagTypes::Event)).has_value());
+}
+
+
+TEST_F(PhotosIndexTest, resultsMatchBackend)
+{
+    setTag(0, TagTypes::Rating, 3);
+    setTag(1, TagTypes::Rating, 5);
+    setTag(2, TagTypes::Category, QColor(Qt::red));
+    setTag(3, TagTypes::Category, QColor(Qt::blue));
+    m_backend->set(m_photos[4], Database::CommonGeneralFlags::State, 1);
+
+    Database::PhotosIndex index;
+    index.set(*m_backend);
+
+    expectSameResults(index);
+}
+
+
+TEST_F(PhotosIndexTest, indexFollowsChanges)
+{
+    Database::PhotosIndex index;
+    index.set(*m_backend);
+
+    // evaluate filters before modifications so cached results need to be updated
+    expectSameResults(index);
+
+    // modifications
+    setTag(0, TagTypes::Rating, 4);
+    setTag(5, TagTypes::Date, QDate(2001, 1, 5));
+    setTag(6, TagTypes::Category, QColor(Qt::red));
+    m_backend->set(m_photos[7], Database::CommonGeneralFlags::State, 1);
+
+    // groups
+    const Group::Id group = m_backend->groupOperator().addGroup(m_photos[8], Group::Type::Generic);
+    Photo::DataDelta member(m_photos[9]);
+    member.insert<Photo::Field::GroupInfo>(GroupInfo(group, GroupInfo::Member));
+    m_backend->update( {member} );
+
+    // removal
+    m_backend->photoOperator().removePhoto(m_photos[10]);
+
+    // new photos
+    Database::JsonToBackend converter(*m_backend);
+    converter.append(SampleDB::db2);
+
+    expectSameResults(index);
+}
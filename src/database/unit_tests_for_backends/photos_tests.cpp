@@ -49,6 +49,11 @@ namespace
                     if (delta.has(Photo::Field::GroupInfo) && delta.get<Photo::Field::GroupInfo>() != data.groupInfo)
                         return false;
                     break;
+
+                case Photo::Field::PHash:
+                    if (delta.has(Photo::Field::PHash) && delta.get<Photo::Field::PHash>() != data.phash)
+                        return false;
+                    break;
             }
         }
 
@@ -82,6 +87,85 @@ TYPED_TEST(PhotosTest, insertion)
 }
 
 
+TYPED_TEST(PhotosTest, counting)
+{
+    EXPECT_EQ(this->m_backend->getPhotosCount({}), 0);
+
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db1);
+
+    EXPECT_EQ(this->m_backend->getPhotosCount({}), 3);
+}
+
+
+TYPED_TEST(PhotosTest, countingWithFilter)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db1);
+
+    const Database::FilterPhotosWithTag withTime(TagTypes::Time, QTime(10, 0));
+    const Database::FilterPhotosWithPath withPath("/some/path3.jpeg");
+
+    EXPECT_EQ(this->m_backend->getPhotosCount(withTime), 2);
+    EXPECT_EQ(this->m_backend->getPhotosCount(withPath), 1);
+    EXPECT_EQ(this->m_backend->getPhotosCount(Database::FilterNotMatchingFilter(withTime)), 1);
+    EXPECT_EQ(this->m_backend->getPhotosCount(Database::GroupFilter({withTime, withPath})), 0);
+}
+
+
+TYPED_TEST(PhotosTest, fetchingWithFilter)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db1);
+
+    using ValueMode = Database::FilterPhotosWithTag::ValueMode;
+    const Database::FilterPhotosWithTag withTime(TagTypes::Time, QTime(10, 0));
+    const Database::FilterPhotosWithTag withPlace(TagTypes::Place);
+    const Database::FilterPhotosWithTag placeOrEmpty(TagTypes::Place, QString("Internet"), ValueMode::Equal, true);
+    const Database::FilterPhotosWithTag placeBeforeOrEmpty(TagTypes::Place, QString("Internet"), ValueMode::Less, true);
+
+    EXPECT_EQ(this->m_backend->photoOperator().getPhotos(withTime).size(), 2);
+    EXPECT_EQ(this->m_backend->photoOperator().getPhotos(withPlace).size(), 2);
+    EXPECT_EQ(this->m_backend->photoOperator().getPhotos(placeOrEmpty).size(), 2);      // missing place is compared as '' which is not 'Internet'
+    EXPECT_EQ(this->m_backend->photoOperator().getPhotos(placeBeforeOrEmpty).size(), 1);
+    EXPECT_EQ(this->m_backend->listTagValues(TagTypes::Event, withTime).size(), 1);
+}
+
+
+TYPED_TEST(PhotosTest, findingDuplicates)
+{
+    std::vector<Photo::DataDelta> photos;
+
+    for (const QByteArray& sha256: { "aaa", "bbb", "aaa", "ccc", "bbb", "aaa" })
+    {
+        Photo::DataDelta delta;
+        delta.insert<Photo::Field::Path>(QString("/some/path%1.jpeg").arg(photos.size()));
+        delta.insert<Photo::Field::Checksum>(sha256);
+
+        photos.push_back(delta);
+    }
+
+    this->m_backend->addPhotos(photos);
+
+    const auto duplicates = this->m_backend->photoOperator().findDuplicates(Database::EmptyFilter());
+
+    EXPECT_THAT(duplicates, testing::UnorderedElementsAre(
+        testing::ElementsAre(photos[0].getId(), photos[2].getId(), photos[5].getId()),
+        testing::ElementsAre(photos[1].getId(), photos[4].getId())
+    ));
+
+    // only photos matching filter are considered
+    Database::FilterPhotosWithId withId;
+    withId.filter = photos[1].getId();
+
+    const auto filtered = this->m_backend->photoOperator().findDuplicates(Database::FilterNotMatchingFilter(withId));
+
+    EXPECT_THAT(filtered, testing::ElementsAre(
+        testing::ElementsAre(photos[0].getId(), photos[2].getId(), photos[5].getId())
+    ));
+}
+
+
 TYPED_TEST(PhotosTest, retrievingAllDataInDelta)
 {
     std::vector<Photo::Id> reported_ids;
@@ -106,6 +190,28 @@ TYPED_TEST(PhotosTest, retrievingAllDataInDelta)
     }
 }
 
+TYPED_TEST(PhotosTest, retrievingManyPhotosAtOnce)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(RichDB::db1);
+
+    auto ids = this->m_backend->photoOperator().getPhotos(Database::EmptyFilter());
+    ASSERT_EQ(ids.size(), 3);
+
+    std::reverse(ids.begin(), ids.end());
+
+    // nonexistent photos are skipped
+    auto ids_with_missing = ids;
+    ids_with_missing.insert(ids_with_missing.begin() + 1, Photo::Id(1000000));
+
+    const auto photos = this->m_backend->getPhotos(ids_with_missing);
+    ASSERT_EQ(photos.size(), 3);
+
+    for (std::size_t i = 0; i < ids.size(); i++)
+        EXPECT_EQ(photos[i], this->m_backend->getPhoto(ids[i]));
+}
+
+
 TYPED_TEST(PhotosTest, retrievingPartialDataInDelta)
 {
     std::vector<Photo::Id> reported_ids;
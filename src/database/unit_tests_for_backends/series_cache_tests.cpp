@@ -0,0 +1,182 @@
+#include <core/tag.hpp>
+#include <database/iseries_cache_operator.hpp>
+
+#include "common.hpp"
+
+using testing::IsEmpty;
+using testing::UnorderedElementsAre;
+
+
+template<typename T>
+struct SeriesCacheTest: DatabaseTest<T>
+{
+    std::vector<Photo::Id> addPhotos(int count)
+    {
+        std::vector<Photo::DataDelta> photos;
+
+        for (int i = 0; i < count; i++)
+        {
+            Photo::DataDelta pd;
+            pd.insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+            photos.push_back(pd);
+        }
+
+        this->m_backend->addPhotos(photos);
+
+        std::vector<Photo::Id> ids;
+        for (const auto& photo: photos)
+            ids.push_back(photo.getId());
+
+        return ids;
+    }
+
+    static Database::SeriesFeatures features(const Photo::Id& id, int seconds, std::optional<int> sequence, std::optional<int> exposure)
+    {
+        Database::SeriesFeatures f;
+        f.id = id;
+        f.timestamp = std::chrono::seconds(seconds);
+        f.sequenceNumber = sequence;
+        f.exposure = exposure;
+        f.image = true;
+
+        return f;
+    }
+};
+
+TYPED_TEST_SUITE(SeriesCacheTest, BackendTypes);
+
+
+TYPED_TEST(SeriesCacheTest, emptyCache)
+{
+    this->addPhotos(2);
+
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), IsEmpty());
+}
+
+
+TYPED_TEST(SeriesCacheTest, storeAndList)
+{
+    const auto ids = this->addPhotos(2);
+
+    const auto f1 = this->features(ids[0], 100, 1, -100);
+    const auto f2 = this->features(ids[1], 200, std::nullopt, std::nullopt);
+
+    EXPECT_TRUE(this->m_backend->seriesCacheOperator().store({f1, f2}));
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), UnorderedElementsAre(f1, f2));
+}
+
+
+TYPED_TEST(SeriesCacheTest, featuresAreReplaced)
+{
+    const auto ids = this->addPhotos(1);
+
+    const auto f1 = this->features(ids[0], 100, 1, 0);
+    const auto f2 = this->features(ids[0], 150, 2, 50);
+
+    this->m_backend->seriesCacheOperator().store({f1});
+    this->m_backend->seriesCacheOperator().store({f2});
+
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), UnorderedElementsAre(f2));
+}
+
+
+TYPED_TEST(SeriesCacheTest, timestampModificationDropsFeatures)
+{
+    const auto ids = this->addPhotos(2);
+
+    const auto f1 = this->features(ids[0], 100, 1, 0);
+    const auto f2 = this->features(ids[1], 200, 2, 0);
+
+    this->m_backend->seriesCacheOperator().store({f1, f2});
+
+    Tag::TagsList tags;
+    tags[TagTypes::Date] = TagValue(QDate(2022, 5, 1));
+
+    Photo::DataDelta delta(ids[0]);
+    delta.insert<Photo::Field::Tags>(tags);
+    this->m_backend->update( {delta} );
+
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), UnorderedElementsAre(f2));
+}
+
+
+TYPED_TEST(SeriesCacheTest, otherTagsModificationKeepsFeatures)
+{
+    const auto ids = this->addPhotos(2);
+
+    const auto f1 = this->features(ids[0], 100, 1, 0);
+    const auto f2 = this->features(ids[1], 200, 2, 0);
+
+    this->m_backend->seriesCacheOperator().store({f1, f2});
+
+    Tag::TagsList tags;
+    tags[TagTypes::Event] = TagValue(QString("Party"));
+
+    Photo::DataDelta delta(ids[0]);
+    delta.insert<Photo::Field::Tags>(tags);
+    this->m_backend->update( {delta} );
+
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), UnorderedElementsAre(f1, f2));
+}
+
+
+TYPED_TEST(SeriesCacheTest, droppingFeatures)
+{
+    const auto ids = this->addPhotos(3);
+
+    const auto f1 = this->features(ids[0], 100, 1, 0);
+    const auto f2 = this->features(ids[1], 200, 2, 0);
+    const auto f3 = this->features(ids[2], 300, 3, 0);
+
+    this->m_backend->seriesCacheOperator().store({f1, f2, f3});
+
+    EXPECT_TRUE(this->m_backend->seriesCacheOperator().dropFeatures({ids[0], ids[2]}));
+    EXPECT_THAT(this->m_backend->seriesCacheOperator().listFeatures(), UnorderedElementsAre(f2));
+}
+
+
+TYPED_TEST(SeriesCacheTest, storeAndReplaceWindows)
+{
+    const auto ids = this->addPhotos(5);
+
+    Database::SeriesWindow w1;
+    w1.first = std::chrono::seconds(100);
+    w1.last = std::chrono::seconds(110);
+    w1.maxGap = std::chrono::seconds(10);
+    w1.photos = 4;
+    w1.candidates.push_back({Group::Type::HDR, {ids[0], ids[1]}});
+    w1.candidates.push_back({Group::Type::Generic, {ids[2], ids[3]}});
+
+    Database::SeriesWindow w2;
+    w2.first = std::chrono::seconds(500);
+    w2.last = std::chrono::seconds(505);
+    w2.maxGap = std::chrono::seconds(10);
+    w2.photos = 2;
+
+    EXPECT_TRUE(this->m_backend->seriesCacheOperator().replaceWindows({}, {w1, w2}));
+
+    auto windows = this->m_backend->seriesCacheOperator().listWindows();
+    ASSERT_EQ(windows.size(), 2);
+
+    // ids are assigned by backend
+    const int w2Id = windows[0].photos == 2? windows[0].id: windows[1].id;
+    for (auto& window: windows)
+        window.id = 0;
+
+    EXPECT_THAT(windows, UnorderedElementsAre(w1, w2));
+
+    Database::SeriesWindow w3;
+    w3.first = std::chrono::seconds(500);
+    w3.last = std::chrono::seconds(520);
+    w3.maxGap = std::chrono::seconds(10);
+    w3.photos = 3;
+    w3.candidates.push_back({Group::Type::Animation, {ids[4], ids[1]}});
+
+    EXPECT_TRUE(this->m_backend->seriesCacheOperator().replaceWindows({w2Id}, {w3}));
+
+    windows = this->m_backend->seriesCacheOperator().listWindows();
+    for (auto& window: windows)
+        window.id = 0;
+
+    EXPECT_THAT(windows, UnorderedElementsAre(w1, w3));
+}
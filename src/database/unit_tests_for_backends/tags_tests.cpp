@@ -7,6 +7,8 @@
 #include "common.hpp"
 
 using testing::Contains;
+using testing::Pair;
+using testing::UnorderedElementsAre;
 
 
 template<typename T>
@@ -34,3 +36,103 @@ TYPED_TEST(TagsTest, listTagValues)
     EXPECT_THAT(all_dates, Contains(TagValue(QDate::fromString("2001.01.06", Qt::ISODate))));
     EXPECT_THAT(all_dates, Contains(TagValue(QDate::fromString("2001.01.07", Qt::ISODate))));
 }
+
+
+TYPED_TEST(TagsTest, countTagValues)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db2);
+
+    const auto all_dates = this->m_backend->countTagValues(TagTypes::Date);
+
+    ASSERT_EQ(all_dates.size(), 7);
+
+    for (const auto& [date, count]: all_dates)
+        EXPECT_EQ(count, 3);
+}
+
+
+TYPED_TEST(TagsTest, countTagValuesFollowsTagsModifications)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db2);
+
+    const auto photos = this->m_backend->photoOperator().getPhotos({});
+    ASSERT_FALSE(photos.empty());
+
+    Photo::Data data = this->m_backend->getPhoto(photos.front());
+    const TagValue old_date = data.tags[TagTypes::Date];
+    const TagValue new_date(QDate(2010, 5, 5));
+
+    data.tags[TagTypes::Date] = new_date;
+    data.tags[TagTypes::Rating] = TagValue(5);
+
+    Photo::DataDelta delta(data.id);
+    delta.insert<Photo::Field::Tags>(data.tags);
+    this->m_backend->update( {delta} );
+
+    const auto all_dates = this->m_backend->countTagValues(TagTypes::Date);
+
+    ASSERT_EQ(all_dates.size(), 8);
+    EXPECT_THAT(all_dates, Contains(Pair(old_date, 2)));
+    EXPECT_THAT(all_dates, Contains(Pair(new_date, 1)));
+    EXPECT_THAT(this->m_backend->countTagValues(TagTypes::Rating), UnorderedElementsAre(Pair(TagValue(5), 1)));
+
+    // unfiltered list of values comes from the same source
+    EXPECT_EQ(this->m_backend->listTagValues(TagTypes::Date, {}).size(), 8);
+
+    // remove rating so its value is not used anymore
+    data.tags.erase(TagTypes::Rating);
+
+    delta.insert<Photo::Field::Tags>(data.tags);
+    this->m_backend->update( {delta} );
+
+    EXPECT_TRUE(this->m_backend->countTagValues(TagTypes::Rating).empty());
+}
+
+
+TYPED_TEST(TagsTest, dateHistogram)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db2);
+
+    const auto days = this->m_backend->getDateHistogram({}, Database::DateHistogram::Granularity::Day);
+
+    ASSERT_EQ(days.photos.size(), 7);
+    EXPECT_EQ(days.total(), 21);
+
+    for (const auto& [date, count]: days.photos)
+        EXPECT_EQ(count, 3);
+
+    const auto months = this->m_backend->getDateHistogram({}, Database::DateHistogram::Granularity::Month);
+
+    EXPECT_EQ(months.photos.size(), 1);
+    EXPECT_EQ(months.total(), 21);
+
+    // filtered histogram is calculated with grouped query
+    const auto filtered = this->m_backend->getDateHistogram(Database::FilterPhotosWithTag(TagTypes::Date), Database::DateHistogram::Granularity::Day);
+
+    EXPECT_EQ(filtered.photos, days.photos);
+}
+
+
+TYPED_TEST(TagsTest, filteredDateHistogram)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db2);
+
+    const Database::FilterPhotosWithTag withTime(TagTypes::Time, QTime(10, 0));
+    const auto days = this->m_backend->getDateHistogram(withTime, Database::DateHistogram::Granularity::Day);
+
+    ASSERT_EQ(days.photos.size(), 7);
+    EXPECT_EQ(days.total(), 7);
+
+    for (const auto& [date, count]: days.photos)
+        EXPECT_EQ(count, 1);
+
+    const Database::FilterPhotosWithTag beforeDate(TagTypes::Date, QDate(2001, 1, 3), Database::FilterPhotosWithTag::ValueMode::Less);
+    const auto earlyDays = this->m_backend->getDateHistogram(beforeDate, Database::DateHistogram::Granularity::Day);
+
+    ASSERT_EQ(earlyDays.photos.size(), 2);
+    EXPECT_EQ(earlyDays.total(), 6);
+}
@@ -50,6 +50,13 @@ namespace dlib_api
     }
 
 
+    cnn_face_detection_model_v1::cnn_face_detection_model_v1(const cnn_face_detection_model_v1& other)
+        : m_data(std::make_unique<data>(*other.m_data))
+    {
+
+    }
+
+
     cnn_face_detection_model_v1::~cnn_face_detection_model_v1()
     {
 
@@ -19,6 +19,7 @@
 #ifndef CNN_FACE_DETECTION_MODEL_V1_HPP
 #define CNN_FACE_DETECTION_MODEL_V1_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <dlib/image_processing/full_object_detection.h>
@@ -37,6 +38,7 @@ namespace dlib_api
     public:
 
         explicit cnn_face_detection_model_v1(const std::string& model_filename);
+        cnn_face_detection_model_v1(const cnn_face_detection_model_v1 &);
         ~cnn_face_detection_model_v1();
 
         std::vector<dlib::mmod_rect> detect (
@@ -3,14 +3,13 @@
 #include <dlib/dnn.h>
 #include <QRgb>
 
+#include <cmath>
+
 #include <core/ilogger.hpp>
-#include <core/lazy_ptr.hpp>
-#include <system/filesystem.hpp>
 
-#include "cnn_face_detector.hpp"
-#include "face_recognition.hpp"
 #include "dlib_face_recognition_api.hpp"
 #include "helpers.hpp"
+#include "models_registry.hpp"
 
 
 #ifdef DLIB_USE_CUDA
@@ -24,11 +23,6 @@ namespace dlib_api
 {
     namespace
     {
-        constexpr char predictor_5_point_model[] = "shape_predictor_5_face_landmarks.dat";
-        constexpr char predictor_68_point_model[] = "shape_predictor_68_face_landmarks.dat";
-        constexpr char human_face_model[] = "mmod_human_face_detector.dat";
-        constexpr char face_recognition_model[] = "dlib_face_recognition_resnet_model_v1.dat";
-
         int dlib_cuda_devices()
         {
             int devices = 0;
@@ -51,7 +45,8 @@ namespace dlib_api
         bool has_hardware_accelearion()
         {
             // if cuda was disabled during dlib build then get_num_devices() will return 1 which is not what we want
-            const bool has = (CUDA_AVAILABLE ? dlib_cuda_devices() : 0) > 0;
+            // devices do not come and go, so ask dlib once
+            static const bool has = (CUDA_AVAILABLE ? dlib_cuda_devices() : 0) > 0;
 
             return has;
         }
@@ -65,43 +60,6 @@ namespace dlib_api
                     .arg(rect.height());
         }
 
-        // helpers
-
-        QString models_path()
-        {
-            const QString path = FileSystem().getDataPath() + "/face_recognition_models";
-
-            return path;
-        }
-
-        template<typename T>
-        T deserialize_from_file(const QString& file_name)
-        {
-            T object;
-            dlib::deserialize(file_name.toStdString()) >> object;
-
-            return object;
-        }
-
-        template<const char* name>
-        QString modelPath()
-        {
-            const QString full_path = models_path() + "/" + name;
-
-            return full_path;
-        }
-
-        template<typename T, const char* model>
-        struct ObjectDeserializer
-        {
-            T operator()() const
-            {
-                const QString model_path = modelPath<model>();
-
-                return deserialize_from_file<T>(model_path);
-            }
-        };
-
         QRect dlib_rect_to_qrect(const dlib::rectangle& rect)
         {
             const QRect qrect(rect.left(), rect.top(),
@@ -110,6 +68,14 @@ namespace dlib_api
             return qrect;
         }
 
+        QRect scale_rect(const QRect& rect, double scale)
+        {
+            return QRect(static_cast<int>(std::lround(rect.left() * scale)),
+                         static_cast<int>(std::lround(rect.top() * scale)),
+                         static_cast<int>(std::lround(rect.width() * scale)),
+                         static_cast<int>(std::lround(rect.height() * scale)));
+        }
+
         template<typename DlibRect>
         QVector<QRect> dlib_rects_to_qrects(const std::vector<DlibRect>& dlib_rects)
         {
@@ -122,26 +88,16 @@ namespace dlib_api
 
             return qrects;
         }
-
-        cnn_face_detection_model_v1* construct_cnn_face_detector()
-        {
-            const auto cnn_face_detection_model = modelPath<human_face_model>();
-            return new cnn_face_detection_model_v1(cnn_face_detection_model.toStdString());
-        }
     }
 
 
     struct FaceLocator::Data
     {
-        lazy_ptr<cnn_face_detection_model_v1, decltype(&construct_cnn_face_detector)> cnn_face_detector;
-        lazy_ptr<dlib::frontal_face_detector, decltype(&dlib::get_frontal_face_detector)> hog_face_detector;
         std::unique_ptr<ILogger> logger;
         const bool cuda_available;
 
         explicit Data(ILogger* l, bool ca)
-            : cnn_face_detector(&construct_cnn_face_detector)
-            , hog_face_detector(&dlib::get_frontal_face_detector)
-            , logger(l->subLogger("FaceLocator"))
+            : logger(l->subLogger("FaceLocator"))
             , cuda_available(ca)
         {
 
@@ -224,9 +180,72 @@ namespace dlib_api
     }
 
 
+    QVector<QRect> FaceLocator::face_locations_cascade(const QImage& qimage, const CascadeOptions& options)
+    {
+        return face_locations_cascade(qimage, detection_image(qimage, options), options);
+    }
+
+
+    QVector<QRect> FaceLocator::face_locations_cascade(const QImage& qimage, const QImage& scaled, const CascadeOptions& options)
+    {
+        if (scaled.isNull())
+            return face_locations(qimage, 0);
+
+        const double scale = static_cast<double>(scaled.width()) / qimage.width();
+
+        m_data->logger->debug(QString("Looking for face candidates in image of size %1x%2 scaled down to %3x%4")
+            .arg(qimage.width())
+            .arg(qimage.height())
+            .arg(scaled.width())
+            .arg(scaled.height()));
+
+        std::optional<QVector<QRect>> candidates;
+
+        if (m_data->cuda_available)
+            candidates = _face_locations_cnn(scaled, options.number_of_times_to_upsample);
+
+        if (candidates.has_value() == false)
+            candidates = _face_locations_hog(scaled, options.number_of_times_to_upsample);
+
+        QVector<QRect> faces;
+
+        for(const QRect& candidate: candidates.value_or(QVector<QRect>()))
+        {
+            const QRect face = scale_rect(candidate, 1.0 / scale);
+            const std::optional<QRect> refined = _refine_face_location(qimage, face, options.max_refined_face_size);
+
+            if (refined.has_value())
+                m_data->logger->debug(QString("Refined face candidate %1 to %2")
+                    .arg(rectToString(face))
+                    .arg(rectToString(*refined)));
+
+            // when cnn cannot confirm candidate, keep it (as face_locations() does) so recall is not lost
+            faces.push_back(refined.value_or(face));
+        }
+
+        m_data->logger->debug(QString("Found %1 face(s)").arg(faces.size()));
+
+        return faces;
+    }
+
+
+    QImage FaceLocator::detection_image(const QImage& qimage, const CascadeOptions& options)
+    {
+        const double pixels = static_cast<double>(qimage.width()) * qimage.height();
+        const double detection_pixels = options.detection_megapixels * 1e6;
+
+        if (detection_pixels <= 0.0 || pixels <= detection_pixels)
+            return QImage();
+
+        const double scale = std::sqrt(detection_pixels / pixels);
+
+        return qimage.scaled(qimage.size() * scale, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+
     QVector<QRect> FaceLocator::face_locations_cnn(const QImage& qimage, int number_of_times_to_upsample)
     {
-        const auto dlib_results = m_data->cnn_face_detector->detect(qimage, number_of_times_to_upsample);
+        const auto dlib_results = ModelsRegistry::instance().cnnFaceDetector().detect(qimage, number_of_times_to_upsample);
         const auto faces = dlib_rects_to_qrects(dlib_results);
 
         return faces;
@@ -235,9 +254,10 @@ namespace dlib_api
 
     QVector<QRect> FaceLocator::face_locations_hog(const QImage& qimage, int number_of_times_to_upsample)
     {
-        dlib::matrix<dlib::rgb_pixel> image = qimage_to_dlib_matrix(qimage);
+        const qimage_view image(qimage);
 
-        const auto dlib_results = (*m_data->hog_face_detector)(image, number_of_times_to_upsample);
+        dlib::frontal_face_detector& hog_face_detector = ModelsRegistry::instance().hogFaceDetector();
+        const auto dlib_results = hog_face_detector(image, number_of_times_to_upsample);
         const QVector<QRect> faces = dlib_rects_to_qrects(dlib_results);
 
         return faces;
@@ -308,6 +328,30 @@ namespace dlib_api
     }
 
 
+    std::optional<QRect> FaceLocator::_refine_face_location(const QImage& image, const QRect& face, int max_face_size)
+    {
+        // cnn does not get more accurate for faces much bigger than its detection window, only slower
+        const int face_size = std::max(face.width(), face.height());
+        const double scale = face_size > max_face_size? static_cast<double>(max_face_size) / face_size: 1.0;
+
+        // region needs to be bigger than margins used by _face_locations_cnn()
+        const QRect region = face.adjusted(-face.width() / 2, -face.height() / 2, face.width() / 2, face.height() / 2);
+        const QImage regionImage = scale < 1.0?
+            image.copy(region).scaled(region.size() * scale, Qt::IgnoreAspectRatio, Qt::SmoothTransformation):
+            image.copy(region);
+
+        const QRect faceInRegion = scale_rect(face.translated(-region.topLeft()), scale);
+        const auto faces = _face_locations_cnn(regionImage, faceInRegion);
+
+        std::optional<QRect> refined;
+
+        if (faces.has_value() && faces->size() == 1)
+            refined = scale_rect(faces->front(), 1.0 / scale).translated(region.topLeft());
+
+        return refined;
+    }
+
+
     std::optional<QVector<QRect>> FaceLocator::_face_locations_hog(const QImage& qimage, int number_of_times_to_upsample)
     {
         return face_locations_hog(qimage, number_of_times_to_upsample);
@@ -317,16 +361,10 @@ namespace dlib_api
     struct FaceEncoder::Data
     {
         Data(ILogger* log)
-            : face_encoder( modelPath<face_recognition_model>().toStdString() )
-            , logger(log)
+            : logger(log)
         {
         }
 
-        face_recognition_model_v1 face_encoder;
-
-        lazy_ptr<dlib::shape_predictor, ObjectDeserializer<dlib::shape_predictor, predictor_5_point_model>> predictor_5_point;
-        lazy_ptr<dlib::shape_predictor, ObjectDeserializer<dlib::shape_predictor, predictor_68_point_model>> predictor_68_point;
-
         ILogger* logger;
     };
 
@@ -354,24 +392,57 @@ namespace dlib_api
                 .arg(size.height())
         );
 
-        const dlib::rectangle face_location(0, 0, size.width() - 1 , size.height() -1);
+        const std::vector<FaceEncodings> encodings = encode(std::vector<QImage>{qimage}, num_jitters, model);
+
+        return encodings.empty()? FaceEncodings(): encodings.front();
+    }
+
+
+    std::vector<FaceEncodings> FaceEncoder::face_encodings(const std::vector<QImage>& faces, int num_jitters, EncodingsModel model)
+    {
+        m_data->logger->debug(QString("Calculating encodings for %1 face(s)").arg(faces.size()));
+
+        return encode(faces, num_jitters, model);
+    }
+
+
+    std::vector<FaceEncodings> FaceEncoder::encode(const std::vector<QImage>& faces, int num_jitters, EncodingsModel model)
+    {
+        std::vector<FaceEncodings> result(faces.size());
+
+        if (faces.empty())
+            return result;
+
+        ModelsRegistry& models = ModelsRegistry::instance();
         const dlib::shape_predictor& pose_predictor = model == Large?
-                                                      *m_data->predictor_68_point :
-                                                      *m_data->predictor_5_point;
+                                                      models.predictor68Point() :
+                                                      models.predictor5Point();
 
-        const auto image = qimage_to_dlib_matrix(qimage);
-        const auto object_detection = pose_predictor(image, face_location);
+        // each face image contains exactly one face
+        std::vector<std::vector<dlib::full_object_detection>> object_detections;
+        object_detections.reserve(faces.size());
 
-        std::vector<double> result;
+        for(const QImage& face: faces)
+        {
+            const dlib::rectangle face_location(0, 0, face.width() - 1 , face.height() -1);
+            const qimage_view image(face);
+
+            object_detections.push_back( {pose_predictor(image, face_location)} );
+        }
 
         try
         {
-            const auto encodings = m_data->face_encoder.compute_face_descriptor(qimage, object_detection, num_jitters);
-            result = std::vector<double>(encodings.begin(), encodings.end());
+            // all faces go through network at once
+            const auto encodings = models.faceEncoder().batch_compute_face_descriptors(faces, object_detections, num_jitters);
+
+            for(std::size_t i = 0; i < faces.size(); i++)
+                result[i] = std::vector<double>(encodings[i].front().begin(), encodings[i].front().end());
         }
         catch(const dlib::cuda_error& err)
         {
-            std::cerr << err.what() << std::endl;
+            // do not return empty encodings as if they were valid ones
+            m_data->logger->error(QString("Could not calculate face encodings: %1").arg(err.what()));
+            result.clear();
         }
 
         return result;
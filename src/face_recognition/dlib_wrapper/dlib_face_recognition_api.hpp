@@ -26,7 +26,14 @@ namespace dlib_api
 
     typedef std::vector<double> FaceEncodings;
 
-    // FaceLocator may be a very heavy object. Delete it as soon as it is not needed.
+    struct CascadeOptions
+    {
+        double detection_megapixels = 1.5;          // size of scaled down image used for finding face candidates
+        int number_of_times_to_upsample = 1;        // upsampling of scaled down image (helps finding small faces)
+        int max_refined_face_size = 300;            // faces bigger than that are scaled down before refinement
+    };
+
+    // FaceLocator is a lightweight object. Models it uses are loaded once and shared (see ModelsRegistry).
     // based on:
     // https://github.com/ageitgey/face_recognition/blob/5fe85a1a8cbd1b994b505464b555d12cd25eee5f/face_recognition/api.py#L108
     class DLIB_WRAPPER_EXPORT FaceLocator
@@ -39,6 +46,19 @@ namespace dlib_api
             // both cnn and hog will be used to get optimal results
             QVector<QRect> face_locations(const QImage &, int number_of_times_to_upsample = 1);
 
+            // Multi-scale face locator.
+            // Face candidates are looked for on scaled down image (with cnn or hog, depending on hardware),
+            // then each of them is refined with cnn on full resolution image.
+            // Images smaller than CascadeOptions::detection_megapixels are processed with face_locations().
+            QVector<QRect> face_locations_cascade(const QImage &, const CascadeOptions& = CascadeOptions());
+
+            // As above, but with scaled down image already prepared with detection_image().
+            QVector<QRect> face_locations_cascade(const QImage &, const QImage& detection_image, const CascadeOptions& = CascadeOptions());
+
+            // Scaled down image used by face_locations_cascade() for finding face candidates.
+            // Null image is returned when image is small enough to be processed as it is.
+            static QImage detection_image(const QImage &, const CascadeOptions& = CascadeOptions());
+
             QVector<QRect> face_locations_cnn(const QImage &, int number_of_times_to_upsample = 1);   // may throw an exception
             QVector<QRect> face_locations_hog(const QImage &, int);
 
@@ -49,6 +69,7 @@ namespace dlib_api
             std::optional<QVector<QRect>> _face_locations_cnn(const QImage &, int);
             std::optional<QVector<QRect>> _face_locations_cnn(const QImage &, const QRect &);
             std::optional<QVector<QRect>> _face_locations_hog(const QImage &, int);
+            std::optional<QRect> _refine_face_location(const QImage &, const QRect &, int);
     };
 
     class DLIB_WRAPPER_EXPORT FaceEncoder
@@ -58,11 +79,19 @@ namespace dlib_api
             ~FaceEncoder();
 
             // https://github.com/ageitgey/face_recognition/blob/5fe85a1a8cbd1b994b505464b555d12cd25eee5f/face_recognition/api.py#L203
+            // Returns empty encodings on failure.
             std::vector<double> face_encodings(const QImage& face, int num_jitters = 1, EncodingsModel = Large);
 
+            // Calculate encodings for many faces (possibly from different photos) in one network pass.
+            // Each image is expected to contain one face, as for single face version.
+            // Returns empty vector on failure.
+            std::vector<FaceEncodings> face_encodings(const std::vector<QImage>& faces, int num_jitters = 1, EncodingsModel = Large);
+
         private:
             struct Data;
             std::unique_ptr<Data> m_data;
+
+            std::vector<FaceEncodings> encode(const std::vector<QImage> &, int, EncodingsModel);
     };
 
     // https://github.com/ageitgey/face_recognition/blob/5fe85a1a8cbd1b994b505464b555d12cd25eee5f/face_recognition/api.py#L217
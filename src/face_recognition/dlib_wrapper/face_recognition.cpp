@@ -70,6 +70,13 @@ namespace dlib_api
     }
 
 
+    face_recognition_model_v1::face_recognition_model_v1(const face_recognition_model_v1& other)
+        : m_data(std::make_unique<data>(*other.m_data))
+    {
+
+    }
+
+
     face_recognition_model_v1::~face_recognition_model_v1()
     {
 
@@ -19,6 +19,7 @@
 #ifndef FACE_RECOGNITION_MODEL_V1_HPP
 #define FACE_RECOGNITION_MODEL_V1_HPP
 
+#include <memory>
 #include <string>
 #include <dlib/image_processing/full_object_detection.h>
 #include <dlib/matrix.h>
@@ -38,6 +39,7 @@ namespace dlib_api
     public:
 
         explicit face_recognition_model_v1(const std::string& model_filename);
+        face_recognition_model_v1(const face_recognition_model_v1 &);
         ~face_recognition_model_v1();
 
         dlib::matrix<double,0,1> compute_face_descriptor (
@@ -1,24 +1,26 @@
 
 #include "helpers.hpp"
 
-#include <QImage>
-#include <QRect>
-#include <QRgb>
+#include <cstring>
+
+
+static_assert(sizeof(dlib::rgb_pixel) == 3, "dlib::rgb_pixel is expected to have QImage::Format_RGB888 layout");
 
 
 dlib::matrix<dlib::rgb_pixel> qimage_to_dlib_matrix(const QImage& qimage)
 {
-    dlib::matrix<dlib::rgb_pixel> matrix;
+    // RGB888 has the same layout as dlib::rgb_pixel so whole scanlines can be copied.
+    // Conversion from other formats is done by Qt with vectorized converters.
+    const QImage rgb = qimage.convertToFormat(QImage::Format_RGB888);
+    const int width = rgb.width();
+    const int height = rgb.height();
 
-    const QRect size = qimage.rect();
-    matrix.set_size(size.height(), size.width());
+    dlib::matrix<dlib::rgb_pixel> matrix;
+    matrix.set_size(height, width);
 
-    for(int r = 0; r < size.height(); r++)
-        for(int c = 0; c < size.width(); c++)
-        {
-            const QRgb rgb = qimage.pixel(c, r);
-            matrix(r, c) = dlib::rgb_pixel(qRed(rgb), qGreen(rgb), qBlue(rgb));
-        }
+    if (width > 0)
+        for(int r = 0; r < height; r++)
+            std::memcpy(&matrix(r, 0), rgb.constScanLine(r), static_cast<std::size_t>(width) * sizeof(dlib::rgb_pixel));
 
     return matrix;
 }
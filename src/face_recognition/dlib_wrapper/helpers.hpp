@@ -2,11 +2,72 @@
 #ifndef HELPERS_HPP_INCLUDED
 #define HELPERS_HPP_INCLUDED
 
+#include <QImage>
+#include <dlib/image_processing/generic_image.h>
 #include <dlib/matrix.h>
+#include <dlib/pixel.h>
 
-class QImage;
 
 dlib::matrix<dlib::rgb_pixel> qimage_to_dlib_matrix(const QImage& qimage);
 
 
+/**
+ * \brief Read only view of QImage for dlib's algorithms working on generic images.
+ *
+ * Image is converted to RGB888 (which is a no-op for images already in this format)
+ * which has the same memory layout as dlib::rgb_pixel, so dlib reads scanlines directly.
+ */
+class qimage_view
+{
+    public:
+        explicit qimage_view(const QImage& image)
+            : m_image(image.convertToFormat(QImage::Format_RGB888))
+        {
+
+        }
+
+        const QImage& image() const
+        {
+            return m_image;
+        }
+
+    private:
+        QImage m_image;
+};
+
+
+namespace dlib
+{
+    template<>
+    struct image_traits<qimage_view>
+    {
+        typedef rgb_pixel pixel_type;
+    };
+}
+
+
+inline long num_rows(const qimage_view& view)
+{
+    return view.image().height();
+}
+
+
+inline long num_columns(const qimage_view& view)
+{
+    return view.image().width();
+}
+
+
+inline long width_step(const qimage_view& view)
+{
+    return view.image().bytesPerLine();
+}
+
+
+inline const void* image_data(const qimage_view& view)
+{
+    return view.image().constBits();
+}
+
+
 #endif // HELPERS_HPP_INCLUDED
@@ -0,0 +1,117 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "models_registry.hpp"
+
+#include <chrono>
+
+#include <dlib/dnn.h>
+#include <QString>
+
+#include <system/filesystem.hpp>
+
+
+namespace dlib_api
+{
+    namespace
+    {
+        constexpr char predictor_5_point_model[] = "shape_predictor_5_face_landmarks.dat";
+        constexpr char predictor_68_point_model[] = "shape_predictor_68_face_landmarks.dat";
+        constexpr char human_face_model[] = "mmod_human_face_detector.dat";
+        constexpr char face_recognition_model[] = "dlib_face_recognition_resnet_model_v1.dat";
+
+        // copies of models released by finished threads kept for reuse
+        constexpr std::size_t MaxIdleCopies = 2;
+        constexpr auto MaxCopyIdleTime = std::chrono::minutes(1);
+
+        std::string modelPath(const char* name)
+        {
+            const QString path = FileSystem().getDataPath() + "/face_recognition_models/" + name;
+
+            return path.toStdString();
+        }
+
+        template<typename T>
+        std::unique_ptr<T> deserialize_from_file(const char* name)
+        {
+            auto object = std::make_unique<T>();
+            dlib::deserialize(modelPath(name)) >> *object;
+
+            return object;
+        }
+    }
+
+
+    template<typename T>
+    ModelsRegistry::ThreadBoundModel<T>::ThreadBoundModel(std::function<std::unique_ptr<T>()> loader)
+        : m_model(loader)
+        , m_copies(ObjectsPool<T>::create([this]{ return std::make_unique<T>(m_model.get()); }, MaxIdleCopies, MaxCopyIdleTime))
+    {
+
+    }
+
+
+    ModelsRegistry::ModelsRegistry()
+        : m_cnnFaceDetector([]{ return std::make_unique<cnn_face_detection_model_v1>(modelPath(human_face_model)); })
+        , m_hogFaceDetector([]{ return std::make_unique<dlib::frontal_face_detector>(dlib::get_frontal_face_detector()); })
+        , m_faceEncoder([]{ return std::make_unique<face_recognition_model_v1>(modelPath(face_recognition_model)); })
+        , m_predictor5Point([]{ return deserialize_from_file<dlib::shape_predictor>(predictor_5_point_model); })
+        , m_predictor68Point([]{ return deserialize_from_file<dlib::shape_predictor>(predictor_68_point_model); })
+    {
+
+    }
+
+
+    ModelsRegistry& ModelsRegistry::instance()
+    {
+        static ModelsRegistry registry;
+
+        return registry;
+    }
+
+
+    cnn_face_detection_model_v1& ModelsRegistry::cnnFaceDetector()
+    {
+        return m_cnnFaceDetector.get();
+    }
+
+
+    dlib::frontal_face_detector& ModelsRegistry::hogFaceDetector()
+    {
+        return m_hogFaceDetector.get();
+    }
+
+
+    face_recognition_model_v1& ModelsRegistry::faceEncoder()
+    {
+        return m_faceEncoder.get();
+    }
+
+
+    const dlib::shape_predictor& ModelsRegistry::predictor5Point()
+    {
+        return m_predictor5Point.get();
+    }
+
+
+    const dlib::shape_predictor& ModelsRegistry::predictor68Point()
+    {
+        return m_predictor68Point.get();
+    }
+}
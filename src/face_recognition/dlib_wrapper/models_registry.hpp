@@ -0,0 +1,114 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MODELS_REGISTRY_HPP_INCLUDED
+#define MODELS_REGISTRY_HPP_INCLUDED
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <dlib/image_processing/frontal_face_detector.h>
+#include <dlib/image_processing/shape_predictor.h>
+
+#include <core/objects_pool.hpp>
+
+#include "cnn_face_detector.hpp"
+#include "face_recognition.hpp"
+
+
+namespace dlib_api
+{
+    /**
+     * \brief Process wide storage of dlib models
+     *
+     * Each model is deserialized from disk once, on first use.
+     * Shape predictors are not modified by prediction, so one instance is shared by all threads.
+     * Detectors and neural networks keep intermediate results of computations inside,
+     * so each thread works on its own copy made from loaded model (which is much cheaper than deserialization).
+     */
+    class ModelsRegistry
+    {
+        public:
+            static ModelsRegistry& instance();
+
+            ModelsRegistry(const ModelsRegistry &) = delete;
+            ModelsRegistry& operator=(const ModelsRegistry &) = delete;
+
+            cnn_face_detection_model_v1& cnnFaceDetector();
+            dlib::frontal_face_detector& hogFaceDetector();
+            face_recognition_model_v1& faceEncoder();
+
+            const dlib::shape_predictor& predictor5Point();
+            const dlib::shape_predictor& predictor68Point();
+
+        private:
+            template<typename T>
+            class SharedModel
+            {
+                public:
+                    explicit SharedModel(std::function<std::unique_ptr<T>()> loader)
+                        : m_loader(loader)
+                    {
+
+                    }
+
+                    const T& get()
+                    {
+                        std::call_once(m_loaded, [this]
+                        {
+                            m_model = m_loader();
+                        });
+
+                        return *m_model;
+                    }
+
+                private:
+                    std::once_flag m_loaded;
+                    std::unique_ptr<T> m_model;
+                    std::function<std::unique_ptr<T>()> m_loader;
+            };
+
+            template<typename T>
+            class ThreadBoundModel
+            {
+                public:
+                    explicit ThreadBoundModel(std::function<std::unique_ptr<T>()> loader);
+
+                    T& get()
+                    {
+                        return m_copies->threadBound();
+                    }
+
+                private:
+                    SharedModel<T> m_model;
+                    std::shared_ptr<ObjectsPool<T>> m_copies;
+            };
+
+            ThreadBoundModel<cnn_face_detection_model_v1> m_cnnFaceDetector;
+            ThreadBoundModel<dlib::frontal_face_detector> m_hogFaceDetector;
+            ThreadBoundModel<face_recognition_model_v1> m_faceEncoder;
+            SharedModel<dlib::shape_predictor> m_predictor5Point;
+            SharedModel<dlib::shape_predictor> m_predictor68Point;
+
+            ModelsRegistry();
+    };
+}
+
+#endif
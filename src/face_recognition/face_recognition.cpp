@@ -18,8 +18,11 @@
 
 #include "face_recognition.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <QByteArray>
@@ -31,12 +34,16 @@
 #include <QString>
 #include <QSaveFile>
 #include <QTemporaryFile>
+#include <QVariant>
 
+#include <core/constants.hpp>
+#include <core/iconfiguration.hpp>
 #include <core/icore_factory_accessor.hpp>
 #include <core/iexif_reader.hpp>
 #include <core/ilogger_factory.hpp>
 #include <core/ilogger.hpp>
 #include <core/image_tools.hpp>
+#include <core/itask_executor.hpp>
 #include <core/task_executor_utils.hpp>
 #include <database/filter.hpp>
 #include <database/ibackend.hpp>
@@ -52,7 +59,72 @@ using namespace std::placeholders;
 
 namespace
 {
-    std::mutex g_dlibMutex;   // global mutex for dlib usage.
+    // Limits number of photos searched for faces at the same time.
+    // Each search uses its own (thread bound) detectors so they do not need to be serialized,
+    // but each one needs a lot of memory and all of them compete for the same cores.
+    class DetectionsBudget
+    {
+        public:
+            void acquire(int limit)
+            {
+                std::unique_lock lock(m_mutex);
+
+                m_released.wait(lock, [this, limit]
+                {
+                    return m_running < limit;
+                });
+
+                m_running++;
+            }
+
+            void release()
+            {
+                {
+                    std::lock_guard lock(m_mutex);
+                    m_running--;
+                }
+
+                // waiters may use different limits, wake all of them
+                m_released.notify_all();
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_released;
+            int m_running = 0;
+    };
+
+    DetectionsBudget g_detectionsBudget;
+
+    struct BudgetGuard
+    {
+        explicit BudgetGuard(int limit)
+        {
+            g_detectionsBudget.acquire(limit);
+        }
+
+        ~BudgetGuard()
+        {
+            g_detectionsBudget.release();
+        }
+
+        BudgetGuard(const BudgetGuard &) = delete;
+        BudgetGuard& operator=(const BudgetGuard &) = delete;
+    };
+
+    int maxDetectionTasks(ICoreFactoryAccessor& coreAccessor)
+    {
+        const int configured = coreAccessor.getConfiguration().getEntry(FaceRecognitionConfigKeys::maxDetectionTasks).toInt();
+
+        return configured > 0? configured: std::max(coreAccessor.getTaskExecutor().heavyWorkers(), 1);
+    }
+
+    double detectionMegapixels(ICoreFactoryAccessor& coreAccessor)
+    {
+        const QVariant configured = coreAccessor.getConfiguration().getEntry(FaceRecognitionConfigKeys::detectionMegapixels);
+
+        return configured.isValid()? configured.toDouble(): dlib_api::CascadeOptions().detection_megapixels;
+    }
 
     int chooseClosestMatching(const std::vector<double>& distances)
     {
@@ -66,16 +138,18 @@ namespace
 struct FaceRecognition::Data
 {
     explicit Data(ICoreFactoryAccessor* coreAccessor)
-        : m_tmpDir(System::createTmpDir("FaceRecognition", System::Confidential))
-        , m_logger(coreAccessor->getLoggerFactory().get("FaceRecognition"))
+        : m_logger(coreAccessor->getLoggerFactory().get("FaceRecognition"))
         , m_exif(coreAccessor->getExifReaderFactory().get())
+        , m_maxDetections(maxDetectionTasks(*coreAccessor))
+        , m_detectionMegapixels(detectionMegapixels(*coreAccessor))
     {
 
     }
 
-    std::shared_ptr<ITmpDir> m_tmpDir;
     std::unique_ptr<ILogger> m_logger;
     IExifReader& m_exif;
+    const int m_maxDetections;
+    const double m_detectionMegapixels;
 };
 
 
@@ -113,7 +187,7 @@ QVector<QRect> FaceRecognition::fetchFaces(const QString& path) const
     QElapsedTimer timer;
     timer.start();
 
-    const auto faces = fetchFaces(orientedPhoto, 1);
+    const auto faces = fetchFaces(orientedPhoto);
     const auto elapsed = timer.elapsed();
 
     m_data->m_logger->info(QString("Found %1 faces in time: %2ms")
@@ -125,40 +199,51 @@ QVector<QRect> FaceRecognition::fetchFaces(const QString& path) const
 }
 
 
+QVector<QRect> FaceRecognition::fetchFaces(const OrientedImage& orientedPhoto) const
+{
+    dlib_api::CascadeOptions options;
+    options.detection_megapixels = m_data->m_detectionMegapixels;
+
+    const QImage photo = orientedPhoto.get();
+    const QImage detectionImage = dlib_api::FaceLocator::detection_image(photo, options);
+
+    BudgetGuard budget(m_data->m_maxDetections);
+
+    return dlib_api::FaceLocator(m_data->m_logger.get()).face_locations_cascade(photo, detectionImage, options);
+}
+
+
 Person::Fingerprint FaceRecognition::getFingerprint(const OrientedImage& image, const QRect& face_rect)
 {
     const QImage face = face_rect.isEmpty()? image.get(): image.get().copy(face_rect);
 
-    dlib_api::FaceEncoder faceEndoder(m_data->m_logger.get());
-    const dlib_api::FaceEncodings face_encodings = faceEndoder.face_encodings(face);
+    dlib_api::FaceEncoder faceEncoder(m_data->m_logger.get());
+    const dlib_api::FaceEncodings face_encodings = faceEncoder.face_encodings(face);
 
     return face_encodings;
 }
 
 
-int FaceRecognition::recognize(const Person::Fingerprint& unknown, const std::vector<Person::Fingerprint>& known)
+std::vector<Person::Fingerprint> FaceRecognition::getFingerprints(const OrientedImage& image, const QVector<QRect>& faces)
 {
-    const std::vector<double> distance = dlib_api::face_distance(known, unknown);
-    const auto closestMatching = chooseClosestMatching(distance);
+    const QImage photo = image.get();
 
-    return closestMatching;
-}
+    std::vector<QImage> faceImages;
+    faceImages.reserve(faces.size());
 
+    for(const QRect& face: faces)
+        faceImages.push_back(photo.copy(face));
 
-QVector<QRect> FaceRecognition::fetchFaces(const OrientedImage& orientedPhoto, double scale) const
-{
-    std::lock_guard lock(g_dlibMutex);
-    QVector<QRect> result;
+    dlib_api::FaceEncoder faceEncoder(m_data->m_logger.get());
 
-    const QSize scaledSize = orientedPhoto.get().size() * scale;
-    const QImage photo = orientedPhoto.get().scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    return faceEncoder.face_encodings(faceImages);
+}
 
-    result = dlib_api::FaceLocator(m_data->m_logger.get()).face_locations(photo, 0);
 
-    std::transform(result.begin(), result.end(), result.begin(), [scale](const QRect& face){
-        return QRect(face.topLeft().x() / scale, face.topLeft().y() / scale,
-                     face.width() / scale, face.height() / scale);
-    });
+int FaceRecognition::recognize(const Person::Fingerprint& unknown, const std::vector<Person::Fingerprint>& known)
+{
+    const std::vector<double> distance = dlib_api::face_distance(known, unknown);
+    const auto closestMatching = chooseClosestMatching(distance);
 
-    return result;
+    return closestMatching;
 }
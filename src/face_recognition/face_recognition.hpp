@@ -56,15 +56,22 @@ class FACE_RECOGNITION_EXPORT FaceRecognition final
         // Locate faces on given photo.
         QVector<QRect> fetchFaces(const QString &) const;
 
+        // Locate faces on given photo.
+        // Big photos are searched in two steps: candidates are found on scaled down copy and refined on original.
+        QVector<QRect> fetchFaces(const OrientedImage &) const;
+
+        // Returns empty fingerprint on failure.
         Person::Fingerprint getFingerprint(const OrientedImage& image, const QRect& face = QRect());
 
+        // Calculate fingerprints of all given faces of photo at once.
+        // Returns empty vector on failure.
+        std::vector<Person::Fingerprint> getFingerprints(const OrientedImage& image, const QVector<QRect>& faces);
+
         int recognize(const Person::Fingerprint& unknown, const std::vector<Person::Fingerprint>& known);
 
     private:
         struct Data;
         std::unique_ptr<Data> m_data;
-
-        QVector<QRect> fetchFaces(const OrientedImage &, double scale) const;
 };
 
 #endif // FACERECOGNITION_HPP
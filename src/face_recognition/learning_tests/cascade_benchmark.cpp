@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <gtest/gtest.h>
+#include <QDirIterator>
+#include <QImage>
+#include <QPainter>
+
+#include <unit_tests_utils/empty_logger.hpp>
+#include "face_recognition/dlib_wrapper/dlib_face_recognition_api.hpp"
+#include "utils.hpp"
+
+
+namespace
+{
+    // lfw photos are small (250x250) with one face each.
+    // Put many of them on one canvas and scale it up to get something similar to a group photo from a modern camera.
+    constexpr int MosaicColumns = 4;
+    constexpr int MosaicRows = 3;
+    constexpr int MosaicUpsize = 16;            // area factor: 1000x750 -> 4000x3000 (12Mpx)
+    constexpr std::size_t Mosaics = 5;
+
+    std::vector<QImage> buildMosaics()
+    {
+        QDirIterator it(utils::photoSetPath(), {"*.jpg"}, QDir::Files, QDirIterator::Subdirectories);
+
+        std::vector<QImage> mosaics;
+
+        while (mosaics.size() < Mosaics && it.hasNext())
+        {
+            QImage mosaic(250 * MosaicColumns, 250 * MosaicRows, QImage::Format_RGB32);
+            mosaic.fill(Qt::black);
+
+            QPainter painter(&mosaic);
+
+            for (int i = 0; i < MosaicColumns * MosaicRows && it.hasNext(); i++)
+            {
+                const QImage photo(it.next());
+                painter.drawImage((i % MosaicColumns) * 250, (i / MosaicColumns) * 250, photo);
+            }
+
+            painter.end();
+            mosaics.push_back(utils::upsize(mosaic, MosaicUpsize));
+        }
+
+        return mosaics;
+    }
+
+    bool matches(const QRect& lhs, const QRect& rhs)
+    {
+        const QRect common = lhs.intersected(rhs);
+        const double commonArea = common.width() * common.height();
+        const double unitedArea = lhs.width() * lhs.height() + rhs.width() * rhs.height() - commonArea;
+
+        return commonArea / unitedArea > 0.5;
+    }
+
+    template<typename Locator>
+    std::pair<std::vector<QVector<QRect>>, std::chrono::milliseconds> locate(const std::vector<QImage>& images, Locator locator)
+    {
+        std::vector<QVector<QRect>> faces;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for(const QImage& image: images)
+            faces.push_back(locator(image));
+
+        const auto end = std::chrono::steady_clock::now();
+
+        return {faces, std::chrono::duration_cast<std::chrono::milliseconds>(end - start)};
+    }
+}
+
+
+TEST(FaceLocationCascadeBenchmark, timeAndRecall)
+{
+    const std::vector<QImage> mosaics = buildMosaics();
+    ASSERT_FALSE(mosaics.empty());
+
+    EmptyLogger logger;
+    dlib_api::FaceLocator faceLocator(&logger);
+
+    const auto [referenceFaces, referenceTime] = locate(mosaics, [&faceLocator](const QImage& image)
+    {
+        return faceLocator.face_locations(image, 0);
+    });
+
+    const auto [cascadeFaces, cascadeTime] = locate(mosaics, [&faceLocator](const QImage& image)
+    {
+        return faceLocator.face_locations_cascade(image);
+    });
+
+    // recall of cascade, with full resolution detection as a reference
+    std::size_t reference = 0;
+    std::size_t found = 0;
+
+    for (std::size_t i = 0; i < mosaics.size(); i++)
+        for (const QRect& face: referenceFaces[i])
+        {
+            reference++;
+
+            const auto& candidates = cascadeFaces[i];
+            if (std::any_of(candidates.cbegin(), candidates.cend(), [&face](const QRect& candidate){ return matches(face, candidate); }))
+                found++;
+        }
+
+    const double recall = reference > 0? static_cast<double>(found) / reference: 1.0;
+
+    std::cout << "Full resolution detection: " << referenceTime.count() << "ms, " << reference << " faces\n";
+    std::cout << "Cascade detection: " << cascadeTime.count() << "ms, recall: " << recall << "\n";
+
+    EXPECT_GE(recall, 0.95);
+}
@@ -0,0 +1,174 @@
+#include <core/ilogger_factory.hpp>
+#include <core/itask_executor.hpp>
+#include <core/task_executor_utils.hpp>
+#include <database/ibackend.hpp>
+#include <database/iphoto_operator.hpp>
+#include <database/database_tools/duplicates_detector.hpp>
+#include <QElapsedTimer>
+#include <QPromise>
+
+#include "duplicates_model.hpp"
+
+
+using namespace std::placeholders;
+
+
+DuplicatesModel::DuplicatesModel(Project& project, ICoreFactoryAccessor& core)
+    : m_logger(core.getLoggerFactory().get("DuplicatesModel"))
+    , m_project(project)
+    , m_core(core)
+    , m_initialized(false)
+    , m_loaded(false)
+{
+
+}
+
+
+DuplicatesModel::~DuplicatesModel()
+{
+    m_candidatesFuture.cancel();
+    m_candidatesFuture.waitForFinished();
+}
+
+
+bool DuplicatesModel::isLoaded() const
+{
+    return m_loaded;
+}
+
+
+void DuplicatesModel::removeDuplicatesBut(const QSet<int>& excludedRows)
+{
+    std::vector<Photo::Id> toRemove;
+    std::vector<DuplicatesCandidate> left;
+
+    for(int i = 0; i < m_candidates.size(); i++)
+    {
+        const auto& candidate = m_candidates[i];
+
+        if (excludedRows.contains(i))
+            left.push_back(candidate);
+        else
+            // first member is the best copy - keep it
+            for (auto it = std::next(candidate.members.begin()); it != candidate.members.end(); ++it)
+                toRemove.push_back(it->id);
+    }
+
+    m_project.getDatabase().exec([toRemove](Database::IBackend& backend)
+    {
+        for (const Photo::Id& id: toRemove)
+            backend.photoOperator().removePhoto(id);
+    });
+
+    beginResetModel();
+    m_candidates.clear();
+    endResetModel();
+
+    updateModel(left);
+}
+
+
+QVariant DuplicatesModel::data(const QModelIndex& index, int role) const
+{
+    if (index.isValid() && index.column() == 0 && index.row() < m_candidates.size())
+    {
+        const auto& candidate = m_candidates[index.row()];
+
+        if (role == PhotoDataRole)
+            return QVariant::fromValue(candidate.members.front());
+        else if (role == DetailsRole)
+            return QVariant::fromValue(candidate);
+        else if (role == GroupTypeRole)
+        {
+            QString type;
+            switch (candidate.type)
+            {
+                case DuplicatesCandidate::Type::Exact:   type = tr("Identical files");  break;
+                case DuplicatesCandidate::Type::Similar: type = tr("Similar photos");   break;
+            }
+
+            return type;
+        }
+        else if (role == MembersRole)
+            return QVariant::fromValue(candidate.members);
+    }
+
+    return {};
+}
+
+
+int DuplicatesModel::rowCount(const QModelIndex& parent) const
+{
+    return m_candidates.size();
+}
+
+
+bool DuplicatesModel::canFetchMore(const QModelIndex& parent) const
+{
+    return parent.isValid() == false && m_initialized == false;
+}
+
+
+void DuplicatesModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() == false)
+    {
+        m_initialized = true;
+
+        fetchDuplicates();
+    }
+}
+
+
+QHash<int, QByteArray> DuplicatesModel::roleNames() const
+{
+    auto roles = QAbstractListModel::roleNames();
+
+    roles.insert(
+    {
+        { DetailsRole,   "details" },
+        { PhotoDataRole, "photoData" },
+        { GroupTypeRole, "groupType" },
+        { MembersRole,   "members" }
+    });
+
+    return roles;
+}
+
+
+void DuplicatesModel::fetchDuplicates()
+{
+    auto& executor = m_core.getTaskExecutor();
+
+    m_candidatesFuture = runOn<std::vector<DuplicatesCandidate>>
+    (
+        executor,
+        [this](QPromise<std::vector<DuplicatesCandidate>>& promise)
+        {
+            QElapsedTimer timer;
+
+            DuplicatesDetector detector(m_project.getDatabase(), &promise);
+
+            timer.start();
+            promise.addResult(detector.listCandidates());
+            m_logger->debug(QString("Duplicates analysis took %1s").arg(timer.elapsed()/1000.0));
+        },
+        "DuplicatesDetector"
+    );
+
+    m_candidatesFuture.then(std::bind(&DuplicatesModel::updateModel, this, _1));
+}
+
+
+void DuplicatesModel::updateModel(const std::vector<DuplicatesCandidate>& canditates)
+{
+    if (canditates.empty() == false)
+    {
+        beginInsertRows({}, 0, canditates.size() - 1);
+        m_candidates = canditates;
+        endInsertRows();
+    }
+
+    m_loaded = true;
+    emit loadedChanged(m_loaded);
+}
@@ -0,0 +1,57 @@
+#ifndef DUPLICATESMODEL_HPP
+#define DUPLICATESMODEL_HPP
+
+#include <QAbstractItemModel>
+#include <QFuture>
+
+#include <core/icore_factory_accessor.hpp>
+#include <database/idatabase.hpp>
+#include <database/database_tools/duplicates_candidate.hpp>
+#include <project_utils/project.hpp>
+
+
+class DuplicatesModel: public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(bool loaded READ isLoaded NOTIFY loadedChanged)
+
+public:
+    enum Roles
+    {
+        DetailsRole = Qt::UserRole + 1,
+        PhotoDataRole,
+        GroupTypeRole,
+        MembersRole,
+    };
+
+    DuplicatesModel(Project &, ICoreFactoryAccessor &);
+    ~DuplicatesModel();
+
+    bool isLoaded() const;
+
+    // remove all but first member of each candidate from collection (files stay untouched)
+    Q_INVOKABLE void removeDuplicatesBut(const QSet<int> &);
+
+    QVariant data(const QModelIndex& index, int role) const override;
+    int rowCount(const QModelIndex& parent) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void loadedChanged(bool) const;
+
+private:
+    std::unique_ptr<ILogger> m_logger;
+    std::vector<DuplicatesCandidate> m_candidates;
+    Project& m_project;
+    ICoreFactoryAccessor& m_core;
+    QFuture<std::vector<DuplicatesCandidate>> m_candidatesFuture;
+    bool m_initialized;
+    bool m_loaded;
+
+    void fetchDuplicates();
+    void updateModel(const std::vector<DuplicatesCandidate> &);
+};
+
+#endif
@@ -17,16 +17,33 @@
 
 #include "flat_model.hpp"
 
-#include <tuple>
+#include <algorithm>
+#include <cstdlib>
 
 #include <core/function_wrappers.hpp>
 #include <database/ibackend.hpp>
 #include <database/idatabase.hpp>
 #include <database/iphoto_operator.hpp>
+#include <database/database_tools/photos_index.hpp>
 
 
 namespace
 {
+    // photos data is fetched in pages of PageSize rows
+    constexpr int PageSize = 64;
+
+    // number of pages fetched ahead of recently accessed one (in scroll direction)
+    constexpr int PrefetchPages = 2;
+
+    // pages which are further than this from recently accessed row are not worth fetching anymore
+    constexpr int MaxFetchDistance = PageSize * (PrefetchPages + 4);
+
+    // maximal number of cached photos before the ones far from recently accessed row are dropped
+    constexpr std::size_t MaxCachedPhotos = PageSize * 32;
+
+    // maximal number of separate insertions and removals model is updated with instead of being reset
+    constexpr std::size_t MaxIncrementalChanges = 1000;
+
     template<std::forward_iterator T>
     T findLastConsecutive(T first, T last)
     {
@@ -56,6 +73,47 @@ namespace
             first = lit;
         }
     }
+
+    // indices of values forming longest strictly increasing subsequence (O(n log n))
+    std::vector<std::size_t> longestIncreasingSubsequence(const std::vector<std::size_t>& values)
+    {
+        std::vector<std::size_t> tails;                          // tails[l] - index of the smallest last value of subsequence of length l + 1
+        std::vector<std::size_t> previous(values.size());       // index of preceding value in subsequence
+
+        for(std::size_t i = 0; i < values.size(); i++)
+        {
+            auto it = std::lower_bound(tails.begin(), tails.end(), values[i], [&values](std::size_t idx, std::size_t value)
+            {
+                return values[idx] < value;
+            });
+
+            previous[i] = it == tails.begin()? values.size(): *std::prev(it);
+
+            if (it == tails.end())
+                tails.push_back(i);
+            else
+                *it = i;
+        }
+
+        std::vector<std::size_t> result(tails.size());
+
+        for(std::size_t i = tails.size(), idx = tails.empty()? 0: tails.back(); i > 0; i--, idx = previous[idx])
+            result[i - 1] = idx;
+
+        return result;
+    }
+
+    // number of continuous blocks of false values
+    std::size_t countRuns(const std::vector<char>& kept)
+    {
+        std::size_t runs = 0;
+
+        for(std::size_t i = 0; i < kept.size(); i++)
+            if (kept[i] == false && (i == 0 || kept[i - 1]))
+                runs++;
+
+        return runs;
+    }
 }
 
 
@@ -64,7 +122,10 @@ using namespace std::placeholders;
 
 FlatModel::FlatModel(QObject* p)
     : APhotoInfoModel(p)
+    , m_recentRow(0)
+    , m_recentPage(0)
     , m_db(nullptr)
+    , m_photosIndex()
 {
 }
 
@@ -103,6 +164,12 @@ void FlatModel::setDatabase(Database::IDatabase* db)
 }
 
 
+void FlatModel::setPhotosIndex(std::weak_ptr<const Database::PhotosIndex> index)
+{
+    m_photosIndex = std::move(index);
+}
+
+
 void FlatModel::setFilter(const Database::Filter& filters)
 {
     {
@@ -202,14 +269,14 @@ void FlatModel::reloadPhotos()
     resetModel();
 
     if (m_db != nullptr)
-        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1));
+        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1, m_photosIndex));
 }
 
 
 void FlatModel::updatePhotos()
 {
     if (m_db != nullptr)
-        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1));
+        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1, m_photosIndex));
 }
 
 
@@ -247,6 +314,8 @@ void FlatModel::removePhotos(const std::vector<Photo::Id>& idsToBeRemoved)
         erasePhotos(m_photos.begin() + range.first,
                     m_photos.begin() + range.second + 1);
     }
+
+    updateIdToRow();
 }
 
 
@@ -281,29 +350,79 @@ const Database::Filter& FlatModel::filters() const
 
 const Photo::Data& FlatModel::photoData(const Photo::Id& id) const
 {
-    assert(m_idToRow.find(id) != m_idToRow.end());
+    const auto row_it = m_idToRow.find(id);
 
-    auto it = m_properties.find(id);
+    // photo is not part of model (anymore). Do not schedule any fetch for it
+    if (row_it == m_idToRow.end())
+    {
+        static const Photo::Data placeholder;
+        return placeholder;
+    }
+
+    const int row = row_it->second;
+    m_recentRow = row;
 
-    if (it == m_properties.end())
+    const int page = row / PageSize;
+
+    if (page != m_recentPage || m_properties.contains(id) == false)
     {
-        fetchPhotoData(id);
-        std::tie(it, std::ignore) = m_properties.emplace(id, Photo::Data());   // insert empty properties so we won't call fetchPhotoProperties() for this 'id' again
+        // fetch whole page containing requested photo and prefetch next ones in scroll direction
+        const int direction = page >= m_recentPage? 1: -1;
+        m_recentPage = page;
+
+        for (int i = 0; i <= PrefetchPages; i++)
+            fetchPage(page + i * direction);
+
+        evictDistantPhotos();
     }
 
+    auto it = m_properties.find(id);
+    assert(it != m_properties.end());
+
     return it->second;
 }
 
 
-void FlatModel::fetchPhotoData(const Photo::Id& id) const
+void FlatModel::fetchPage(int page) const
+{
+    const int firstRow = page * PageSize;
+    const int lastRow = std::min(firstRow + PageSize, static_cast<int>(m_photos.size()));
+
+    std::vector<Photo::Id> ids;
+
+    for (int row = std::max(firstRow, 0); row < lastRow; row++)
+    {
+        const Photo::Id& id = m_photos[row];
+
+        // insert empty properties so photo won't be fetched again
+        const bool inserted = m_properties.try_emplace(id).second;
+
+        if (inserted)
+            ids.push_back(id);
+    }
+
+    if (ids.empty() == false)
+        m_db->exec(std::bind(&FlatModel::fetchPhotosProperties, this, _1, firstRow, ids));
+}
+
+
+void FlatModel::evictDistantPhotos() const
 {
-    auto b = std::bind(qOverload<Database::IBackend &, const Photo::Id &>(&FlatModel::fetchPhotoProperties), this, _1, id);
+    if (m_properties.size() <= MaxCachedPhotos)
+        return;
+
+    const int recentRow = m_recentRow;
 
-    m_db->exec(b);
+    std::erase_if(m_properties, [this, recentRow](const auto& item)
+    {
+        const auto row_it = m_idToRow.find(item.first);
+
+        return row_it == m_idToRow.end() || std::abs(row_it->second - recentRow) > static_cast<int>(MaxCachedPhotos / 2);
+    });
 }
 
 
-void FlatModel::fetchMatchingPhotos(Database::IBackend& backend)
+void FlatModel::fetchMatchingPhotos(Database::IBackend& backend, const std::weak_ptr<const Database::PhotosIndex>& index)
 {
     const Database::Actions::GroupAction sort_action({
         Database::Actions::SortByTimestamp(),
@@ -311,117 +430,192 @@ void FlatModel::fetchMatchingPhotos(Database::IBackend& backend)
     });
 
     const auto view_filters = filters();
-    const auto photos = backend.photoOperator().onPhotos(view_filters, sort_action);
+
+    // index is much faster than database but it does not support all filters.
+    // Index may be gone when this task is executed, check it.
+    const auto photosIndex = index.lock();
+    const auto indexed = photosIndex? photosIndex->onPhotos(view_filters, sort_action): std::nullopt;
+    const auto photos = indexed.has_value()? *indexed: backend.photoOperator().onPhotos(view_filters, sort_action);
 
     invokeMethod(this, &FlatModel::fetchedPhotos, photos);
 }
 
 
-void FlatModel::fetchPhotoProperties(Database::IBackend& backend, const Photo::Id& id) const
+void FlatModel::fetchPhotosProperties(Database::IBackend& backend, int firstRow, const std::vector<Photo::Id>& ids) const
 {
-    auto photo = backend.getPhoto(id);
+    FlatModel* self = const_cast<FlatModel*>(this);
 
-    invokeMethod(const_cast<FlatModel*>(this), &FlatModel::fetchedPhotoProperties, id, photo);
+    // view was scrolled far away since page was requested (fast scrolling) - skip it
+    if (std::abs(firstRow - m_recentRow) > MaxFetchDistance)
+        invokeMethod(self, &FlatModel::droppedPhotosProperties, ids);
+    else
+    {
+        const std::vector<Photo::Data> photos = backend.getPhotos(ids);
+
+        invokeMethod(self, &FlatModel::fetchedPhotosProperties, photos);
+    }
 }
 
 
 void FlatModel::fetchedPhotos(const std::vector<Photo::Id>& photos)
 {
-    auto last_new_it = [&photos](){ return photos.end(); };
-    auto last_old_it = [this](){ return m_photos.end(); };
-    auto new_photos_it = photos.begin();
-    auto old_photos_it = m_photos.begin();
-
-    auto insertPhotosAndUpdate = [this](auto& output, auto& first, const auto& last) {
-        output = insertPhotos(output, first, last);
-        const auto items = std::distance(first, last);
-        first = last;
-        output += items;
-    };
-
-    if (m_photos.empty())
-        insertPhotosAndUpdate(old_photos_it, new_photos_it, photos.cend());
-    else if (photos.empty())
-        erasePhotos(old_photos_it, last_old_it());
+    // position of each photo in new set
+    std::unordered_map<Photo::Id, std::size_t, Photo::IdHash> newPositions;
+    newPositions.reserve(photos.size());
+
+    for(std::size_t i = 0; i < photos.size(); i++)
+        newPositions.emplace(photos[i], i);
+
+    // Photos present in both sets which keep their relative order (longest increasing subsequence
+    // of their positions in new set) stay in model. All other photos are removed or inserted.
+    std::vector<std::size_t> positions;
+    positions.reserve(std::min(m_photos.size(), photos.size()));
+
+    std::vector<char> keptOld(m_photos.size(), false);
+    std::vector<char> keptNew(photos.size(), false);
+    std::vector<std::size_t> oldIndices;
+
+    for(std::size_t i = 0; i < m_photos.size(); i++)
+    {
+        auto it = newPositions.find(m_photos[i]);
+
+        if (it != newPositions.end())
+        {
+            oldIndices.push_back(i);
+            positions.push_back(it->second);
+        }
+    }
+
+    for(const std::size_t idx: longestIncreasingSubsequence(positions))
+    {
+        keptOld[oldIndices[idx]] = true;
+        keptNew[positions[idx]] = true;
+    }
+
+    if (countRuns(keptOld) + countRuns(keptNew) > MaxIncrementalChanges)
+    {
+        // too many scattered changes - views handle reset faster than thousands of notifications
+        beginResetModel();
+
+        std::erase_if(m_properties, [&newPositions](const auto& item)
+        {
+            return newPositions.contains(item.first) == false;
+        });
+
+        m_photos = photos;
+
+        endResetModel();
+    }
     else
-        while (new_photos_it != last_new_it() || old_photos_it != last_old_it())
+    {
+        std::size_t n = 0;          // position in new set
+        std::size_t row = 0;        // position in model
+
+        for(;;)
         {
-            if (new_photos_it != last_new_it() && old_photos_it == last_old_it())   // no more old, but still new ones?
+            // skip photos staying in model
+            while (n < photos.size() && row < m_photos.size() && keptNew[n] && m_photos[row] == photos[n])
             {
-                insertPhotosAndUpdate(old_photos_it, new_photos_it, last_new_it());
-                continue;
+                ++n;
+                ++row;
             }
-            else if (new_photos_it == last_new_it() && old_photos_it != last_old_it())   // no more new, but still old ones?
+
+            if (n == photos.size() && row == m_photos.size())
+                break;
+
+            const std::size_t nextKept = static_cast<std::size_t>(std::distance(keptNew.begin(), std::find(keptNew.begin() + n, keptNew.end(), true)));
+
+            if (nextKept == photos.size())
             {
-                erasePhotos(old_photos_it, last_old_it());
-                continue;
+                // no more photos staying in model - replace remaining ones with new ones
+                erasePhotos(m_photos.begin() + row, m_photos.end());
+                insertPhotos(m_photos.end(), photos.begin() + n, photos.end());
+                break;
             }
-
-            if (*new_photos_it == *old_photos_it)       // same photo on both sides - continue
+            else if (nextKept > n)
             {
-                ++new_photos_it;
-                ++old_photos_it;
+                // insert new photos before next photo staying in model
+                insertPhotos(m_photos.begin() + row, photos.begin() + n, photos.begin() + nextKept);
 
-                continue;
+                row += nextKept - n;
+                n = nextKept;
             }
-
-            // mismatch; check if new photo exists somewhere in old collection
-            const auto position_in_old_collection = std::find(old_photos_it, last_old_it(), *new_photos_it);
-
-            if (position_in_old_collection == m_photos.end())       // id of photo from new set doesn't exist in old one - insertion
+            else
             {
-                // find last item from new set which doesn't occur in old block
-                auto last_non_matching_new = std::next(new_photos_it);
-
-                while (last_non_matching_new != last_new_it())
-                {
-                    auto it = std::find(old_photos_it, last_old_it(), *last_non_matching_new);
-
-                    if (it == last_old_it())      // last_non_matching_new not found, keep looking
-                    {
-                        ++last_non_matching_new;
-                        continue;
-                    }
-                    else                        // last_non_matching_new found in old sequence.
-                    {
-                        insertPhotosAndUpdate(old_photos_it, new_photos_it, last_non_matching_new);  // insert block of new photos into old sequence
-                        break;
-                    }
-                }
-
-                if (last_non_matching_new == last_new_it())   // all items after new_photos_it where not found in old sequence.
-                {
-                    old_photos_it = erasePhotos(old_photos_it, last_old_it());    // everything in old sequence is not needed, remove it
-                    insertPhotosAndUpdate(old_photos_it, new_photos_it, last_new_it());
-                }
+                // remove photos preceding next photo staying in model
+                const auto first = m_photos.begin() + row;
+                erasePhotos(first, std::find(first, m_photos.end(), photos[n]));
             }
-            else
-                old_photos_it = erasePhotos(old_photos_it, position_in_old_collection);
         }
+    }
 
     assert(m_photos == photos);
 
-    m_idToRow.clear();
-    for(std::size_t i = 0; i < m_photos.size(); i++)
-        m_idToRow.emplace(m_photos[i], i);
-
-    assert(m_idToRow.size() == m_photos.size());
+    updateIdToRow();
 }
 
 
-void FlatModel::fetchedPhotoProperties(const Photo::Id& id, const Photo::Data& properties)
+void FlatModel::fetchedPhotosProperties(const std::vector<Photo::Data>& photos)
 {
-    auto it = m_idToRow.find(id);
+    std::vector<int> rowsToBeUpdated;
 
-    // photo may have been removed from model in the meantime (between fetchPhotoProperties and fetchedPhotoProperties execution)
-    if (it != m_idToRow.end())
+    for (const Photo::Data& photo: photos)
     {
-        const int row = it->second;
-        m_properties[id] = properties;
+        auto it = m_properties.find(photo.id);
+        auto row_it = m_idToRow.find(photo.id);
 
-        const QModelIndex idx = createIndex(row, 0);
-        emit dataChanged(idx, idx, {PhotoDataRole});
+        // photo may have been removed from model or evicted in the meantime (between fetchPhotosProperties and fetchedPhotosProperties execution)
+        if (it != m_properties.end() && row_it != m_idToRow.end())
+        {
+            it->second = photo;
+            rowsToBeUpdated.push_back(row_it->second);
+        }
     }
+
+    std::ranges::sort(rowsToBeUpdated);
+
+    std::vector<std::pair<int, int>> rangesToBeUpdated;
+    findConsecutiveRanges(rowsToBeUpdated.begin(), rowsToBeUpdated.end(), std::back_inserter(rangesToBeUpdated));
+
+    for(const auto& range: rangesToBeUpdated)
+        emit dataChanged(indexForRow(range.first), indexForRow(range.second), {PhotoDataRole});
+}
+
+
+void FlatModel::droppedPhotosProperties(const std::vector<Photo::Id>& ids)
+{
+    // forget about photos so they will be fetched when needed
+    for (const Photo::Id& id: ids)
+        m_properties.erase(id);
+
+    // view may have returned to dropped rows in the meantime - make it ask for them again
+    std::vector<int> droppedRows;
+    rowsOfIds(ids.begin(), ids.end(), std::back_inserter(droppedRows));
+
+    std::erase_if(droppedRows, [recentRow = m_recentRow.load()](int row)
+    {
+        return std::abs(row - recentRow) > MaxFetchDistance;
+    });
+
+    std::ranges::sort(droppedRows);
+
+    std::vector<std::pair<int, int>> rangesToBeRefreshed;
+    findConsecutiveRanges(droppedRows.begin(), droppedRows.end(), std::back_inserter(rangesToBeRefreshed));
+
+    for(const auto& range: rangesToBeRefreshed)
+        emit dataChanged(indexForRow(range.first), indexForRow(range.second), {PhotoDataRole});
+}
+
+
+void FlatModel::updateIdToRow()
+{
+    m_idToRow.clear();
+    m_idToRow.reserve(m_photos.size());
+
+    for(std::size_t i = 0; i < m_photos.size(); i++)
+        m_idToRow.emplace(m_photos[i], static_cast<int>(i));
+
+    assert(m_idToRow.size() == m_photos.size());
 }
 
 
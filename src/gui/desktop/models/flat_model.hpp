@@ -18,8 +18,10 @@
 #ifndef FLATMODEL_HPP
 #define FLATMODEL_HPP
 
-#include <map>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <QDate>
 #include <QUrl>
 
@@ -31,6 +33,7 @@ namespace Database
 {
     struct IDatabase;
     struct IBackend;
+    class PhotosIndex;
 }
 
 class FlatModel: public APhotoInfoModel
@@ -43,6 +46,7 @@ class FlatModel: public APhotoInfoModel
         explicit FlatModel(QObject* = nullptr);
 
         void setDatabase(Database::IDatabase *);
+        void setPhotosIndex(std::weak_ptr<const Database::PhotosIndex>);
         void setFilter(const Database::Filter &);
         const std::vector<Photo::Id>& photos() const;
         const Database::Filter& filter() const;
@@ -61,9 +65,12 @@ class FlatModel: public APhotoInfoModel
         Database::Filter m_filters;
         std::vector<Photo::Id> m_photos;
         mutable std::mutex m_filtersMutex;
-        mutable std::map<Photo::Id, int> m_idToRow;
-        mutable std::map<Photo::Id, Photo::Data> m_properties;
+        std::unordered_map<Photo::Id, int, Photo::IdHash> m_idToRow;
+        mutable std::unordered_map<Photo::Id, Photo::Data, Photo::IdHash> m_properties;   // data of photos around recently accessed row (empty for photos being fetched)
+        mutable std::atomic<int> m_recentRow;
+        mutable int m_recentPage;
         Database::IDatabase* m_db;
+        std::weak_ptr<const Database::PhotosIndex> m_photosIndex;
 
         void reloadPhotos();
         void updatePhotos();
@@ -74,15 +81,17 @@ class FlatModel: public APhotoInfoModel
         const Database::Filter& filters() const;
 
         const Photo::Data& photoData(const Photo::Id &) const;
-        void fetchPhotoData(const Photo::Id &) const;
+        void fetchPage(int page) const;
+        void evictDistantPhotos() const;
 
         // methods working on backend
-        void fetchMatchingPhotos(Database::IBackend &);
-        void fetchPhotoProperties(Database::IBackend &, const Photo::Id &) const;
+        void fetchMatchingPhotos(Database::IBackend &, const std::weak_ptr<const Database::PhotosIndex> &);
+        void fetchPhotosProperties(Database::IBackend &, int firstRow, const std::vector<Photo::Id> &) const;
 
         // results from backend
         void fetchedPhotos(const std::vector<Photo::Id> &);
-        void fetchedPhotoProperties(const Photo::Id &, const Photo::Data &);
+        void fetchedPhotosProperties(const std::vector<Photo::Data> &);
+        void droppedPhotosProperties(const std::vector<Photo::Id> &);
 
         // altering model
         template<typename T>
@@ -136,6 +145,7 @@ class FlatModel: public APhotoInfoModel
             }
         }
 
+        void updateIdToRow();
         QModelIndex indexForRow(int r) const;
 };
 
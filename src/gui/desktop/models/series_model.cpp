@@ -152,10 +152,11 @@ void SeriesModel::fetchGroups()
         [this](QPromise<std::vector<GroupCandidate>>& promise)
         {
             IExifReaderFactory& exif = m_core.getExifReaderFactory();
+            ITaskExecutor& executor = m_core.getTaskExecutor();
 
             QElapsedTimer timer;
 
-            SeriesDetector detector(m_project.getDatabase(), exif.get(), &promise);
+            SeriesDetector detector(m_project.getDatabase(), exif, executor, &promise);
 
             timer.start();
             promise.addResult(detector.listCandidates());
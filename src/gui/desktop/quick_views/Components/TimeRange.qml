@@ -41,11 +41,21 @@ Item {
             property var from: timeSliderId.first.value
             property var to: timeSliderId.second.value
 
-            text: formatDate(model.dateFor(from)) + " - " + formatDate(model.dateFor(to))
+            text: formatDate(model.dateFor(from)) + " - " + formatDate(model.dateFor(to)) + " " + qsTr("(%n photo(s))", "", photosInRange(from, to))
             anchors.verticalCenter: parent.verticalCenter
         }
     }
 
+    function photosInRange(from, to) {
+        var photosPerDate = model.photosPerDate;
+        var count = 0;
+
+        for (var i = from; i <= to && i < photosPerDate.length; i++)
+            count += photosPerDate[i];
+
+        return count;
+    }
+
     function formatDate(date) {
         if (isNaN(date.getTime())) {
             return qsTr("unknown");
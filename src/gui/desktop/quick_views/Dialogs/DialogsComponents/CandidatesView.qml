@@ -0,0 +1,214 @@
+import QtQuick 2.15
+import QtQuick.Layouts 1.15
+import QtQuick.Controls 2.15
+import "../../Components" as Components
+
+/*
+ * List of candidates (series, duplicates) found in collection.
+ * Shared by detection dialogs.
+ */
+
+Item
+{
+    id: candidatesViewId
+
+    required property var model             // expected to have 'loaded' property
+    property string title
+    property string actionText
+    property string loadingText
+
+    // emitted with indices of unselected candidates
+    signal accepted(var unselected)
+
+    state: "LoadingState"
+
+    SystemPalette { id: currentPalette; colorGroup: SystemPalette.Active }
+
+    RowLayout {
+        id: groupsId
+        anchors.fill: parent
+
+        ColumnLayout {
+            id: column
+            width: 200
+            height: 400
+
+            Text {
+                id: element
+                text: candidatesViewId.title
+                Layout.alignment: Qt.AlignHCenter | Qt.AlignVCenter
+                font.pixelSize: 12
+            }
+
+            Components.DelegateState {
+                id: delegateState
+
+                defaultValue: true
+            }
+
+            ListView {
+                id: groupsListId
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+
+                property alias thumbnailSize: thumbnailSliderId.size
+
+                clip: true
+                model: candidatesViewId.model
+                spacing: 10
+
+                ScrollBar.vertical: ScrollBar { }
+
+                delegate: Item {
+                    id: delegateId
+
+                    width: delegateId.ListView.view.width       // using 'parent' causes erros in output after thumbnail being resized
+                    height: groupDetails.height
+
+                    // from view
+                    required property int index
+
+                    // from model - roles
+                    required property var photoData
+                    required property var groupType
+                    required property var members
+
+                    Row {
+                        anchors.fill: parent
+
+                        Components.DelegateCheckBox {
+                            id: checkBox
+
+                            state: delegateState
+                            index: delegateId.index
+                        }
+
+                        Item {
+                            id: groupDetails
+
+                            width: parent.width - checkBox.width
+                            height: groupTypeId.height + membersList.height
+
+                            Text {
+                                id: groupTypeId
+                                text: groupType
+
+                                anchors.bottom: membersList.top
+                            }
+
+                            ListView {
+                                id: membersList
+
+                                clip: true
+
+                                width: parent.width
+                                height: groupsListId.thumbnailSize
+                                anchors.bottom: parent.bottom
+
+                                orientation: ListView.Horizontal
+                                model: members
+
+                                delegate: PhotoDelegate
+                                {
+                                    width: membersList.height
+                                    height: membersList.height
+                                }
+                            }
+                        }
+                    }
+                }
+
+                Components.ThumbnailSlider {
+                    id: thumbnailSliderId
+                    anchors.bottom: parent.bottom
+                    anchors.right: parent.right
+
+                    minimumSize: 100
+                }
+            }
+
+            Button {
+                id: button
+                text: candidatesViewId.actionText
+
+                Connections {
+                    target: button
+                    function onClicked() {
+                        var unselected = delegateState.getItems((state) => {return state === false;});
+
+                        candidatesViewId.accepted(unselected);
+                        delegateState.clear();
+                    }
+                }
+            }
+        }
+    }
+
+    Item {
+        id: loadingId
+        anchors.fill: parent
+
+        Item {
+            id: containerId
+            width: childrenRect.width
+            height: childrenRect.height
+            anchors.horizontalCenter: parent.horizontalCenter
+            anchors.verticalCenter: parent.verticalCenter
+
+            BusyIndicator {
+                id: busyIndicatorId
+                anchors.top: infoId.bottom
+                anchors.topMargin: 0
+                anchors.horizontalCenter: infoId.horizontalCenter
+            }
+
+            Text {
+                id: infoId
+                text: candidatesViewId.loadingText
+                anchors.top: parent.top
+                font.pixelSize: 12
+            }
+        }
+    }
+
+    states: [
+        State {
+            name: "LoadingState"
+
+            PropertyChanges {
+                target: groupsId
+                opacity: 0
+            }
+        },
+        State {
+            name: "LoadedState"
+            when: candidatesViewId.model.loaded
+        }
+    ]
+
+    transitions:
+        Transition {
+        from: "LoadingState"
+        to: "LoadedState"
+        ParallelAnimation {
+            PropertyAnimation {
+                target: loadingId
+                properties: "opacity"
+                from: 1
+                to: 0
+            }
+            PropertyAnimation {
+                target: groupsId
+                properties: "opacity"
+                from: 0
+                to: 1
+            }
+        }
+    }
+}
+
+/*##^##
+Designer {
+    D{i:0;autoSize:true;height:480;width:640}
+}
+##^##*/
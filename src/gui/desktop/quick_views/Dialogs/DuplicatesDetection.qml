@@ -0,0 +1,21 @@
+import QtQuick 2.15
+import "DialogsComponents" as Internals
+
+/*
+ * Duplicates detection dialog
+ */
+
+Internals.CandidatesView
+{
+    id: duplicatesDetectionMainId
+    objectName: "duplicatesDetectionMain"
+
+    model: groupsModelId
+    title: qsTr("Duplicates")
+    actionText: qsTr("Remove duplicates from collection")
+    loadingText: qsTr("Looking for duplicates...")
+
+    onAccepted: function(unselected) {
+        groupsModelId.removeDuplicatesBut(unselected);
+    }
+}
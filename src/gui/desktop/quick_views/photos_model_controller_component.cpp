@@ -32,30 +32,41 @@ using namespace std::chrono_literals;
 namespace
 {
     const char* expressions_separator = ",";
+    constexpr std::chrono::milliseconds TimeRangeMaxLatency = 2s;
 }
 
 
 PhotosModelControllerComponent::PhotosModelControllerComponent(QObject* p)
     : QObject(p)
     , m_newPhotosOnly(false)
+    , m_photosIndex(std::make_shared<Database::PhotosIndex>())
     , m_model(new FlatModel(this))
     , m_db(nullptr)
     , m_completerFactory(nullptr)
 {
     m_searchLauncher.setSingleShot(true);
     connect(&m_searchLauncher, &QTimer::timeout, this, &PhotosModelControllerComponent::updateModelFilters);
+
+    // many changes come in bursts (photos import) - recalculate time range once for all of them
+    m_timeRangeUpdater.setSingleShot(true);
+    m_timeRangeUpdater.setInterval(500ms);
+    connect(&m_timeRangeUpdater, &QTimer::timeout, this, &PhotosModelControllerComponent::updateTimeRange);
+
+    m_model->setPhotosIndex(m_photosIndex);
 }
 
 
 void PhotosModelControllerComponent::setDatabase(Database::IDatabase* db)
 {
+    m_photosIndex->set(db);
     m_model->setDatabase(db);
 
     if (db == nullptr && m_db != nullptr)
     {
-        disconnect(&m_db->backend(), &Database::IBackend::photosAdded, this, &PhotosModelControllerComponent::updateTimeRange);
-        disconnect(&m_db->backend(), &Database::IBackend::photosModified, this, &PhotosModelControllerComponent::updateTimeRange);
-        disconnect(&m_db->backend(), &Database::IBackend::photosRemoved, this, &PhotosModelControllerComponent::updateTimeRange);
+        disconnect(&m_db->backend(), &Database::IBackend::photosAdded, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
+        disconnect(&m_db->backend(), &Database::IBackend::photosModified, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
+        disconnect(&m_db->backend(), &Database::IBackend::photosRemoved, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
+        m_timeRangeUpdater.stop();
     }
 
     m_db = db;
@@ -63,9 +74,9 @@ void PhotosModelControllerComponent::setDatabase(Database::IDatabase* db)
     if (db != nullptr)
     {
         updateTimeRange();
-        connect(&m_db->backend(), &Database::IBackend::photosAdded, this, &PhotosModelControllerComponent::updateTimeRange);
-        connect(&m_db->backend(), &Database::IBackend::photosModified, this, &PhotosModelControllerComponent::updateTimeRange);
-        connect(&m_db->backend(), &Database::IBackend::photosRemoved, this, &PhotosModelControllerComponent::updateTimeRange);
+        connect(&m_db->backend(), &Database::IBackend::photosAdded, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
+        connect(&m_db->backend(), &Database::IBackend::photosModified, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
+        connect(&m_db->backend(), &Database::IBackend::photosRemoved, this, &PhotosModelControllerComponent::scheduleTimeRangeUpdate);
     }
 }
 
@@ -121,6 +132,12 @@ unsigned int PhotosModelControllerComponent::datesCount() const
 }
 
 
+QList<int> PhotosModelControllerComponent::photosPerDate() const
+{
+    return m_photosPerDate;
+}
+
+
 unsigned int PhotosModelControllerComponent::timeViewFrom() const
 {
     return m_timeView.first;
@@ -258,10 +275,27 @@ void PhotosModelControllerComponent::updateModelFilters()
 }
 
 
-void PhotosModelControllerComponent::setAvailableDates(const std::vector<TagValue>& dates_as_tags)
+void PhotosModelControllerComponent::setAvailableDates(const Database::DateHistogram& histogram)
 {
     std::vector<QDate> dates;
-    std::transform(dates_as_tags.begin(), dates_as_tags.end(), std::back_inserter(dates), [](const auto& d) { return d.getDate(); });
+    QList<int> photosPerDate;
+
+    dates.reserve(histogram.photos.size());
+    photosPerDate.reserve(static_cast<qsizetype>(histogram.photos.size()));
+
+    // histogram is sorted by date with photos without date (invalid date) first
+    for (const auto& [date, count]: histogram.photos)
+    {
+        dates.push_back(date);
+        photosPerDate.push_back(count);
+    }
+
+    if (photosPerDate != m_photosPerDate)
+    {
+        m_photosPerDate = photosPerDate;
+
+        emit photosPerDateChanged();
+    }
 
     if (dates != m_dates)
     {
@@ -283,6 +317,22 @@ void PhotosModelControllerComponent::updateTimeRange()
 }
 
 
+void PhotosModelControllerComponent::scheduleTimeRangeUpdate()
+{
+    // restarting timer postpones update, but do not postpone it forever when changes keep coming
+    if (m_timeRangeUpdater.isActive() == false)
+        m_timeRangeLatency.start();
+
+    if (m_timeRangeLatency.hasExpired(TimeRangeMaxLatency.count()))
+    {
+        m_timeRangeUpdater.stop();
+        updateTimeRange();
+    }
+    else
+        m_timeRangeUpdater.start();
+}
+
+
 Database::Filter PhotosModelControllerComponent::allFilters() const
 {
     std::vector<Database::Filter> filters_for_model;
@@ -347,17 +397,9 @@ QStringList PhotosModelControllerComponent::rawCategories() const
 
 void PhotosModelControllerComponent::getTimeRangeForFilters(Database::IBackend& backend)
 {
-    auto dates = backend.listTagValues(TagTypes::Date, {});
-
-    const Database::FilterPhotosWithTag with_date_filter(TagTypes::Date);
-    const Database::FilterNotMatchingFilter without_date_filter(with_date_filter);
-    const auto photos_without_date_tag = backend.photoOperator().getPhotos(without_date_filter);
-
-    if (photos_without_date_tag.empty() == false)
-        dates.push_back(QDate());
+    const Database::DateHistogram histogram = backend.getDateHistogram({}, Database::DateHistogram::Granularity::Day);
 
-    std::sort(dates.begin(), dates.end());
-    invokeMethod(this, &PhotosModelControllerComponent::setAvailableDates, dates);
+    invokeMethod(this, &PhotosModelControllerComponent::setAvailableDates, histogram);
 }
 
 
@@ -19,12 +19,14 @@
 #define PHOTOSMODELCOMPONENT_HPP
 
 #include <QDate>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
 #include <QStandardItemModel>
 
 #include <database/idatabase.hpp>
 #include <database/filter.hpp>
+#include <database/database_tools/photos_index.hpp>
 #include "models/flat_model.hpp"
 
 
@@ -38,6 +40,7 @@ class PhotosModelControllerComponent: public QObject
         // getters
         Q_PROPERTY(QAbstractItemModel* photos READ model NOTIFY modelChanged)
         Q_PROPERTY(unsigned int datesCount READ datesCount NOTIFY datesCountChanged)
+        Q_PROPERTY(QList<int> photosPerDate READ photosPerDate NOTIFY photosPerDateChanged)
         Q_PROPERTY(QStringList categories READ categories NOTIFY categoriesChanged)
 
         // setters - filters narrowing view
@@ -59,6 +62,7 @@ class PhotosModelControllerComponent: public QObject
         APhotoInfoModel* model() const;
         QStringList categories() const;
         unsigned int datesCount() const;
+        QList<int> photosPerDate() const;
 
         // getters for filter
         unsigned int timeViewFrom() const;
@@ -86,10 +90,14 @@ class PhotosModelControllerComponent: public QObject
         void modelChanged() const;
         void categoriesChanged() const;
         void datesCountChanged() const;
+        void photosPerDateChanged() const;
 
     private:
         QTimer m_searchLauncher;
+        QTimer m_timeRangeUpdater;
+        QElapsedTimer m_timeRangeLatency;
         std::vector<QDate> m_dates;
+        QList<int> m_photosPerDate;
 
         // filters
         QPair<unsigned int, unsigned int> m_timeView;
@@ -100,13 +108,15 @@ class PhotosModelControllerComponent: public QObject
         bool m_newPhotosOnly;
         //
 
+        std::shared_ptr<Database::PhotosIndex> m_photosIndex;
         FlatModel* m_model;
         Database::IDatabase* m_db;
         ICompleterFactory* m_completerFactory;
 
         void updateModelFilters();
-        void setAvailableDates(const std::vector<TagValue> &);
+        void setAvailableDates(const Database::DateHistogram &);
         void updateTimeRange();
+        void scheduleTimeRangeUpdate();
         Database::Filter allFilters() const;
         QStringList rawCategories() const;
 
@@ -39,8 +39,10 @@
 #include "models/flat_model.hpp"
 #include "widgets/project_creator/project_creator_dialog.hpp"
 #include "widgets/series_detection/series_detection.hpp"
+#include "widgets/duplicates_detection/duplicates_detection.hpp"
 #include "widgets/collection_dir_scan_dialog.hpp"
 #include "ui_utils/config_dialog_manager.hpp"
+#include "utils/faces_analyzer.hpp"
 #include "utils/groups_manager.hpp"
 #include "utils/grouppers/collage_generator.hpp"
 #include "utils/selection_to_photoid_translator.hpp"
@@ -377,9 +379,18 @@ void MainWindow::updateTools()
     {
         m_photosAnalyzer = std::make_unique<PhotosAnalyzer>(m_coreAccessor, m_currentPrj->getDatabase());
         m_photosAnalyzer->set(ui->tasksWidget);
+
+        if (m_enableFaceRecognition)
+        {
+            m_facesAnalyzer = std::make_unique<FacesAnalyzer>(*m_coreAccessor, m_currentPrj->getDatabase());
+            m_facesAnalyzer->set(ui->tasksWidget);
+        }
     }
     else
+    {
+        m_facesAnalyzer.reset();
         m_photosAnalyzer.reset();
+    }
 }
 
 
@@ -471,7 +482,7 @@ void MainWindow::showContextMenu(const QPoint& pos)
 
     if (chosenAction == groupPhotos)
     {
-        GroupsManager::groupIntoCollage(m_coreAccessor->getExifReaderFactory(), *m_currentPrj.get(), photos);
+        GroupsManager::groupIntoCollage(m_coreAccessor->getExifReaderFactory(), m_executor, *m_currentPrj.get(), photos);
     }
     else if (chosenAction == manageGroup)
     {
@@ -681,6 +692,12 @@ void MainWindow::on_actionSeries_detector_triggered()
     SeriesDetection{m_currentPrj->getDatabase(), m_coreAccessor, m_thumbnailsManager, *m_currentPrj.get()}.exec();
 }
 
+
+void MainWindow::on_actionDuplicates_detector_triggered()
+{
+    DuplicatesDetection{m_currentPrj->getDatabase(), m_coreAccessor, m_thumbnailsManager, *m_currentPrj.get()}.exec();
+}
+
 void MainWindow::on_actionPhoto_data_completion_triggered()
 {
     QObject* mainwindow = QmlUtils::findQmlObject(ui->mainViewQml, "MainWindow");
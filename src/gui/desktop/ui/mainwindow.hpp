@@ -19,6 +19,7 @@ class ConfigDialogManager;
 class LookTabController;
 class MainTabController;
 class ToolsTabController;
+class FacesAnalyzer;
 class PhotosAnalyzer;
 class PhotosWidget;
 struct ICoreFactoryAccessor;
@@ -69,6 +70,7 @@ class MainWindow: public QMainWindow, public INotifications
         ICoreFactoryAccessor*     m_coreAccessor;
         IThumbnailsManager*       m_thumbnailsManager;
         std::unique_ptr<PhotosAnalyzer> m_photosAnalyzer;
+        std::unique_ptr<FacesAnalyzer> m_facesAnalyzer;
         std::unique_ptr<ConfigDialogManager> m_configDialogManager;
         std::unique_ptr<MainTabController> m_mainTabCtrl;
         std::unique_ptr<ToolsTabController> m_toolsTabCtrl;
@@ -127,6 +129,7 @@ class MainWindow: public QMainWindow, public INotifications
 
         // tools menu
         void on_actionSeries_detector_triggered();
+        void on_actionDuplicates_detector_triggered();
         void on_actionPhoto_data_completion_triggered();
 
         // settings menu
@@ -290,7 +290,6 @@ void PhotosGroupingDialog::makeAnimation()
     AnimationGenerator::Data generator_data;
 
     generator_data.storage = m_tmpDir->path();
-    generator_data.alignImageStackPath = m_config.getEntry(ExternalToolsConfigKeys::aisPath).toString();
     generator_data.magickPath = m_config.getEntry(ExternalToolsConfigKeys::magickPath).toString();
     generator_data.photos = getPhotos();
     generator_data.format = ui->formatComboBox->currentText();
@@ -299,7 +298,7 @@ void PhotosGroupingDialog::makeAnimation()
     generator_data.delay = ui->delaySpinBox->value();
     generator_data.stabilize = ui->stabilizationCheckBox->isChecked();
 
-    auto animation_task = std::make_unique<AnimationGenerator>(generator_data, m_logger, m_exifReaderFactory);
+    auto animation_task = std::make_unique<AnimationGenerator>(generator_data, m_logger, m_exifReaderFactory, m_executor);
 
     startTask(std::move(animation_task));
 }
@@ -310,11 +309,9 @@ void PhotosGroupingDialog::makeHDR()
     HDRGenerator::Data generator_data;
 
     generator_data.storage = m_tmpDir->path();
-    generator_data.alignImageStackPath = m_config.getEntry(ExternalToolsConfigKeys::aisPath).toString();
-    generator_data.magickPath = m_config.getEntry(ExternalToolsConfigKeys::magickPath).toString();
     generator_data.photos = getPhotos();
 
-    auto hdr_task = std::make_unique<HDRGenerator>(generator_data, m_logger, m_exifReaderFactory);
+    auto hdr_task = std::make_unique<HDRGenerator>(generator_data, m_logger, m_exifReaderFactory, m_executor);
 
     startTask(std::move(hdr_task));
 }
@@ -322,7 +319,7 @@ void PhotosGroupingDialog::makeHDR()
 
 void PhotosGroupingDialog::makeCollage()
 {
-    CollageGenerator generator(m_exifReaderFactory.get());
+    CollageGenerator generator(m_exifReaderFactory, m_executor);
     const int height = ui->collageHeight->text().toInt();
     const QImage collage = generator.generateCollage(getPhotos(), height);
 
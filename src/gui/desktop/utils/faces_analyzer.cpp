@@ -0,0 +1,371 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "faces_analyzer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+#include <QFileInfo>
+
+#include <core/icore_factory_accessor.hpp>
+#include <core/iexif_reader.hpp>
+#include <core/itask_executor.hpp>
+#include <core/itasks_view.hpp>
+#include <core/iview_task.hpp>
+#include <core/media_types.hpp>
+#include <core/oriented_image.hpp>
+#include <core/task_executor_utils.hpp>
+#include <database/general_flags.hpp>
+#include <database/ibackend.hpp>
+#include <database/iphoto_operator.hpp>
+#include <face_recognition/face_recognition.hpp>
+
+
+namespace
+{
+    // max number of photos fetched from database at once
+    constexpr std::size_t MaxBatchSize = 16;
+
+    // number of analyzed photos stored in database at once
+    constexpr std::size_t StoreBatchSize = 16;
+}
+
+
+FacesAnalyzer::FacesAnalyzer(ICoreFactoryAccessor& core, Database::IDatabase& database)
+    : m_core(core)
+    , m_database(database)
+    , m_tasksView(nullptr)
+    , m_viewTask(nullptr)
+    , m_maxProgress(0)
+    , m_tasksInFlight(0)
+    , m_maxTasksInFlight(std::max(core.getTaskExecutor().heavyWorkers() / 2, 1))
+    , m_dbTasks(1)                      // initial scan
+    , m_refreshPending(false)
+    , m_fetching(true)                  // no batches until initial scan is done
+    , m_stopped(false)
+{
+    const Database::FilterPhotosWithGeneralFlag faces_filter(Database::CommonGeneralFlags::FacesRecognized, 0);
+    const Database::FilterPhotosWithGeneralFlag state_filter(Database::CommonGeneralFlags::State,
+                                                             static_cast<int>(Database::CommonGeneralFlags::StateType::Normal));
+
+    const Database::GroupFilter filters = {faces_filter, state_filter};
+
+    // connection is owned by this thread. Photos added before initial scan is finished are
+    // queued by addPhotos() and merged with scan results, so none is analyzed twice
+    m_backendConnection = connect(&m_database.backend(), &Database::IBackend::photosAdded,
+                                  this, &FacesAnalyzer::addPhotos, Qt::DirectConnection);
+
+    m_database.exec([this, filters](Database::IBackend& backend)
+    {
+        bool stopped = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            stopped = m_stopped;
+        }
+
+        const std::vector<Photo::Id> photos = stopped? std::vector<Photo::Id>(): backend.photoOperator().getPhotos(filters);
+
+        scanFinished(photos);
+    });
+}
+
+
+FacesAnalyzer::~FacesAnalyzer()
+{
+    stop();
+
+    if (m_viewTask)
+        m_viewTask->finished();
+}
+
+
+void FacesAnalyzer::set(ITasksView* tasksView)
+{
+    m_tasksView = tasksView;
+}
+
+
+void FacesAnalyzer::stop()
+{
+    disconnect(m_backendConnection);
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    m_stopped = true;
+    m_photosToAnalyze.clear();
+
+    // photosAdded is emitted from database thread. Pass a marker through database queue
+    // so any emission which was in progress while disconnecting is done when marker arrives.
+    m_dbTasks++;
+    lock.unlock();
+
+    m_database.exec([this](Database::IBackend &)
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_dbTasks--;
+        m_idle.notify_all();
+    });
+
+    lock.lock();
+
+    // wait for started analyses and store their results
+    m_idle.wait(lock, [this]
+    {
+        return m_tasksInFlight == 0 && m_dbTasks == 0 && m_fetching == false;
+    });
+
+    storeResults(lock);
+}
+
+
+void FacesAnalyzer::scanFinished(const std::vector<Photo::Id>& ids)
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    if (m_stopped == false)
+    {
+        const std::set<Photo::Id> queued(m_photosToAnalyze.begin(), m_photosToAnalyze.end());
+
+        std::copy_if(ids.begin(), ids.end(), std::back_inserter(m_photosToAnalyze), [&queued](const Photo::Id& id)
+        {
+            return queued.contains(id) == false;
+        });
+    }
+
+    assert(m_dbTasks > 0);
+    m_dbTasks--;
+    m_fetching = false;
+
+    fetchNextBatch(lock);
+
+    m_idle.notify_all();
+    requestRefresh();
+}
+
+
+void FacesAnalyzer::addPhotos(const std::vector<Photo::Id>& ids)
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    if (m_stopped == false)
+    {
+        m_photosToAnalyze.insert(m_photosToAnalyze.end(), ids.begin(), ids.end());
+        fetchNextBatch(lock);
+    }
+
+    requestRefresh();
+}
+
+
+void FacesAnalyzer::fetchNextBatch(std::unique_lock<std::mutex>& lock)
+{
+    assert(lock.owns_lock());
+
+    if (m_stopped || m_fetching || m_tasksInFlight >= m_maxTasksInFlight || m_photosToAnalyze.empty())
+        return;
+
+    const std::size_t toProcess = std::min({m_photosToAnalyze.size(), m_maxTasksInFlight - m_tasksInFlight, MaxBatchSize});
+    const std::vector<Photo::Id> batch(m_photosToAnalyze.begin(), m_photosToAnalyze.begin() + toProcess);
+    m_photosToAnalyze.erase(m_photosToAnalyze.begin(), m_photosToAnalyze.begin() + toProcess);
+
+    // piggyback on database access to store collected results
+    std::map<Photo::Id, Faces> results;
+    results.swap(m_results);
+
+    // batch may be processed before we get the lock back. Do not let stop() finish until then
+    m_fetching = true;
+    m_dbTasks++;
+    lock.unlock();
+
+    m_database.exec([batch, results, this](Database::IBackend& backend)
+    {
+        processBatch(backend, batch, results);
+    });
+
+    lock.lock();
+    m_dbTasks--;
+    m_idle.notify_all();
+}
+
+
+void FacesAnalyzer::processBatch(Database::IBackend& backend, const std::vector<Photo::Id>& batch, std::map<Photo::Id, Faces> results)
+{
+    const std::vector<Photo::Data> photos = backend.getPhotos(batch);
+    const std::vector<PersonInfo> people = backend.peopleInformationAccessor().listPeople(batch);
+
+    std::set<Photo::Id> withFaces;
+    for(const auto& person: people)
+        if (person.rect.isValid())
+            withFaces.insert(person.ph_id);
+
+    std::vector<std::pair<Photo::Id, QString>> toAnalyze;
+
+    for(const auto& photo: photos)
+    {
+        // faces were marked by user already or there is nothing to look at
+        if (withFaces.contains(photo.id) || MediaTypes::isImageFile(photo.path) == false)
+            results.emplace(photo.id, Faces());
+        else
+            toAnalyze.emplace_back(photo.id, QFileInfo(photo.path).absoluteFilePath());
+    }
+
+    // results of previous batches and photos which need no analysis are stored at once
+    if (results.empty() == false)
+        backend.storeFaces(results);
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    if (m_stopped == false)
+    {
+        m_tasksInFlight += toAnalyze.size();
+
+        for(const auto& [id, path]: toAnalyze)
+            runOn(m_core.getTaskExecutor(), [this, id, path]
+            {
+                analyze(id, path);
+            }, "FacesAnalyzer");
+    }
+
+    m_fetching = false;
+
+    fetchNextBatch(lock);
+
+    m_idle.notify_all();
+    requestRefresh();
+}
+
+
+void FacesAnalyzer::analyze(const Photo::Id& id, const QString& path)
+{
+    std::optional<Faces> faces = Faces();
+
+    const OrientedImage image(m_core.getExifReaderFactory().get(), path);
+
+    if (image->isNull() == false)
+    {
+        FaceRecognition face_recognition(&m_core);
+
+        const auto rects = face_recognition.fetchFaces(image);
+        const auto fingerprints = face_recognition.getFingerprints(image, rects);
+
+        // fingerprints could not be calculated, leave photo for next session
+        if (fingerprints.size() != static_cast<std::size_t>(rects.size()))
+            faces.reset();
+        else
+            for(int i = 0; i < rects.size(); i++)
+                faces->emplace_back(rects[i], fingerprints[static_cast<std::size_t>(i)]);
+    }
+
+    taskFinished(id, faces);
+}
+
+
+void FacesAnalyzer::taskFinished(const Photo::Id& id, const std::optional<Faces>& faces)
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    assert(m_tasksInFlight > 0);
+    m_tasksInFlight--;
+
+    if (faces)
+        m_results.emplace(id, *faces);
+
+    fetchNextBatch(lock);
+
+    // nothing to piggyback on
+    if (m_results.size() >= StoreBatchSize || (m_tasksInFlight == 0 && m_fetching == false))
+        storeResults(lock);
+
+    m_idle.notify_all();
+    requestRefresh();
+}
+
+
+void FacesAnalyzer::storeResults(std::unique_lock<std::mutex>& lock)
+{
+    assert(lock.owns_lock());
+
+    if (m_results.empty())
+        return;
+
+    std::map<Photo::Id, Faces> results;
+    results.swap(m_results);
+
+    // count pending store, so stop() does not return before we get the lock back
+    m_dbTasks++;
+    lock.unlock();
+
+    m_database.exec([results](Database::IBackend& backend)
+    {
+        backend.storeFaces(results);
+    });
+
+    lock.lock();
+    m_dbTasks--;
+    m_idle.notify_all();
+}
+
+
+void FacesAnalyzer::requestRefresh()
+{
+    // progress is updated in gui thread. Post only one request at a time.
+    // Always queue it, as this function is called with m_queueMutex locked
+    if (m_refreshPending.exchange(true) == false)
+        QMetaObject::invokeMethod(this, &FacesAnalyzer::refreshView, Qt::QueuedConnection);
+}
+
+
+void FacesAnalyzer::refreshView()
+{
+    m_refreshPending = false;
+
+    std::size_t pending = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        pending = m_photosToAnalyze.size() + m_tasksInFlight;
+    }
+
+    if (m_tasksView == nullptr)
+        return;
+
+    if (pending > 0 && m_viewTask == nullptr)
+    {
+        m_maxProgress = 0;
+        m_viewTask = m_tasksView->add(tr("Looking for faces..."));
+    }
+    else if (pending == 0 && m_viewTask != nullptr)
+    {
+        m_viewTask->finished();
+        m_viewTask = nullptr;
+    }
+
+    if (m_viewTask != nullptr)
+    {
+        const int current_size = static_cast<int>(pending);
+        m_maxProgress = std::max(m_maxProgress, current_size);
+
+        IProgressBar* progressBar = m_viewTask->getProgressBar();
+        progressBar->setMaximum(m_maxProgress);
+        progressBar->setValue(m_maxProgress - current_size);
+    }
+}
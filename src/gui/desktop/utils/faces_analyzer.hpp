@@ -0,0 +1,99 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FACES_ANALYZER_HPP_INCLUDED
+#define FACES_ANALYZER_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include <QObject>
+#include <QRect>
+
+#include <database/idatabase.hpp>
+#include <database/person_data.hpp>
+
+
+struct ICoreFactoryAccessor;
+struct ITasksView;
+struct IViewTask;
+
+
+/**
+ * \brief Background analysis of faces in whole collection
+ *
+ * Photos not having FacesRecognized general flag set are fetched from database in batches.
+ * Faces are located and their fingerprints are calculated on executor's threads.
+ * Results are stored in database in bulk (one transaction per batch) and photos are marked with FacesRecognized flag,
+ * so analysis continues where it was stopped after restart.
+ * Photos for which fingerprints could not be calculated are not marked and are analyzed again in next session.
+ *
+ * To leave executor for interactive tasks, at most half of heavy workers is used by analysis.
+ */
+class FacesAnalyzer: public QObject
+{
+        Q_OBJECT
+
+    public:
+        FacesAnalyzer(ICoreFactoryAccessor &, Database::IDatabase &);
+        FacesAnalyzer(const FacesAnalyzer &) = delete;
+        ~FacesAnalyzer();
+
+        FacesAnalyzer& operator=(const FacesAnalyzer &) = delete;
+
+        void set(ITasksView *);
+        void stop();
+
+    private:
+        // location and fingerprint of each face found on photo
+        using Faces = std::vector<std::pair<QRect, Person::Fingerprint>>;
+
+        std::mutex m_queueMutex;
+        std::condition_variable m_idle;
+        std::deque<Photo::Id> m_photosToAnalyze;
+        std::map<Photo::Id, Faces> m_results;
+        QMetaObject::Connection m_backendConnection;
+        ICoreFactoryAccessor& m_core;
+        Database::IDatabase& m_database;
+        ITasksView* m_tasksView;
+        IViewTask* m_viewTask;
+        int m_maxProgress;
+        std::size_t m_tasksInFlight;
+        const std::size_t m_maxTasksInFlight;
+        std::size_t m_dbTasks;
+        std::atomic<bool> m_refreshPending;
+        bool m_fetching;
+        bool m_stopped;
+
+        void scanFinished(const std::vector<Photo::Id> &);
+        void addPhotos(const std::vector<Photo::Id> &);
+        void fetchNextBatch(std::unique_lock<std::mutex> &);
+        void processBatch(Database::IBackend &, const std::vector<Photo::Id> &, std::map<Photo::Id, Faces>);
+        void analyze(const Photo::Id &, const QString &);
+        void taskFinished(const Photo::Id &, const std::optional<Faces> &);
+        void storeResults(std::unique_lock<std::mutex> &);
+        void requestRefresh();
+        void refreshView();
+};
+
+#endif
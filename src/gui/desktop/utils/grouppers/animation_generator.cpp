@@ -19,21 +19,23 @@
 
 #include "animation_generator.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
-#include <QDirIterator>
-#include <QFileInfo>
-
 #include <core/function_wrappers.hpp>
+#include <core/task_executor_utils.hpp>
 #include <system/system.hpp>
 
+#include "image_stack.hpp"
+
 using std::placeholders::_1;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 
-AnimationGenerator::AnimationGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif):
-    GeneratorUtils::BreakableTask(data.storage, exif),
+AnimationGenerator::AnimationGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif, ITaskExecutor& executor):
+    GeneratorUtils::BreakableTask(data.storage, exif, executor),
     m_data(data),
     m_logger(logger)
 {
@@ -78,57 +80,48 @@ void AnimationGenerator::run()
 
 QStringList AnimationGenerator::stabilize()
 {
-    using GeneratorUtils::AISOutputAnalyzer;
-
-    const int photos_count = m_data.photos.size();
-
-    emit operation(tr("Preparing photos"));
-    emit progress(0);
-    // https://groups.google.com/forum/#!topic/hugin-ptx/gqodoTgAjbI
-    // http://wiki.panotools.org/Panorama_scripting_in_a_nutshell
-    // http://wiki.panotools.org/Align_image_stack
+    std::vector<QImage> photos = loadPhotos(m_data.photos);
+    throwIfCanceled();
 
-    // align_image_stack doesn't respect photo's rotation
-    // generate rotated copies of original images
-    auto dirForRotatedPhotos = System::createTmpDir("AG_rotate", System::Confidential);
-    const QStringList rotated_photos = rotatePhotos(m_data.photos, dirForRotatedPhotos->path());
-
-    AISOutputAnalyzer analyzer(m_logger, photos_count);
-    connect(&analyzer, &AISOutputAnalyzer::operation, this, &AnimationGenerator::operation);
-    connect(&analyzer, &AISOutputAnalyzer::progress,  this, &AnimationGenerator::progress);
-    connect(&analyzer, &AISOutputAnalyzer::finished,  this, &AnimationGenerator::finished);
-
-    // generate aligned files
     emit operation(tr("Stabilizing photos"));
-    const QString output_prefix = m_tmpDir->path() + "/stabilized";
+    emit progress(-1);
 
-    GeneratorUtils::execute(m_logger,
-            m_data.alignImageStackPath,
-            analyzer,
-            m_runner,
-            "-C",
-            "-v",                              // for align_image_stack_output_analizer
-            "--align-to-first",                // use first as base, implies --use-given-order
-            "-d", "-i", "-x", "-y", "-z",
-            "-s", "0",
-            "-a", output_prefix,
-            rotated_photos);
-
-    if (m_runner.getExitCode() != 0)
+    const std::vector<QPoint> offsets = ImageStack::alignTranslations(m_executor, photos);
+    const std::vector<QImage> stabilized = ImageStack::cropToCommonArea(photos, offsets);
+    photos.clear();
+    throwIfCanceled();
+
+    if (stabilized.empty())
     {
-        const QStringList& output = analyzer.tail();
-        throw output;
+        emit error(tr("Photos do not have common part"), m_data.photos);
+        throw false;
     }
 
+    emit operation(tr("Saving stabilized images"));
+
     QStringList stabilized_images;
 
-    const QFileInfo output_prefix_info(output_prefix);
-    QDirIterator filesIterator(output_prefix_info.absolutePath(), {output_prefix_info.fileName() + "*"}, QDir::Files);
+    for (std::size_t i = 0; i < stabilized.size(); i++)
+        stabilized_images.push_back(QString("%1/stabilized%2.tiff").arg(m_tmpDir->path()).arg(i, 4, 10, QChar('0')));
 
-    while(filesIterator.hasNext())
-        stabilized_images.push_back(filesIterator.next());
+    std::atomic<bool> saved = true;
+
+    parallelFor(m_executor, stabilized.size(), [this, &stabilized, &stabilized_images, &saved](std::size_t i)
+    {
+        if (saved == false || isCanceled())
+            return;
 
-    std::sort(stabilized_images.begin(), stabilized_images.end());
+        if (stabilized[i].save(stabilized_images[static_cast<int>(i)]) == false)
+            saved = false;
+    }, "AnimationGenerator");
+
+    throwIfCanceled();
+
+    if (saved == false)
+    {
+        emit error(tr("Could not save stabilized images"), stabilized_images);
+        throw false;
+    }
 
     return stabilized_images;
 }
@@ -37,7 +37,6 @@ class AnimationGenerator: public GeneratorUtils::BreakableTask
         {
             QString storage;
             QString magickPath;
-            QString alignImageStackPath;
             QStringList photos;
             QString format;
             double fps;
@@ -45,10 +44,10 @@ class AnimationGenerator: public GeneratorUtils::BreakableTask
             double scale;
             bool stabilize;
 
-            Data(): storage(), magickPath(), alignImageStackPath(), photos(), fps(0.0), delay(0.0), scale(0.0), stabilize(false) {}
+            Data(): storage(), magickPath(), photos(), fps(0.0), delay(0.0), scale(0.0), stabilize(false) {}
         };
 
-        AnimationGenerator(const Data& data, ILogger *, IExifReaderFactory &);
+        AnimationGenerator(const Data& data, ILogger *, IExifReaderFactory &, ITaskExecutor &);
         AnimationGenerator(const AnimationGenerator &) = delete;
         ~AnimationGenerator();
 
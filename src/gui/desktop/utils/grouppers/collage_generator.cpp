@@ -1,6 +1,10 @@
 
+#include <algorithm>
+#include <mutex>
+
 #include <QPainter>
 #include <core/oriented_image.hpp>
+#include <core/task_executor_utils.hpp>
 
 #include "collage_generator.hpp"
 
@@ -239,12 +243,12 @@ namespace
         return node_rect;
     }
 
-    std::vector<Image> qimagesToImages(const QList<QImage>& qimages)
+    std::vector<Image> sizesToImages(const std::vector<QSize>& sizes)
     {
         std::vector<Image> images;
 
-        for(int i = 0; i < qimages.size(); i++)
-            images.emplace_back(qimages[i].width(), qimages[i].height(), i);
+        for(std::size_t i = 0; i < sizes.size(); i++)
+            images.emplace_back(sizes[i].width(), sizes[i].height(), static_cast<int>(i));
 
         return images;
     }
@@ -273,24 +277,12 @@ namespace
 
         return root;
     }
-
-    QImage generateCollageImage(const QSize& canvas, const QList<QImage>& images_list, const std::vector<QRect>& positions)
-    {
-        QImage image(canvas, QImage::Format_ARGB32);
-        image.fill(Qt::white);
-
-        QPainter painter(&image);
-
-        for(int i = 0; i < images_list.size(); i++)
-            painter.drawImage(positions[i], images_list[i]);
-
-        return image;
-    }
 }
 
 
-CollageGenerator::CollageGenerator(IExifReader& exifReader)
-    : m_exifReader(exifReader)
+CollageGenerator::CollageGenerator(IExifReaderFactory& exifReaderFactory, ITaskExecutor& executor)
+    : m_exifReaderFactory(exifReaderFactory)
+    , m_executor(executor)
 {
 
 }
@@ -298,22 +290,20 @@ CollageGenerator::CollageGenerator(IExifReader& exifReader)
 
 QImage CollageGenerator::generateCollage(const QStringList& paths, int height) const
 {
-    QList<QImage> images;
-    std::transform(paths.begin(), paths.end(), std::back_inserter(images), [this](const auto& path)
+    // Layout is calculated from images' dimensions (known without decoding images).
+    // Then images are loaded in size they will occupy on collage.
+    const std::vector<QSize> sizes = imagesSizes(paths);
+
+    const bool valid = std::all_of(sizes.begin(), sizes.end(), [](const QSize& size)
     {
-        return OrientedImage(m_exifReader, path).get();
+        return size.isEmpty() == false;
     });
 
-    const QImage collage = merge(images, height);
+    if (valid == false || sizes.empty())
+        return {};
 
-    return collage;
-}
-
-
-QImage CollageGenerator::merge(const QList<QImage>& images_list, int height) const
-{
-    // Images will contain indexes identifying QImages from images_list
-    std::vector<Image> images = qimagesToImages(images_list);
+    // Images will contain indexes identifying paths
+    std::vector<Image> images = sizesToImages(sizes);
 
     std::sort(images.begin(), images.end(), [](const Image& lhs, const Image& rhs)
     {
@@ -324,11 +314,56 @@ QImage CollageGenerator::merge(const QList<QImage>& images_list, int height) con
 
     std::vector<QRect> positions;
     const QRect area = calculatePositionsForImages(positions, root.get(), height);
-    assert(positions.size() == images_list.size());
+    assert(positions.size() == sizes.size());
 
     const QImage image = area.isValid()?
-        generateCollageImage(area.size(), images_list, positions):
+        render(paths, area.size(), positions):
         QImage();
 
     return image;
 }
+
+
+std::vector<QSize> CollageGenerator::imagesSizes(const QStringList& paths) const
+{
+    std::vector<QSize> sizes(paths.size());
+
+    parallelFor(m_executor, sizes.size(), [this, &paths, &sizes](std::size_t i)
+    {
+        const auto exif_lease = m_exifReaderFactory.checkout();
+
+        sizes[i] = OrientedImage::size(*exif_lease, paths[static_cast<int>(i)]);
+    }, "CollageGenerator");
+
+    return sizes;
+}
+
+
+QImage CollageGenerator::render(const QStringList& paths, const QSize& canvas, const std::vector<QRect>& positions) const
+{
+    QImage image(canvas, QImage::Format_RGB32);
+
+    if (image.isNull())         // too big
+        return {};
+
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    std::mutex painterMutex;
+
+    // images are decoded directly in size of their tiles and painted as soon as they are ready,
+    // so no more tiles than executor's workers are kept in memory
+    parallelFor(m_executor, positions.size(), [this, &paths, &positions, &painter, &painterMutex](std::size_t i)
+    {
+        if (positions[i].isEmpty())
+            return;
+
+        const auto exif_lease = m_exifReaderFactory.checkout();
+        const QImage tile = OrientedImage(*exif_lease, paths[static_cast<int>(i)], positions[i].size()).get();
+
+        std::lock_guard<std::mutex> lock(painterMutex);
+        painter.drawImage(positions[i], tile);
+    }, "CollageGenerator");
+
+    return image;
+}
@@ -2,22 +2,28 @@
 #ifndef COLLAGEGENERATOR_HPP
 #define COLLAGEGENERATOR_HPP
 
+#include <vector>
+
+#include <QImage>
 #include <QStringList>
 
 #include <core/iexif_reader.hpp>
+#include <core/itask_executor.hpp>
 
 
 class CollageGenerator
 {
     public:
-        CollageGenerator(IExifReader &);
+        CollageGenerator(IExifReaderFactory &, ITaskExecutor &);
 
         QImage generateCollage(const QStringList& paths, int height) const;
 
     private:
-        IExifReader& m_exifReader;
+        IExifReaderFactory& m_exifReaderFactory;
+        ITaskExecutor& m_executor;
 
-        QImage merge(const QList<QImage> &, int height) const;
+        std::vector<QSize> imagesSizes(const QStringList& paths) const;
+        QImage render(const QStringList& paths, const QSize& canvas, const std::vector<QRect>& positions) const;
 };
 
 #endif
@@ -22,7 +22,8 @@
 #include <QRegularExpression>
 
 #include <core/iexif_reader.hpp>
-#include <core/image_tools.hpp>
+#include <core/oriented_image.hpp>
+#include <core/task_executor_utils.hpp>
 #include <system/system.hpp>
 
 
@@ -31,10 +32,6 @@ namespace
     const QRegularExpression loadImages_regExp(R"(^Load\/Image\/.*100% complete.*)");
     const QRegularExpression mogrify_regExp(R"(^Mogrify\/Image\/.*)");
     const QRegularExpression dither_regExp(R"(^Dither\/Image\/.*100% complete.*)");
-
-    const QRegularExpression cp_regExp("^(?:Creating control points between|Optimizing Variables).*");
-    const QRegularExpression run_regExp("^Run called.*");
-    const QRegularExpression remapping_regExp("^remapping.*");
 }
 
 namespace GeneratorUtils
@@ -130,52 +127,6 @@ namespace GeneratorUtils
     ///////////////////////////////////////////////////////////////////////////
 
 
-    AISOutputAnalyzer::AISOutputAnalyzer(ILogger* logger, int photos_count):
-        GenericAnalyzer(logger, 10),
-        m_photos_count(photos_count)
-    {
-        stabilization_data.stabilization_steps =  photos_count - 1 // there will be n-1 control points groups
-                                                  + 4;             // and 4 optimization steps
-    }
-
-
-    void AISOutputAnalyzer::processMessage(const QString& line)
-    {
-        switch (stabilization_data.state)
-        {
-            case Data::StabilizingImages:
-                if (cp_regExp.match(line).hasMatch())
-                {
-                    stabilization_data.stabilization_step++;
-
-                    emit progress( stabilization_data.stabilization_step * 100 /
-                                   stabilization_data.stabilization_steps);
-                }
-                else if (run_regExp.match(line).hasMatch())
-                {
-                    stabilization_data.state = stabilization_data.SavingImages;
-
-                    emit operation(tr("Saving stabilized images"));
-                }
-
-                break;
-
-            case Data::SavingImages:
-                if (remapping_regExp.match(line).hasMatch())
-                {
-                    stabilization_data.photos_saved++;
-
-                    emit progress( stabilization_data.photos_saved * 100 / m_photos_count );
-                }
-
-                break;
-        }
-    }
-
-
-    ///////////////////////////////////////////////////////////////////////////
-
-
     ProcessRunner::ProcessRunner(): m_work(true)
     {
     }
@@ -223,12 +174,14 @@ namespace GeneratorUtils
     ///////////////////////////////////////////////////////////////////////////
 
 
-    BreakableTask::BreakableTask(const QString& storage, IExifReaderFactory& exif):
+    BreakableTask::BreakableTask(const QString& storage, IExifReaderFactory& exif, ITaskExecutor& executor):
         QObject(),
         m_tmpDir(System::createTmpDir("BT_tmp", System::Confidential)),
         m_storage(storage),
         m_runner(),
-        m_exif(exif)
+        m_exif(exif),
+        m_executor(executor),
+        m_canceled(false)
     {
         connect(this, &BreakableTask::canceled,
                 &m_runner, &GeneratorUtils::ProcessRunner::cancel);
@@ -255,39 +208,49 @@ namespace GeneratorUtils
 
     void BreakableTask::cancel()
     {
+        m_canceled = true;
+
         emit canceled();
     }
 
 
-    QStringList BreakableTask::rotatePhotos(const QStringList& photos,
-                                            const QString& storage)
+    std::vector<QImage> BreakableTask::loadPhotos(const QStringList& photos)
     {
-        emit operation(tr("Preparing photos"));
+        emit operation(tr("Loading photos"));
         emit progress(0);
 
-        IExifReader& exif = m_exif.get();
-
-        int photo_index = 0;
-        QStringList rotated_photos;
-
         const int p_s = photos.size();
+        std::vector<QImage> images(static_cast<std::size_t>(p_s));
+        std::atomic<int> loaded = 0;
 
-        for (int i = 0; i < p_s; i++)
+        // number of photos decoded at the same time is limited by number of workers
+        parallelFor(m_executor, images.size(), [this, &photos, &images, &loaded, p_s](std::size_t i)
         {
-            const QString& photo = photos[i];
-            const QString location = QString("%1/%2.tiff")
-                                    .arg(storage)
-                                    .arg(photo_index);
+            if (isCanceled())
+                return;
 
-            Image::normalize(photo, location, exif);
+            const auto exif_lease = m_exif.checkout();
+            images[i] = OrientedImage(*exif_lease, photos[static_cast<int>(i)]).get();
 
-            rotated_photos << location;
-            photo_index++;
+            emit progress( ++loaded * 100 / p_s );
+        }, "BreakableTask");
+
+        throwIfCanceled();
+
+        return images;
+    }
+
+
+    bool BreakableTask::isCanceled() const
+    {
+        return m_canceled;
+    }
 
-            emit progress( (i + 1) * 100 /p_s );
-        }
 
-        return rotated_photos;
+    void BreakableTask::throwIfCanceled() const
+    {
+        if (isCanceled())
+            throw false;
     }
 
 }
@@ -19,8 +19,11 @@
 #ifndef GENERATORUTILS_HPP
 #define GENERATORUTILS_HPP
 
+#include <atomic>
 #include <functional>
+#include <vector>
 
+#include <QImage>
 #include <QProcess>
 #include <QStringList>
 
@@ -130,33 +133,6 @@ namespace GeneratorUtils
     };
 
 
-    class AISOutputAnalyzer: public GenericAnalyzer
-    {
-            Q_OBJECT
-
-        public:
-            AISOutputAnalyzer(ILogger* logger, int photos_count);
-
-            void processMessage(const QString &) override;
-
-        private:
-            struct Data
-            {
-                int stabilization_steps = 0;
-                int stabilization_step = 0;
-                int photos_saved = 0;
-
-                enum
-                {
-                    StabilizingImages,
-                    SavingImages,
-                } state = StabilizingImages;
-            } stabilization_data;
-
-            const int m_photos_count;
-    };
-
-
     class ProcessRunner: public QObject
     {
             Q_OBJECT
@@ -185,7 +161,7 @@ namespace GeneratorUtils
             Q_OBJECT
 
         public:
-            BreakableTask(const QString& storage, IExifReaderFactory &);
+            BreakableTask(const QString& storage, IExifReaderFactory &, ITaskExecutor &);
             virtual ~BreakableTask();
 
             void perform() override final;
@@ -196,10 +172,16 @@ namespace GeneratorUtils
             const QString m_storage;
             ProcessRunner m_runner;
             IExifReaderFactory& m_exif;
+            ITaskExecutor& m_executor;
 
             virtual void run() = 0;
 
-            QStringList rotatePhotos(const QStringList& photos, const QString& storage);
+            std::vector<QImage> loadPhotos(const QStringList& photos);       // load photos (with rotation applied) with executor's heavy workers
+            bool isCanceled() const;
+            void throwIfCanceled() const;                                    // throws `bool` if task was cancelled
+
+        private:
+            std::atomic<bool> m_canceled;
 
         signals:
             void operation(const QString &) const;
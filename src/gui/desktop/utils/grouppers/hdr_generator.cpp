@@ -18,11 +18,14 @@
 
 #include "hdr_generator.hpp"
 
+#include <algorithm>
+
 #include "system/system.hpp"
+#include "image_stack.hpp"
 
 
-HDRGenerator::HDRGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif):
-    GeneratorUtils::BreakableTask(data.storage, exif),
+HDRGenerator::HDRGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif, ITaskExecutor& executor):
+    GeneratorUtils::BreakableTask(data.storage, exif, executor),
     m_data(data),
     m_logger(logger)
 {
@@ -37,49 +40,52 @@ std::string HDRGenerator::name() const
 
 void HDRGenerator::run()
 {
-    using GeneratorUtils::AISOutputAnalyzer;
-    using GeneratorUtils::MagickOutputAnalyzer;
+    // photos are aligned and fused in memory, no external tools are involved
+    std::vector<QImage> aligned;
 
-    // rotate photos
-    const QStringList rotated = rotatePhotos(m_data.photos, m_tmpDir->path());
+    {
+        const std::vector<QImage> photos = loadPhotos(m_data.photos);
+        throwIfCanceled();
 
-    // blend them!
-    const int photos_count = m_data.photos.size();
-    AISOutputAnalyzer analyzer(m_logger, photos_count);
-    connect(&analyzer, &AISOutputAnalyzer::operation, this, &HDRGenerator::operation);
-    connect(&analyzer, &AISOutputAnalyzer::progress,  this, &HDRGenerator::progress);
-    connect(&analyzer, &AISOutputAnalyzer::finished,  this, &HDRGenerator::finished);
+        const bool loaded = std::none_of(photos.begin(), photos.end(), [](const QImage& photo)
+        {
+            return photo.isNull();
+        });
 
-    emit operation(tr("generating HDR"));
-    const QString location = System::getTmpFile(m_storage, "hdr");
-
-    GeneratorUtils::execute(m_logger,
-            m_data.alignImageStackPath,
-            analyzer,
-            m_runner,
-            "-C",
-            "-v",                              // for align_image_stack_output_analizer
-            "-d", "-i", "-x", "-y", "-z",
-            "-s", "0",
-            "-o", location,
-            rotated);
+        if (loaded == false)
+        {
+            emit error(tr("Could not load photos"), m_data.photos);
+            return;
+        }
 
-    const QString output = System::getTmpFile(m_storage, "jpeg");
-    MagickOutputAnalyzer moa(m_logger, photos_count);
-    connect(&moa, &MagickOutputAnalyzer::operation, this, &HDRGenerator::operation);
-    connect(&moa, &MagickOutputAnalyzer::progress,  this, &HDRGenerator::progress);
-    connect(&moa, &MagickOutputAnalyzer::finished,  this, &HDRGenerator::finished);
+        emit operation(tr("Aligning photos"));
+        emit progress(-1);
 
-    emit operation(tr("Saving result"));
+        const std::vector<QPoint> offsets = ImageStack::alignTranslations(m_executor, photos);
+
+        for (std::size_t i = 0; i < offsets.size(); i++)
+            m_logger->debug(QString("Photo %1 shifted by (%2, %3)").arg(m_data.photos[i]).arg(offsets[i].x()).arg(offsets[i].y()));
+
+        aligned = ImageStack::cropToCommonArea(photos, offsets);
+        throwIfCanceled();
+    }
 
-    GeneratorUtils::execute(m_logger,
-            m_data.magickPath,
-            moa,
-            m_runner,
-            "convert",
-            "-monitor",                                      // for convert_output_analizer
-            location,
-            output);
+    if (aligned.empty())
+    {
+        emit error(tr("Photos do not have common part"), m_data.photos);
+        return;
+    }
+
+    emit operation(tr("generating HDR"));
+    const QImage hdr = ImageStack::fuseExposures(m_executor, aligned);
+    aligned.clear();
+    throwIfCanceled();
+
+    emit operation(tr("Saving result"));
+    const QString output = System::getTmpFile(m_storage, "jpeg");
 
-    emit finished(output);
+    if (hdr.save(output))
+        emit finished(output);
+    else
+        emit error(tr("Could not save result"), {output});
 }
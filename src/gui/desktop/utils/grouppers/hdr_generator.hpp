@@ -29,14 +29,12 @@ class HDRGenerator: public GeneratorUtils::BreakableTask
         struct Data
         {
             QString storage;
-            QString magickPath;
-            QString alignImageStackPath;
             QStringList photos;
 
-            Data(): storage(), magickPath(), alignImageStackPath(), photos() {}
+            Data(): storage(), photos() {}
         };
 
-        HDRGenerator(const Data& photos, ILogger *, IExifReaderFactory &);
+        HDRGenerator(const Data& photos, ILogger *, IExifReaderFactory &, ITaskExecutor &);
 
         std::string name() const override;
         void run() override;
@@ -0,0 +1,673 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "image_stack.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <QRect>
+
+#include <core/task_executor_utils.hpp>
+
+// materials:
+// http://www.anyhere.com/gward/papers/jgtpap2.pdf
+// https://mericam.github.io/papers/exposure_fusion_reduced.pdf
+
+
+namespace
+{
+    constexpr int MaxAlignmentLevels = 6;           // largest detectable shift is 2^6 - 1 pixels
+    constexpr int MinAlignmentSize = 32;
+    constexpr int ExclusionRange = 4;               // pixels this close to median are too noisy to be compared
+    constexpr int MinFusionSize = 8;
+    constexpr float WellExposedSigma = 0.2f;
+
+
+    // 8 bit single channel image used for alignment
+    struct Bitmap
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint8_t> pixels;
+
+        Bitmap() = default;
+
+        Bitmap(int w, int h)
+            : width(w)
+            , height(h)
+            , pixels(static_cast<std::size_t>(w) * h, 0)
+        {
+
+        }
+
+        std::uint8_t* row(int y)
+        {
+            return pixels.data() + static_cast<std::size_t>(y) * width;
+        }
+
+        const std::uint8_t* row(int y) const
+        {
+            return pixels.data() + static_cast<std::size_t>(y) * width;
+        }
+    };
+
+
+    // floating point single channel image used for fusion
+    struct Plane
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<float> pixels;
+
+        Plane() = default;
+
+        Plane(int w, int h)
+            : width(w)
+            , height(h)
+            , pixels(static_cast<std::size_t>(w) * h, 0.0f)
+        {
+
+        }
+
+        float* row(int y)
+        {
+            return pixels.data() + static_cast<std::size_t>(y) * width;
+        }
+
+        const float* row(int y) const
+        {
+            return pixels.data() + static_cast<std::size_t>(y) * width;
+        }
+    };
+
+
+    // split rows into bands and process them with executor's heavy workers
+    template<typename F>
+    void forEachRowsBand(ITaskExecutor& executor, int rows, F&& op)
+    {
+        const int workers = std::max(1, executor.heavyWorkers());
+        const int band = std::max(1, (rows + workers - 1) / workers);
+        const int bands = (rows + band - 1) / band;
+
+        parallelFor(executor, static_cast<std::size_t>(bands), [&op, band, rows](std::size_t i)
+        {
+            const int first = static_cast<int>(i) * band;
+
+            op(first, std::min(rows, first + band));
+        }, "ImageStack");
+    }
+
+
+    int luminance(QRgb rgb)
+    {
+        return (qRed(rgb) * 54 + qGreen(rgb) * 183 + qBlue(rgb) * 19) >> 8;
+    }
+
+
+    const QRgb* line(const QImage& image, int y)
+    {
+        return reinterpret_cast<const QRgb *>(image.constScanLine(y));
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // alignment
+
+    Bitmap grayscale(const QImage& image)
+    {
+        const QImage rgb = image.convertToFormat(QImage::Format_RGB32);
+        Bitmap gray(rgb.width(), rgb.height());
+
+        for (int y = 0; y < gray.height; y++)
+        {
+            const QRgb* in = line(rgb, y);
+            std::uint8_t* out = gray.row(y);
+
+            for (int x = 0; x < gray.width; x++)
+                out[x] = static_cast<std::uint8_t>(luminance(in[x]));
+        }
+
+        return gray;
+    }
+
+
+    Bitmap shrink(const Bitmap& src)
+    {
+        Bitmap dst(src.width / 2, src.height / 2);
+
+        for (int y = 0; y < dst.height; y++)
+        {
+            const std::uint8_t* top = src.row(y * 2);
+            const std::uint8_t* bottom = src.row(y * 2 + 1);
+            std::uint8_t* out = dst.row(y);
+
+            for (int x = 0; x < dst.width; x++)
+                out[x] = static_cast<std::uint8_t>((top[x * 2] + top[x * 2 + 1] + bottom[x * 2] + bottom[x * 2 + 1] + 2) / 4);
+        }
+
+        return dst;
+    }
+
+
+    // bit 0 - pixel is brighter than median, bit 1 - pixel is far enough from median to be compared
+    Bitmap thresholdBitmap(const Bitmap& gray)
+    {
+        std::array<std::size_t, 256> histogram = {};
+
+        for (const std::uint8_t pixel: gray.pixels)
+            histogram[pixel]++;
+
+        const std::size_t half = gray.pixels.size() / 2;
+        std::size_t count = histogram[0];
+        int median = 0;
+
+        while (count <= half && median < 255)
+            count += histogram[++median];
+
+        Bitmap bitmap(gray.width, gray.height);
+        std::transform(gray.pixels.begin(), gray.pixels.end(), bitmap.pixels.begin(), [median](std::uint8_t pixel)
+        {
+            const int above = pixel > median? 1: 0;
+            const int distinct = std::abs(pixel - median) > ExclusionRange? 2: 0;
+
+            return static_cast<std::uint8_t>(above | distinct);
+        });
+
+        return bitmap;
+    }
+
+
+    std::vector<Bitmap> alignmentPyramid(const QImage& image, int levels)
+    {
+        std::vector<Bitmap> pyramid;
+        Bitmap gray = grayscale(image);
+
+        for (int level = 0; level < levels; level++)
+        {
+            pyramid.push_back(thresholdBitmap(gray));
+
+            if (level + 1 < levels)
+                gray = shrink(gray);
+        }
+
+        return pyramid;
+    }
+
+
+    // Number of differing pixels when reference's pixel (x, y) is compared with image's (x + shift.x, y + shift.y).
+    // First value skips pixels close to median, second one counts all of them and is used to break ties
+    // (pixels near median are noisy but they are the only source of information for shifts smaller than exclusion range).
+    std::pair<std::size_t, std::size_t> differences(const Bitmap& reference, const Bitmap& image, const QPoint& shift)
+    {
+        const int x0 = std::max(0, -shift.x());
+        const int x1 = std::min(reference.width, image.width - shift.x());
+        const int y0 = std::max(0, -shift.y());
+        const int y1 = std::min(reference.height, image.height - shift.y());
+
+        if (x0 >= x1 || y0 >= y1)
+            return { std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() };
+
+        std::size_t distinct = 0;
+        std::size_t all = 0;
+
+        for (int y = y0; y < y1; y++)
+        {
+            const std::uint8_t* ref = reference.row(y);
+            const std::uint8_t* img = image.row(y + shift.y()) + shift.x();
+
+            for (int x = x0; x < x1; x++)
+            {
+                const int diff = (ref[x] ^ img[x]) & 1;
+
+                distinct += diff & (ref[x] >> 1) & (img[x] >> 1);
+                all += diff;
+            }
+        }
+
+        return { distinct, all };
+    }
+
+
+    QPoint findTranslation(const std::vector<Bitmap>& reference, const std::vector<Bitmap>& image)
+    {
+        assert(reference.size() == image.size());
+
+        QPoint shift(0, 0);
+
+        // start with the smallest images and refine result on bigger ones
+        for (auto level = static_cast<int>(reference.size()) - 1; level >= 0; level--)
+        {
+            shift *= 2;
+
+            QPoint best = shift;
+            std::pair<std::size_t, std::size_t> bestDiff(std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max());
+
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    const QPoint candidate = shift + QPoint(dx, dy);
+                    const auto diff = differences(reference[level], image[level], candidate);
+
+                    if (diff < bestDiff)
+                    {
+                        bestDiff = diff;
+                        best = candidate;
+                    }
+                }
+
+            shift = best;
+        }
+
+        return shift;
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // fusion
+
+    float wellExposed(float value)
+    {
+        const float d = value - 0.5f;
+
+        return std::exp(-(d * d) / (2.0f * WellExposedSigma * WellExposedSigma));
+    }
+
+
+    // weights of one row of pixels according to Mertens' quality measures
+    void qualityWeights(const QImage& image, int y, float* weights)
+    {
+        const int width = image.width();
+        const QRgb* above = line(image, std::max(y - 1, 0));
+        const QRgb* current = line(image, y);
+        const QRgb* below = line(image, std::min(y + 1, image.height() - 1));
+
+        for (int x = 0; x < width; x++)
+        {
+            const QRgb pixel = current[x];
+
+            const int laplacian = 4 * luminance(pixel)
+                                - luminance(current[std::max(x - 1, 0)])
+                                - luminance(current[std::min(x + 1, width - 1)])
+                                - luminance(above[x])
+                                - luminance(below[x]);
+
+            const float r = static_cast<float>(qRed(pixel)) / 255.0f;
+            const float g = static_cast<float>(qGreen(pixel)) / 255.0f;
+            const float b = static_cast<float>(qBlue(pixel)) / 255.0f;
+            const float mean = (r + g + b) / 3.0f;
+
+            const float contrast = static_cast<float>(std::abs(laplacian)) / 255.0f;
+            const float saturation = std::sqrt(((r - mean) * (r - mean) + (g - mean) * (g - mean) + (b - mean) * (b - mean)) / 3.0f);
+            const float exposedness = wellExposed(r) * wellExposed(g) * wellExposed(b);
+
+            // small constant keeps pixels which are bad on all photos from having zero total weight
+            weights[x] = contrast * saturation * exposedness + 1e-12f;
+        }
+    }
+
+
+    Plane channel(const QImage& image, int c)
+    {
+        const int shift = 16 - c * 8;           // red, green, blue
+        Plane plane(image.width(), image.height());
+
+        for (int y = 0; y < plane.height; y++)
+        {
+            const QRgb* in = line(image, y);
+            float* out = plane.row(y);
+
+            for (int x = 0; x < plane.width; x++)
+                out[x] = static_cast<float>((in[x] >> shift) & 0xff) / 255.0f;
+        }
+
+        return plane;
+    }
+
+
+    // blur with 5-tap binomial filter and halve resolution
+    Plane reduce(const Plane& src)
+    {
+        constexpr std::array<float, 5> kernel = {1.0f/16, 4.0f/16, 6.0f/16, 4.0f/16, 1.0f/16};
+
+        const int width = (src.width + 1) / 2;
+        const int height = (src.height + 1) / 2;
+
+        Plane horizontal(width, src.height);
+
+        for (int y = 0; y < src.height; y++)
+        {
+            const float* in = src.row(y);
+            float* out = horizontal.row(y);
+
+            for (int x = 0; x < width; x++)
+            {
+                float sum = 0.0f;
+
+                for (int k = -2; k <= 2; k++)
+                    sum += kernel[k + 2] * in[std::clamp(x * 2 + k, 0, src.width - 1)];
+
+                out[x] = sum;
+            }
+        }
+
+        Plane result(width, height);
+
+        for (int y = 0; y < height; y++)
+        {
+            float* out = result.row(y);
+
+            for (int k = -2; k <= 2; k++)
+            {
+                const float* in = horizontal.row(std::clamp(y * 2 + k, 0, src.height - 1));
+
+                for (int x = 0; x < width; x++)
+                    out[x] += kernel[k + 2] * in[x];
+            }
+        }
+
+        return result;
+    }
+
+
+    // scale up to given size with bilinear interpolation (inverse of reduce's sampling)
+    Plane expand(const Plane& src, int width, int height)
+    {
+        struct Sample
+        {
+            int first;
+            int second;
+            float fraction;
+        };
+
+        auto sample = [](int pos, int size)
+        {
+            const float exact = std::min(static_cast<float>(pos) / 2.0f, static_cast<float>(size - 1));
+            const int first = static_cast<int>(exact);
+
+            return Sample{first, std::min(first + 1, size - 1), exact - static_cast<float>(first)};
+        };
+
+        std::vector<Sample> columns;
+        columns.reserve(width);
+
+        for (int x = 0; x < width; x++)
+            columns.push_back(sample(x, src.width));
+
+        Plane result(width, height);
+
+        for (int y = 0; y < height; y++)
+        {
+            const Sample r = sample(y, src.height);
+            const float* top = src.row(r.first);
+            const float* bottom = src.row(r.second);
+            float* out = result.row(y);
+
+            for (int x = 0; x < width; x++)
+            {
+                const Sample& c = columns[x];
+                const float t = top[c.first] + (top[c.second] - top[c.first]) * c.fraction;
+                const float b = bottom[c.first] + (bottom[c.second] - bottom[c.first]) * c.fraction;
+
+                out[x] = t + (b - t) * r.fraction;
+            }
+        }
+
+        return result;
+    }
+
+
+    std::vector<Plane> gaussianPyramid(Plane base, int levels)
+    {
+        std::vector<Plane> pyramid;
+        pyramid.reserve(levels);
+        pyramid.push_back(std::move(base));
+
+        for (int level = 1; level < levels; level++)
+            pyramid.push_back(reduce(pyramid.back()));
+
+        return pyramid;
+    }
+
+
+    // build laplacian pyramid of channel level by level (to keep memory usage low)
+    // and add it to result weighted by given weights
+    void blend(Plane current, const std::vector<Plane>& weights, std::vector<Plane>& result)
+    {
+        const std::size_t levels = weights.size();
+
+        for (std::size_t level = 0; level < levels; level++)
+        {
+            Plane next;
+
+            if (level + 1 < levels)
+            {
+                next = reduce(current);
+                const Plane expanded = expand(next, current.width, current.height);
+
+                std::transform(current.pixels.begin(), current.pixels.end(), expanded.pixels.begin(), current.pixels.begin(), std::minus<float>());
+            }
+
+            const std::vector<float>& w = weights[level].pixels;
+            std::vector<float>& out = result[level].pixels;
+
+            for (std::size_t i = 0; i < out.size(); i++)
+                out[i] += w[i] * current.pixels[i];
+
+            current = std::move(next);
+        }
+    }
+
+
+    Plane collapse(std::vector<Plane>& pyramid)
+    {
+        Plane result = std::move(pyramid.back());
+
+        for (auto level = static_cast<int>(pyramid.size()) - 2; level >= 0; level--)
+        {
+            Plane expanded = expand(result, pyramid[level].width, pyramid[level].height);
+
+            std::transform(expanded.pixels.begin(), expanded.pixels.end(), pyramid[level].pixels.begin(), expanded.pixels.begin(), std::plus<float>());
+
+            result = std::move(expanded);
+            pyramid[level] = Plane();
+        }
+
+        return result;
+    }
+}
+
+
+namespace ImageStack
+{
+    std::vector<QPoint> alignTranslations(ITaskExecutor& executor, const std::vector<QImage>& images)
+    {
+        if (images.empty())
+            return {};
+
+        const QImage& first = images.front();
+        int levels = 1;
+
+        while (levels < MaxAlignmentLevels && (std::min(first.width(), first.height()) >> levels) >= MinAlignmentSize)
+            levels++;
+
+        const std::vector<Bitmap> reference = alignmentPyramid(first, levels);
+
+        std::vector<QPoint> offsets(images.size(), QPoint(0, 0));
+
+        parallelFor(executor, images.size() - 1, [&reference, &images, &offsets, levels](std::size_t i)
+        {
+            offsets[i + 1] = findTranslation(reference, alignmentPyramid(images[i + 1], levels));
+        }, "ImageStack");
+
+        return offsets;
+    }
+
+
+    std::vector<QImage> cropToCommonArea(const std::vector<QImage>& images, const std::vector<QPoint>& offsets)
+    {
+        assert(images.size() == offsets.size());
+
+        if (images.empty())
+            return {};
+
+        int left = 0;
+        int top = 0;
+        int right = images.front().width();
+        int bottom = images.front().height();
+
+        for (std::size_t i = 0; i < images.size(); i++)
+        {
+            left = std::max(left, -offsets[i].x());
+            top = std::max(top, -offsets[i].y());
+            right = std::min(right, images[i].width() - offsets[i].x());
+            bottom = std::min(bottom, images[i].height() - offsets[i].y());
+        }
+
+        std::vector<QImage> cropped;
+
+        if (left < right && top < bottom)
+            for (std::size_t i = 0; i < images.size(); i++)
+                cropped.push_back(images[i].copy(QRect(left + offsets[i].x(), top + offsets[i].y(), right - left, bottom - top)));
+
+        return cropped;
+    }
+
+
+    QImage fuseExposures(ITaskExecutor& executor, const std::vector<QImage>& images)
+    {
+        if (images.empty())
+            return {};
+
+        const int width = images.front().width();
+        const int height = images.front().height();
+
+        std::vector<QImage> rgbs;
+        rgbs.reserve(images.size());
+
+        for (const QImage& image: images)
+        {
+            assert(image.width() == width && image.height() == height);
+            rgbs.push_back(image.convertToFormat(QImage::Format_RGB32));
+        }
+
+        int levels = 1;
+
+        for (int size = std::min(width, height); size / 2 >= MinFusionSize; size = (size + 1) / 2)
+            levels++;
+
+        // sum of weights of all photos, used for weights normalization
+        Plane weightsSum(width, height);
+
+        forEachRowsBand(executor, height, [&rgbs, &weightsSum, width](int first, int last)
+        {
+            std::vector<float> weights(width);
+
+            for (int y = first; y < last; y++)
+            {
+                float* sum = weightsSum.row(y);
+
+                for (const QImage& image: rgbs)
+                {
+                    qualityWeights(image, y, weights.data());
+                    std::transform(weights.begin(), weights.end(), sum, sum, std::plus<float>());
+                }
+            }
+        });
+
+        // laplacian pyramid of result for each channel
+        std::array<std::vector<Plane>, 3> blended;
+
+        for (auto& pyramid: blended)
+        {
+            int w = width;
+            int h = height;
+
+            for (int level = 0; level < levels; level++)
+            {
+                pyramid.emplace_back(w, h);
+                w = (w + 1) / 2;
+                h = (h + 1) / 2;
+            }
+        }
+
+        // blend in photos one by one so only one photo's pyramids are kept in memory
+        for (const QImage& image: rgbs)
+        {
+            Plane weights(width, height);
+
+            forEachRowsBand(executor, height, [&image, &weights, &weightsSum](int first, int last)
+            {
+                for (int y = first; y < last; y++)
+                {
+                    float* w = weights.row(y);
+                    const float* sum = weightsSum.row(y);
+
+                    qualityWeights(image, y, w);
+                    std::transform(w, w + weights.width, sum, w, std::divides<float>());
+                }
+            });
+
+            const std::vector<Plane> weightsPyramid = gaussianPyramid(std::move(weights), levels);
+
+            parallelFor(executor, blended.size(), [&image, &weightsPyramid, &blended](std::size_t c)
+            {
+                blend(channel(image, static_cast<int>(c)), weightsPyramid, blended[c]);
+            }, "ImageStack");
+        }
+
+        std::array<Plane, 3> result;
+
+        parallelFor(executor, blended.size(), [&blended, &result](std::size_t c)
+        {
+            result[c] = collapse(blended[c]);
+        }, "ImageStack");
+
+        QImage fused(width, height, QImage::Format_RGB32);
+
+        uchar* bits = fused.bits();
+        const qsizetype bytesPerLine = fused.bytesPerLine();
+
+        forEachRowsBand(executor, height, [bits, bytesPerLine, &result, width](int first, int last)
+        {
+            auto toByte = [](float value)
+            {
+                return static_cast<int>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+            };
+
+            for (int y = first; y < last; y++)
+            {
+                QRgb* out = reinterpret_cast<QRgb *>(bits + y * bytesPerLine);
+                const float* r = result[0].row(y);
+                const float* g = result[1].row(y);
+                const float* b = result[2].row(y);
+
+                for (int x = 0; x < width; x++)
+                    out[x] = qRgb(toByte(r[x]), toByte(g[x]), toByte(b[x]));
+            }
+        });
+
+        return fused;
+    }
+}
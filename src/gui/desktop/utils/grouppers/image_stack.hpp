@@ -0,0 +1,64 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IMAGE_STACK_HPP_INCLUDED
+#define IMAGE_STACK_HPP_INCLUDED
+
+#include <vector>
+
+#include <QImage>
+#include <QPoint>
+
+struct ITaskExecutor;
+
+
+/**
+ * \brief in-memory operations on stacks of photos of the same scene
+ */
+namespace ImageStack
+{
+    /**
+     * \brief find translations aligning photos to the first one
+     *
+     * Uses median threshold bitmaps (Ward's method) which are insensitive to exposure differences,
+     * so bracketed photos can be aligned as well as photos shot with the same exposure.
+     * Photos are analyzed with executor's heavy workers.
+     * \return offset of each photo's content relative to the first photo (first offset is always (0, 0))
+     */
+    std::vector<QPoint> alignTranslations(ITaskExecutor &, const std::vector<QImage> &);
+
+    /**
+     * \brief cut translated photos to the area visible on all of them
+     * \param images photos to be cut
+     * \param offsets offsets returned by alignTranslations()
+     * \return cut photos of equal size or empty list when there is no area common for all photos
+     */
+    std::vector<QImage> cropToCommonArea(const std::vector<QImage>& images, const std::vector<QPoint>& offsets);
+
+    /**
+     * \brief merge differently exposed photos into one (exposure fusion by Mertens et al.)
+     *
+     * All photos are expected to be aligned and of the same size.
+     * Each photo is blended in with pyramid of weights built from its contrast, saturation and well-exposedness.
+     * Calculations are split between executor's heavy workers.
+     */
+    QImage fuseExposures(ITaskExecutor &, const std::vector<QImage> &);
+}
+
+#endif
@@ -39,6 +39,7 @@ QString GroupsManager::copyRepresentatToDatabase(const QString& representativePh
 
 void GroupsManager::groupIntoCollage(
     IExifReaderFactory& exifFactory,
+    ITaskExecutor& executor,
     Project& project,
     const std::vector<Photo::Data>& photos)
 {
@@ -50,7 +51,7 @@ void GroupsManager::groupIntoCollage(
         return lhs.geometry.height() < rhs.geometry.height();
     });
 
-    CollageGenerator generator(exifFactory.get());
+    CollageGenerator generator(exifFactory, executor);
     const auto collage = generator.generateCollage(paths, highest.geometry.height());
 
     auto tmpDir = System::createTmpDir("CollageGenerator", System::BigFiles | System::Confidential);
@@ -20,6 +20,7 @@
 #define GROUPS_MANAGER_HPP
 
 #include <core/iexif_reader.hpp>
+#include <core/itask_executor.hpp>
 #include <database/photo_data.hpp>
 #include <database/group.hpp>
 #include <project_utils/project.hpp>
@@ -36,6 +37,7 @@ namespace GroupsManager
     QString copyRepresentatToDatabase(const QString& representativePhoto, Project &);
 
     void groupIntoCollage(IExifReaderFactory &,
+                          ITaskExecutor &,
                           Project &,
                           const std::vector<Photo::Data> &);
 
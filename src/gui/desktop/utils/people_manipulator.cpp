@@ -23,6 +23,7 @@
 #include <core/icore_factory_accessor.hpp>
 #include <core/iexif_reader.hpp>
 #include <core/task_executor_utils.hpp>
+#include <database/general_flags.hpp>
 #include <database/ibackend.hpp>
 #include <database/database_executor_traits.hpp>
 #include <face_recognition/face_recognition.hpp>
@@ -30,8 +31,6 @@
 
 namespace
 {
-    const QString faces_recognized_flag = QStringLiteral("faces_recognized");
-
     Person::Fingerprint average_fingerprint(const std::vector<PersonFingerprint>& faces)
     {
         if (faces.empty())
@@ -230,15 +229,25 @@ void PeopleManipulator::recognizeFaces_thrd_fetch_from_db()
 
 void PeopleManipulator::recognizeFaces_thrd_calculate_missing_fingerprints()
 {
+    std::vector<FaceInfo*> missing;
+    QVector<QRect> rects;
+
     for (FaceInfo& faceInfo: m_faces)
         if (faceInfo.fingerprint.id().valid() == false)
         {
-            FaceRecognition face_recognition(&m_core);
+            missing.push_back(&faceInfo);
+            rects.push_back(faceInfo.face.rect);
+        }
 
-            const auto fingerprint = face_recognition.getFingerprint(m_image, faceInfo.face.rect);
+    FaceRecognition face_recognition(&m_core);
+    const auto fingerprints = face_recognition.getFingerprints(m_image, rects);
 
-            faceInfo.fingerprint = fingerprint;
-        }
+    // leave fingerprints missing when they could not be calculated
+    if (fingerprints.size() != missing.size())
+        return;
+
+    for (std::size_t i = 0; i < missing.size(); i++)
+        missing[i]->fingerprint = fingerprints[i];
 }
 
 
@@ -249,7 +258,7 @@ void PeopleManipulator::recognizeFaces_thrd_recognize_people()
     const std::vector<Person::Fingerprint>& known_fingerprints = std::get<0>(people_fingerprints);
 
     for (FaceInfo& faceInfo: m_faces)
-        if (faceInfo.person.name().isEmpty())
+        if (faceInfo.person.name().isEmpty() && faceInfo.fingerprint.fingerprint().empty() == false)
         {
             const int pos = face_recognition.recognize(faceInfo.fingerprint.fingerprint(), known_fingerprints);
 
@@ -310,8 +319,9 @@ void PeopleManipulator::store_people_names()
 
 void PeopleManipulator::store_fingerprints()
 {
+    // faces without fingerprint (it could not be calculated) are stored without it
     for (auto& face: m_faces)
-        if (face.fingerprint.id().valid() == false)
+        if (face.fingerprint.id().valid() == false && face.fingerprint.fingerprint().empty() == false)
         {
             const PersonFingerprint::Id fid =
                 evaluate<PersonFingerprint::Id(Database::IBackend &)>(m_db, [fingerprint = face.fingerprint](Database::IBackend& backend)
@@ -337,6 +347,12 @@ void PeopleManipulator::store_people_information()
             backend.peopleInformationAccessor().store(faceInfo);
         });
     }
+
+    // faces on photo are known now, there is no need to analyze it in background
+    m_db.exec([id = m_pid](Database::IBackend& backend)
+    {
+        backend.set(id, Database::CommonGeneralFlags::FacesRecognized, 1);
+    });
 }
 
 
@@ -0,0 +1,70 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "duplicates_detection.hpp"
+
+#include <QDialogButtonBox>
+#include <QVBoxLayout>
+#include <QQuickWidget>
+
+#include <core/icore_factory_accessor.hpp>
+#include <database/idatabase.hpp>
+
+#include "quick_views/qml_utils.hpp"
+
+
+Q_DECLARE_METATYPE(DuplicatesCandidate)
+
+
+DuplicatesDetection::DuplicatesDetection(Database::IDatabase& db,
+                                         ICoreFactoryAccessor* core,
+                                         IThumbnailsManager* thbMgr,
+                                         Project& project):
+    QDialog(),
+    m_duplicatesModel(project, *core),
+    m_core(core),
+    m_db(db),
+    m_project(project),
+    m_qmlView(nullptr),
+    m_thumbnailsManager4QML(thbMgr)
+{
+    // dialog top layout setup
+    resize(320, 480);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    QDialogButtonBox* dialog_buttons = new QDialogButtonBox(QDialogButtonBox::Close);
+
+    m_qmlView = new QQuickWidget(this);
+    m_qmlView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_qmlView->setResizeMode(QQuickWidget::SizeRootObjectToView);
+    QmlUtils::registerObject(m_qmlView, "thumbnailsManager", &m_thumbnailsManager4QML);
+    QmlUtils::registerObject(m_qmlView, "groupsModelId", &m_duplicatesModel);
+    m_qmlView->setSource(QUrl("qrc:/ui/Dialogs/DuplicatesDetection.qml"));
+
+    layout->addWidget(m_qmlView);
+    layout->addWidget(dialog_buttons);
+
+    connect(dialog_buttons, &QDialogButtonBox::rejected, this, &QDialog::accept);
+}
+
+
+DuplicatesDetection::~DuplicatesDetection()
+{
+    // delete qml view before all other objects it referes to will be deleted
+    delete m_qmlView;
+}
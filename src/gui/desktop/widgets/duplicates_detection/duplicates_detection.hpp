@@ -0,0 +1,58 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2022  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DUPLICATESDETECTION_HPP
+#define DUPLICATESDETECTION_HPP
+
+#include <QDialog>
+#include <QQmlPropertyMap>
+
+#include <core/ithumbnails_manager.hpp>
+#include <database/photo_data.hpp>
+
+#include "quick_views/qml_setup.hpp"
+#include "models/duplicates_model.hpp"
+
+
+namespace Database
+{
+    struct IDatabase;
+}
+
+class Project;
+struct ICoreFactoryAccessor;
+struct IThumbnailsManager;
+
+class DuplicatesDetection: public QDialog
+{
+        Q_OBJECT
+
+    public:
+        DuplicatesDetection(Database::IDatabase &, ICoreFactoryAccessor *, IThumbnailsManager *, Project &);
+        ~DuplicatesDetection();
+
+    private:
+        DuplicatesModel m_duplicatesModel;
+        ICoreFactoryAccessor* m_core;
+        Database::IDatabase& m_db;
+        Project& m_project;
+        QQuickWidget* m_qmlView;
+        QML_IThumbnailsManager m_thumbnailsManager4QML;
+};
+
+#endif // DUPLICATESDETECTION_HPP
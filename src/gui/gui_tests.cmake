@@ -11,6 +11,8 @@ addTestTarget(gui
                 SOURCES
                     desktop/models/aphoto_info_model.cpp
                     desktop/models/flat_model.cpp
+                    desktop/utils/faces_analyzer.cpp
+                    desktop/utils/grouppers/image_stack.cpp
                     desktop/utils/model_index_utils.cpp
                     desktop/quick_views/selection_manager_component.cpp
 
@@ -26,6 +28,8 @@ addTestTarget(gui
                     unit_tests/test_helpers/internal_task_executor.hpp
 
                     # utils:
+                    unit_tests/utils/faces_analyzer_tests.cpp
+                    unit_tests/utils/image_stack_tests.cpp
                     unit_tests/utils/model_index_utils_tests.cpp
                     unit_tests/utils/selection_manager_component_tests.cpp
 
@@ -36,6 +40,7 @@ addTestTarget(gui
                     core
                     database
                     database_memory_backend
+                    face_recognition
                     photos_crawler
                     sample_dbs
                     Qt::Core
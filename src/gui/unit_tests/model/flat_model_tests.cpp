@@ -535,6 +535,66 @@ TEST_F(FlatModelTest, PhotosReorder)
 }
 
 
+TEST_F(FlatModelTest, minimalChangesForMovedPhoto)
+{
+    std::vector<Photo::Id> initial_photos_set;
+    for (int i = 1; i <= 100; i++)
+        initial_photos_set.emplace_back(i);
+
+    // first photo moved to the end (its date was changed for example)
+    std::vector<Photo::Id> final_photos_set(initial_photos_set.begin() + 1, initial_photos_set.end());
+    final_photos_set.push_back(initial_photos_set.front());
+
+    EXPECT_CALL(photoOperator, onPhotos(_, _))
+        .WillOnce(Return(initial_photos_set))
+        .WillOnce(Return(final_photos_set));
+
+    model.setDatabase(&db);
+
+    QSignalSpy model_inserted(&model, &FlatModel::rowsInserted);
+    QSignalSpy model_removed(&model, &FlatModel::rowsRemoved);
+
+    model.setFilter({});
+
+    ASSERT_EQ(model_removed.count(), 1);
+    ASSERT_EQ(model_inserted.count(), 1);
+    EXPECT_EQ(model_removed.at(0).at(1).toInt(), 0);
+    EXPECT_EQ(model_removed.at(0).at(2).toInt(), 0);
+    EXPECT_EQ(model_inserted.at(0).at(1).toInt(), 99);
+    EXPECT_EQ(model_inserted.at(0).at(2).toInt(), 99);
+
+    EXPECT_EQ(final_photos_set, model.photos());
+}
+
+
+TEST_F(FlatModelTest, resetForManyScatteredChanges)
+{
+    std::vector<Photo::Id> initial_photos_set;
+    for (int i = 1; i <= 10000; i++)
+        initial_photos_set.emplace_back(i);
+
+    // every second photo disappears
+    std::vector<Photo::Id> final_photos_set;
+    for (int i = 1; i <= 10000; i += 2)
+        final_photos_set.emplace_back(i);
+
+    EXPECT_CALL(photoOperator, onPhotos(_, _))
+        .WillOnce(Return(initial_photos_set))
+        .WillOnce(Return(final_photos_set));
+
+    model.setDatabase(&db);
+
+    QSignalSpy model_reset(&model, &FlatModel::modelReset);
+    QSignalSpy model_removed(&model, &FlatModel::rowsRemoved);
+
+    model.setFilter({});
+
+    EXPECT_EQ(model_reset.count(), 1);
+    EXPECT_EQ(model_removed.count(), 0);
+    EXPECT_EQ(final_photos_set, model.photos());
+}
+
+
 TEST_F(FlatModelTest, DataChange)
 {
     const auto initial_photos_set = std::vector<Photo::Id>{ Photo::Id(1), Photo::Id(2), Photo::Id(3), Photo::Id(4) };
@@ -553,6 +613,41 @@ TEST_F(FlatModelTest, DataChange)
 }
 
 
+TEST_F(FlatModelTest, photosDataIsFetchedInPages)
+{
+    std::vector<Photo::Id> photos;
+    for (int i = 1; i <= 1000; i++)
+        photos.emplace_back(i);
+
+    ON_CALL(photoOperator, onPhotos(_, _))
+        .WillByDefault(Return(photos));
+
+    ON_CALL(backend, getPhotos(_))
+        .WillByDefault(Invoke([](const std::vector<Photo::Id>& ids)
+        {
+            std::vector<Photo::Data> datas;
+
+            for (const auto& id: ids)
+            {
+                Photo::Data data;
+                data.id = id;
+                datas.push_back(data);
+            }
+
+            return datas;
+        }));
+
+    model.setDatabase(&db);
+
+    // photos are fetched in pages of 64 rows, each page is expected to be fetched once
+    EXPECT_CALL(backend, getPhotos(_)).Times(16);
+    EXPECT_CALL(backend, getPhoto(_)).Times(0);
+
+    for (int r = 0; r < 1000; r++)
+        EXPECT_EQ(model.getPhotoData(model.index(r, 0, {})).id, photos[r]);
+}
+
+
 TEST_F(FlatModelTest, accessToPhotoPathByItemIndex)
 {
     NiceMock<MockDatabase> db;
@@ -0,0 +1,197 @@
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+#include <database/backends/memory_backend/memory_backend.hpp>
+#include <database/general_flags.hpp>
+#include <database/iphoto_operator.hpp>
+#include <desktop/utils/faces_analyzer.hpp>
+#include <unit_tests_utils/mock_core_factory_accessor.hpp>
+#include <unit_tests_utils/mock_database.hpp>
+#include <unit_tests_utils/mock_exif_reader.hpp>
+#include <unit_tests_utils/mock_exif_reader_factory.hpp>
+
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+
+namespace
+{
+    // collects tasks so test decides when (and on which thread) they are run
+    class QueuedTaskExecutor: public ITaskExecutor
+    {
+        public:
+            void add(std::unique_ptr<ITask>&& task) override
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+
+            void addLight(std::unique_ptr<ITask>&& task) override
+            {
+                add(std::move(task));
+            }
+
+            int heavyWorkers() const override
+            {
+                return 2;
+            }
+
+            std::size_t runAll()
+            {
+                std::size_t count = 0;
+
+                for(;;)
+                {
+                    std::unique_ptr<ITask> task;
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+
+                        if (m_tasks.empty())
+                            break;
+
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+
+                    task->perform();
+                    count++;
+                }
+
+                return count;
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::deque<std::unique_ptr<ITask>> m_tasks;
+    };
+}
+
+
+class FacesAnalyzerTest: public testing::Test
+{
+    public:
+        QueuedTaskExecutor executor;
+        Database::MemoryBackend backend;
+        NiceMock<MockDatabase> db;
+        NiceMock<MockExifReader> exifReader;
+        NiceMock<ExifReaderFactoryMock> exifReaderFactory;
+        NiceMock<ICoreFactoryAccessorMock> core;
+
+        FacesAnalyzerTest()
+        {
+            ON_CALL(core, getTaskExecutor).WillByDefault(ReturnRef(executor));
+            ON_CALL(core, getExifReaderFactory).WillByDefault(ReturnRef(exifReaderFactory));
+            ON_CALL(exifReaderFactory, get).WillByDefault(ReturnRef(exifReader));
+
+            ON_CALL(db, execute(_)).WillByDefault(Invoke([this](std::unique_ptr<Database::IDatabase::ITask>&& task)
+            {
+                task->run(backend);
+            }));
+
+            ON_CALL(db, backend).WillByDefault(ReturnRef(backend));
+        }
+
+        // photos' files do not exist, so analysis finds no faces
+        std::vector<Photo::Id> addPhotos(const std::vector<QString>& paths)
+        {
+            std::vector<Photo::DataDelta> photos;
+
+            for(const auto& path: paths)
+            {
+                Photo::DataDelta delta;
+                delta.insert<Photo::Field::Path>(path);
+                photos.push_back(delta);
+            }
+
+            backend.addPhotos(photos);
+
+            std::vector<Photo::Id> ids;
+            for(const auto& photo: photos)
+                ids.push_back(photo.getId());
+
+            return ids;
+        }
+
+        bool recognized(const Photo::Id& id)
+        {
+            return backend.get(id, Database::CommonGeneralFlags::FacesRecognized).value_or(0) == 1;
+        }
+};
+
+
+TEST_F(FacesAnalyzerTest, analysisResumesWithNotRecognizedPhotos)
+{
+    const auto ids = addPhotos({"/photos/done.jpg", "/photos/movie.avi", "/photos/marked.jpg", "/photos/new.jpg"});
+
+    // first photo was analyzed in previous session, faces on third one were marked by user
+    backend.set(ids[0], Database::CommonGeneralFlags::FacesRecognized, 1);
+    backend.peopleInformationAccessor().store(PersonInfo(Person::Id(), ids[2], PersonFingerprint::Id(), QRect(10, 10, 50, 50)));
+
+    FacesAnalyzer analyzer(core, db);
+
+    // only last photo requires analysis
+    EXPECT_EQ(executor.runAll(), 1);
+
+    for(const auto& id: ids)
+        EXPECT_TRUE(recognized(id));
+
+    // no faces were found, user's one is untouched
+    EXPECT_EQ(backend.peopleInformationAccessor().listPeople(ids).size(), 1);
+}
+
+
+TEST_F(FacesAnalyzerTest, newPhotosAreAnalyzed)
+{
+    FacesAnalyzer analyzer(core, db);
+
+    const auto ids = addPhotos({"/photos/1.jpg", "/photos/2.jpg"});
+
+    // one photo is analyzed at a time
+    EXPECT_EQ(executor.runAll(), 2);
+
+    analyzer.stop();
+
+    EXPECT_TRUE(recognized(ids[0]));
+    EXPECT_TRUE(recognized(ids[1]));
+}
+
+
+TEST_F(FacesAnalyzerTest, stopDuringAnalysis)
+{
+    const auto ids = addPhotos({"/photos/1.jpg", "/photos/2.jpg", "/photos/3.jpg"});
+
+    const std::thread::id testThread = std::this_thread::get_id();
+    std::promise<void> stopping;
+    std::once_flag stoppingFlag;
+
+    FacesAnalyzer analyzer(core, db);
+
+    // stop() passes a marker through database queue after it stops accepting new photos
+    ON_CALL(db, execute(_)).WillByDefault(Invoke([&](std::unique_ptr<Database::IDatabase::ITask>&& task)
+    {
+        task->run(backend);
+
+        if (std::this_thread::get_id() != testThread)
+            std::call_once(stoppingFlag, [&stopping]{ stopping.set_value(); });
+    }));
+
+    // stop() waits for analysis in progress
+    std::thread stopThread([&analyzer]{ analyzer.stop(); });
+    stopping.get_future().wait();
+
+    EXPECT_EQ(executor.runAll(), 1);
+    stopThread.join();
+
+    // result of started analysis is stored, remaining photos are left for next session
+    EXPECT_TRUE(recognized(ids[0]));
+    EXPECT_FALSE(recognized(ids[1]));
+    EXPECT_FALSE(recognized(ids[2]));
+}
@@ -0,0 +1,117 @@
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <gmock/gmock.h>
+
+#include <desktop/utils/grouppers/image_stack.hpp>
+#include <unit_tests_utils/fake_task_executor.hpp>
+
+
+namespace
+{
+    // grey level of 8x8 block containing point (x, y). Pseudo random, so there is only one way to align two photos
+    int blockValue(int x, int y)
+    {
+        std::uint32_t h = static_cast<std::uint32_t>(x / 8) * 73856093u ^ static_cast<std::uint32_t>(y / 8) * 19349663u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+
+        return static_cast<int>(h & 0xff);
+    }
+
+    // photo of a scene seen from a camera moved by (dx, dy)
+    QImage scene(int width, int height, int dx = 0, int dy = 0)
+    {
+        QImage image(width, height, QImage::Format_RGB32);
+
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+            {
+                const int v = blockValue(x - dx + 64, y - dy + 64);
+                image.setPixel(x, y, qRgb(v, 255 - v, (v * 3) & 0xff));
+            }
+
+        return image;
+    }
+}
+
+
+TEST(ImageStackTest, alignmentOfSinglePhoto)
+{
+    FakeTaskExecutor executor;
+
+    const auto offsets = ImageStack::alignTranslations(executor, {scene(64, 64)});
+
+    ASSERT_EQ(offsets.size(), 1);
+    EXPECT_EQ(offsets[0], QPoint(0, 0));
+}
+
+
+TEST(ImageStackTest, alignmentRecoversShift)
+{
+    FakeTaskExecutor executor;
+
+    const std::vector<QImage> photos = { scene(512, 384), scene(512, 384, 5, -3), scene(512, 384, -12, 9) };
+    const auto offsets = ImageStack::alignTranslations(executor, photos);
+
+    ASSERT_EQ(offsets.size(), 3);
+    EXPECT_EQ(offsets[0], QPoint(0, 0));
+    EXPECT_EQ(offsets[1], QPoint(5, -3));
+    EXPECT_EQ(offsets[2], QPoint(-12, 9));
+}
+
+
+TEST(ImageStackTest, cropToCommonArea)
+{
+    const std::vector<QImage> photos = { scene(100, 80), scene(100, 80, 5, -3) };
+    const std::vector<QPoint> offsets = { QPoint(0, 0), QPoint(5, -3) };
+
+    const auto cropped = ImageStack::cropToCommonArea(photos, offsets);
+
+    ASSERT_EQ(cropped.size(), 2);
+
+    for (const QImage& image: cropped)
+    {
+        EXPECT_EQ(image.width(), 95);
+        EXPECT_EQ(image.height(), 77);
+    }
+
+    // both photos show the same part of scene now
+    for (int y = 0; y < 77; y++)
+        for (int x = 0; x < 95; x++)
+            ASSERT_EQ(cropped[0].pixel(x, y), cropped[1].pixel(x, y)) << "at " << x << ", " << y;
+}
+
+
+TEST(ImageStackTest, noCommonArea)
+{
+    const std::vector<QImage> photos = { scene(20, 20), scene(20, 20) };
+    const std::vector<QPoint> offsets = { QPoint(0, 0), QPoint(25, 0) };
+
+    EXPECT_TRUE(ImageStack::cropToCommonArea(photos, offsets).empty());
+}
+
+
+TEST(ImageStackTest, fusionOfIdenticalPhotos)
+{
+    FakeTaskExecutor executor;
+
+    const QImage photo = scene(120, 90);
+    const QImage fused = ImageStack::fuseExposures(executor, {photo, photo, photo});
+
+    ASSERT_EQ(fused.width(), photo.width());
+    ASSERT_EQ(fused.height(), photo.height());
+
+    for (int y = 0; y < photo.height(); y++)
+        for (int x = 0; x < photo.width(); x++)
+        {
+            const QRgb expected = photo.pixel(x, y);
+            const QRgb actual = fused.pixel(x, y);
+
+            ASSERT_LE(std::abs(qRed(expected) - qRed(actual)), 1) << "at " << x << ", " << y;
+            ASSERT_LE(std::abs(qGreen(expected) - qGreen(actual)), 1) << "at " << x << ", " << y;
+            ASSERT_LE(std::abs(qBlue(expected) - qBlue(actual)), 1) << "at " << x << ", " << y;
+        }
+}
@@ -7,6 +7,7 @@
 class EmptyLogger: public ILogger
 {
     public:
+        bool isEnabled(Severity) const override { return false; }
         void log(Severity, const QString &) override {}
 
         void info(const QString &) override {}
@@ -10,6 +10,7 @@
 #include <database/igroup_operator.hpp>
 #include <database/iphoto_change_log_operator.hpp>
 #include <database/iphoto_operator.hpp>
+#include <database/iseries_cache_operator.hpp>
 #include <database/project_info.hpp>
 
 
@@ -23,12 +24,15 @@ struct MockBackend: public Database::IBackend
   MOCK_METHOD(bool, update, (const std::vector<Photo::DataDelta> &), (override));
 
   MOCK_METHOD(std::vector<TagValue>, listTagValues, (const TagTypes &, const Database::Filter &), (override));
+  MOCK_METHOD((std::vector<std::pair<TagValue, int>>), countTagValues, (const TagTypes &), (override));
   MOCK_METHOD0(getAllPhotos,
       std::vector<Photo::Id>());
   MOCK_METHOD1(getPhoto,
       Photo::Data(const Photo::Id &));
   MOCK_METHOD(Photo::DataDelta, getPhotoDelta, (const Photo::Id &, const std::set<Photo::Field> &), (override));
+  MOCK_METHOD(std::vector<Photo::Data>, getPhotos, (const std::vector<Photo::Id> &), (override));
   MOCK_METHOD(int, getPhotosCount, (const Database::Filter &), (override));
+  MOCK_METHOD(Database::DateHistogram, getDateHistogram, (const Database::Filter &, Database::DateHistogram::Granularity), (override));
   MOCK_METHOD0(listPeople,
       std::vector<PersonName>());
   MOCK_METHOD1(listPeople,
@@ -37,10 +41,12 @@ struct MockBackend: public Database::IBackend
       PersonName(const Person::Id &));
   MOCK_METHOD3(set,
       void(const Photo::Id &, const QString &, int value));
+  MOCK_METHOD(void, set, (const QString &, (const std::map<Photo::Id, int> &)), (override));
   MOCK_METHOD2(get,
       std::optional<int>(const Photo::Id &, const QString &));
   MOCK_METHOD0(markStagedAsReviewed,
       std::vector<Photo::Id>());
+  MOCK_METHOD(void, storeFaces, ((const std::map<Photo::Id, std::vector<std::pair<QRect, Person::Fingerprint>>> &)), (override));
   MOCK_METHOD1(init,
       Database::BackendStatus(const Database::ProjectInfo &));
   MOCK_METHOD0(closeConnections,
@@ -50,6 +56,7 @@ struct MockBackend: public Database::IBackend
   MOCK_METHOD(Database::IPhotoOperator&, photoOperator, (), (override));
   MOCK_METHOD(Database::IPhotoChangeLogOperator&, photoChangeLogOperator, (), (override));
   MOCK_METHOD(Database::IPeopleInformationAccessor&, peopleInformationAccessor, (), (override));
+  MOCK_METHOD(Database::ISeriesCacheOperator&, seriesCacheOperator, (), (override));
 };
 
 
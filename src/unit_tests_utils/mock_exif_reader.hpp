@@ -16,6 +16,7 @@ struct MockExifReader: IExifReader
     MOCK_METHOD1(hasExif, bool(const QString &));
     MOCK_METHOD1(getTagsFor, Tag::TagsList(const QString &));
     MOCK_METHOD2(get, std::optional<std::any>(const QString &, const TagType &));
+    MOCK_METHOD1(imageSize, std::optional<QSize>(const QString &));
 };
 
 #endif
@@ -10,6 +10,7 @@ class ExifReaderFactoryMock: public IExifReaderFactory
 {
     public:
         MOCK_METHOD(IExifReader&, get, (), (override));
+        MOCK_METHOD(ReaderLease, checkout, (), (override));
 };
 
 #endif
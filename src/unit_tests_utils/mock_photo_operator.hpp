@@ -12,4 +12,5 @@ class PhotoOperatorMock: public Database::IPhotoOperator
         MOCK_METHOD(bool, removePhotos, (const Database::Filter &), (override));
         MOCK_METHOD(std::vector<Photo::Id>, onPhotos, (const Database::Filter &, const Database::Action &), (override));
         MOCK_METHOD(std::vector<Photo::Id>, getPhotos, (const Database::Filter &), (override));
+        MOCK_METHOD(std::vector<std::vector<Photo::Id>>, findDuplicates, (const Database::Filter &), (override));
 };
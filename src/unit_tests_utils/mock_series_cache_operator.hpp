@@ -0,0 +1,14 @@
+#include <gmock/gmock.h>
+
+#include <database/iseries_cache_operator.hpp>
+
+
+class SeriesCacheOperatorMock: public Database::ISeriesCacheOperator
+{
+    public:
+        MOCK_METHOD(std::vector<Database::SeriesFeatures>, listFeatures, (), (override));
+        MOCK_METHOD(bool, store, (const std::vector<Database::SeriesFeatures> &), (override));
+        MOCK_METHOD(bool, dropFeatures, (const std::vector<Photo::Id> &), (override));
+        MOCK_METHOD(std::vector<Database::SeriesWindow>, listWindows, (), (override));
+        MOCK_METHOD(bool, replaceWindows, (const std::vector<int> &, const std::vector<Database::SeriesWindow> &), (override));
+};